@@ -0,0 +1,83 @@
+#ifndef MODBUS_CRC_H
+#define MODBUS_CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Modbus RTU CRC-16 (reflected polynomial 0xA001, initial value 0xFFFF, sent low byte first),
+// shared by the RTU master, the RTU slave and the Modbus TCP gateway.
+//
+// Three implementations give the same result:
+//   MODBUS_CRC_BITWISE  8 shift/xor steps per byte, no table
+//   MODBUS_CRC_NIBBLE   2 lookups per byte in a 16 entry table (32 bytes)
+//   MODBUS_CRC_TABLE    1 lookup per byte in a 256 entry table (512 bytes)
+// modbusCRC() and modbusCRCUpdate() use MODBUS_CRC_IMPL, which defaults to the nibble table on
+// AVR and the full table elsewhere. Override it with a build flag, e.g. -DMODBUS_CRC_IMPL=0.
+//
+// The incremental API lets a receiver fold bytes into the CRC as they come off the UART:
+//   uint16_t crc = MODBUS_CRC_INIT;
+//   crc = modbusCRCUpdate(crc, byte);   // for every byte of the frame, CRC bytes included
+//   bool valid = (crc == 0);            // a frame followed by its own CRC leaves a residue of 0
+
+#define MODBUS_CRC_BITWISE 0
+#define MODBUS_CRC_NIBBLE 1
+#define MODBUS_CRC_TABLE 2
+
+#ifndef MODBUS_CRC_IMPL
+  #if defined(__AVR__)
+    #define MODBUS_CRC_IMPL MODBUS_CRC_NIBBLE
+  #else
+    #define MODBUS_CRC_IMPL MODBUS_CRC_TABLE
+  #endif
+#endif
+
+#define MODBUS_CRC_INIT 0xFFFF
+
+// On the RP2040 the table is left writable so it is copied to SRAM at boot instead of being read
+// through the XIP flash cache, which would make the CRC time depend on cache state.
+#if defined(ARDUINO_ARCH_RP2040)
+  #define MODBUS_CRC_TABLE_CONST
+#else
+  #define MODBUS_CRC_TABLE_CONST const
+#endif
+
+extern MODBUS_CRC_TABLE_CONST uint16_t modbusCRCLookup256[256];
+extern const uint16_t modbusCRCLookup16[16];
+
+// Explicit implementations, all continue from crc over length bytes
+uint16_t modbusCRCBitwise(uint16_t crc, const uint8_t *data, size_t length);
+uint16_t modbusCRCNibble(uint16_t crc, const uint8_t *data, size_t length);
+uint16_t modbusCRCTable(uint16_t crc, const uint8_t *data, size_t length);
+
+// Fold one byte into a running CRC
+static inline uint16_t modbusCRCUpdate(uint16_t crc, uint8_t value) {
+#if MODBUS_CRC_IMPL == MODBUS_CRC_TABLE
+    return (crc >> 8) ^ modbusCRCLookup256[(uint8_t)(crc ^ value)];
+#elif MODBUS_CRC_IMPL == MODBUS_CRC_NIBBLE
+    crc ^= value;
+    crc = (crc >> 4) ^ modbusCRCLookup16[crc & 0x0F];
+    return (crc >> 4) ^ modbusCRCLookup16[crc & 0x0F];
+#else
+    crc ^= value;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    return crc;
+#endif
+}
+
+// Fold a block of bytes into a running CRC
+static inline uint16_t modbusCRCUpdate(uint16_t crc, const uint8_t *data, size_t length) {
+#if MODBUS_CRC_IMPL == MODBUS_CRC_TABLE
+    return modbusCRCTable(crc, data, length);
+#elif MODBUS_CRC_IMPL == MODBUS_CRC_NIBBLE
+    return modbusCRCNibble(crc, data, length);
+#else
+    return modbusCRCBitwise(crc, data, length);
+#endif
+}
+
+// CRC of a complete buffer
+static inline uint16_t modbusCRC(const uint8_t *data, size_t length) {
+    return modbusCRCUpdate((uint16_t)MODBUS_CRC_INIT, data, length);
+}
+
+#endif
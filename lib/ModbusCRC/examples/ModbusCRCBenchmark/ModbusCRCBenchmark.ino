@@ -0,0 +1,82 @@
+/*
+  ModbusCRCBenchmark
+
+  Times the three CRC implementations on the target and prints, for each one, the CPU cycles per
+  byte and the share of a character time on the RS485 bus it costs. Run it on the controller
+  (RP2040) and on a thermocouple interface (AVR64DD32) to pick MODBUS_CRC_IMPL for each.
+
+  The three implementations are also checked against each other and against a known frame
+  (01 03 00 00 00 0A -> CRC 0xCDC5).
+*/
+
+#include <ModbusCRC.h>
+
+const uint32_t busBaud = 500000;
+const uint32_t bitsPerChar = 10;
+const uint16_t frameLength = 256;
+const uint16_t iterations = 200;
+
+typedef uint16_t (*crcFunction)(uint16_t crc, const uint8_t *data, size_t length);
+
+struct crcVariant {
+  const char *name;
+  crcFunction function;
+};
+
+const crcVariant variants[] = {
+  {"bitwise", modbusCRCBitwise},
+  {"nibble", modbusCRCNibble},
+  {"table", modbusCRCTable},
+};
+
+uint8_t frame[frameLength];
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  delay(1000);
+
+  for (uint16_t i = 0; i < frameLength; i++) frame[i] = (uint8_t)(i * 37 + 11);
+
+  const uint8_t reference[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+  for (const crcVariant &variant : variants) {
+    uint16_t crc = variant.function(MODBUS_CRC_INIT, reference, sizeof(reference));
+    if (crc != 0xCDC5 || variant.function(MODBUS_CRC_INIT, frame, frameLength) != modbusCRC(frame, frameLength)) {
+      Serial.print("CRC mismatch in ");
+      Serial.println(variant.name);
+    }
+  }
+
+  float cyclesPerChar = (float)F_CPU * bitsPerChar / busBaud;
+  Serial.print("F_CPU ");
+  Serial.print(F_CPU);
+  Serial.print(" Hz, ");
+  Serial.print(cyclesPerChar, 0);
+  Serial.print(" cycles per character at ");
+  Serial.print(busBaud);
+  Serial.println(" baud");
+  Serial.print("Default implementation: ");
+  Serial.println(variants[MODBUS_CRC_IMPL].name);
+}
+
+void loop() {
+  float cyclesPerChar = (float)F_CPU * bitsPerChar / busBaud;
+  for (const crcVariant &variant : variants) {
+    volatile uint16_t sink = 0;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < iterations; i++) sink ^= variant.function(MODBUS_CRC_INIT, frame, frameLength);
+    uint32_t elapsed = micros() - start;
+
+    float cyclesPerByte = (float)elapsed * (F_CPU / 1000000.0f) / ((float)iterations * frameLength);
+    Serial.print(variant.name);
+    Serial.print(": ");
+    Serial.print(cyclesPerByte, 1);
+    Serial.print(" cycles/byte, ");
+    Serial.print((float)elapsed / iterations, 1);
+    Serial.print(" us per 256 byte frame, ");
+    Serial.print(100.0f * cyclesPerByte / cyclesPerChar, 2);
+    Serial.println("% of a character time");
+  }
+  Serial.println();
+  delay(5000);
+}
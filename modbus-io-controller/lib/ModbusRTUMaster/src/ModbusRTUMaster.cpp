@@ -1,6 +1,6 @@
 #include "ModbusRTUMaster.h"
 
-ModbusRTUMaster::ModbusRTUMaster(HardwareSerial& serial, uint8_t dePin) {
+ModbusRTUMaster::ModbusRTUMaster(HardwareSerial& serial, uint8_t dePin) : _streamTransport(serial, dePin) {
   _hardwareSerial = &serial;
   #ifdef __AVR__
   _softwareSerial = 0;
@@ -8,34 +8,42 @@ ModbusRTUMaster::ModbusRTUMaster(HardwareSerial& serial, uint8_t dePin) {
   #ifdef HAVE_CDCSERIAL
   _usbSerial = 0;
   #endif
-  _serial = &serial;
-  _dePin = dePin;
+  _transport = &_streamTransport;
 }
 
 #ifdef __AVR__
-ModbusRTUMaster::ModbusRTUMaster(SoftwareSerial& serial, uint8_t dePin) {
+ModbusRTUMaster::ModbusRTUMaster(SoftwareSerial& serial, uint8_t dePin) : _streamTransport(serial, dePin) {
   _hardwareSerial = 0;
   _softwareSerial = &serial;
   #ifdef HAVE_CDCSERIAL
   _usbSerial = 0;
   #endif
-  _serial = &serial;
-  _dePin = dePin;
+  _transport = &_streamTransport;
 }
 #endif
 
 #ifdef HAVE_CDCSERIAL
-ModbusRTUMaster::ModbusRTUMaster(Serial_& serial, uint8_t dePin) {
+ModbusRTUMaster::ModbusRTUMaster(Serial_& serial, uint8_t dePin) : _streamTransport(serial, dePin) {
   _hardwareSerial = 0;
   #ifdef __AVR__
   _softwareSerial = 0;
   #endif
   _usbSerial = &serial;
-  _serial = &serial;
-  _dePin = dePin;
+  _transport = &_streamTransport;
 }
 #endif
 
+ModbusRTUMaster::ModbusRTUMaster(ModbusRTUTransport& transport) {
+  _hardwareSerial = 0;
+  #ifdef __AVR__
+  _softwareSerial = 0;
+  #endif
+  #ifdef HAVE_CDCSERIAL
+  _usbSerial = 0;
+  #endif
+  _transport = &transport;
+}
+
 void ModbusRTUMaster::setTimeout(uint32_t timeout) {
   _responseTimeout = timeout;
 }
@@ -53,10 +61,10 @@ void ModbusRTUMaster::begin(unsigned long baud, uint32_t config, int8_t rxPin, i
     while (!_usbSerial);
   }
   #endif
-  if (_dePin != NO_DE_PIN) {
-    pinMode(_dePin, OUTPUT);
-    digitalWrite(_dePin, LOW);
+  else {
+    _calculateTimeouts(baud, config);
   }
+  _transport->begin(baud, config);
   _clearRxBuffer();
 }
 #else
@@ -79,169 +87,181 @@ void ModbusRTUMaster::begin(unsigned long baud, uint32_t config) {
     while (!_usbSerial);
   }
   #endif
-  if (_dePin != NO_DE_PIN) {
-    pinMode(_dePin, OUTPUT);
-    digitalWrite(_dePin, LOW);
+  else {
+    _calculateTimeouts(baud, config);
   }
+  _transport->begin(baud, config);
   _clearRxBuffer();
 }
 #endif
 
 
 bool ModbusRTUMaster::readCoils(uint8_t id, uint16_t startAddress, bool *buf, uint16_t quantity) {
-  const uint8_t functionCode = 1;
-  uint8_t byteCount = _div8RndUp(quantity);
-  if (id < 1 || id > 247 || !buf || quantity == 0 || quantity > 2000) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _writeRequest(6);
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return false;
-  for (uint16_t i = 0; i < quantity; i++) {
-    buf[i] = bitRead(_buf[3 + (i >> 3)], i & 7);
-  }
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 1;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.coils = buf;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::readDiscreteInputs(uint8_t id, uint16_t startAddress, bool *buf, uint16_t quantity) {
-  const uint8_t functionCode = 2;
-  uint8_t byteCount = _div8RndUp(quantity);
-  if (id < 1 || id > 247 || !buf || quantity == 0 || quantity > 2000) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _writeRequest(6);
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return false;
-  for (uint16_t i = 0; i < quantity; i++) {
-    buf[i] = bitRead(_buf[3 + (i >> 3)], i & 7);
-  }
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 2;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.coils = buf;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::readHoldingRegisters(uint8_t id, uint16_t startAddress, uint16_t *buf, uint16_t quantity) {
-  const uint8_t functionCode = 3;
-  uint8_t byteCount = quantity * 2;
-  if (id < 1 || id > 247 || !buf || quantity == 0 || quantity > 125) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _writeRequest(6);
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return false;
-  for (uint16_t i = 0; i < quantity; i++) {
-    buf[i] = _bytesToWord(_buf[3 + (i * 2)], _buf[4 + (i * 2)]);
-  }
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 3;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.registers = buf;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::readInputRegisters(uint8_t id, uint16_t startAddress, uint16_t *buf, uint16_t quantity) {
-  const uint8_t functionCode = 4;
-  uint8_t byteCount = quantity * 2;
-  if (id < 1 || id > 247 || !buf || quantity == 0 || quantity > 125) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _writeRequest(6);
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return false;
-  for (uint16_t i = 0; i < quantity; i++) {
-    buf[i] = _bytesToWord(_buf[3 + (i * 2)], _buf[4 + (i * 2)]);
-  }
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 4;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.registers = buf;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::writeSingleCoil(uint8_t id, uint16_t address, bool value) {
-  const uint8_t functionCode = 5;
-  if (id > 247) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(address);
-  _buf[3] = lowByte(address);
-  _buf[4] = value * 255;
-  _buf[5] = 0;
-  _writeRequest(6);
-  if (id == 0) return true;
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != address || _buf[4] != (value * 255) || _buf[5] != 0) return false;
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 5;
+  transaction.address = address;
+  transaction.value = value;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::writeSingleHoldingRegister(uint8_t id, uint16_t address, uint16_t value) {
-  const uint8_t functionCode = 6;
-  if (id > 247) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(address);
-  _buf[3] = lowByte(address);
-  _buf[4] = highByte(value);
-  _buf[5] = lowByte(value);
-  _writeRequest(6);
-  if (id == 0) return true;
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != address || _bytesToWord(_buf[4], _buf[5]) != value) return false;
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 6;
+  transaction.address = address;
+  transaction.value = value;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::writeMultipleCoils(uint8_t id, uint16_t startAddress, bool *buf, uint16_t quantity) {
-  const uint8_t functionCode = 15;
-  uint8_t byteCount = _div8RndUp(quantity);
-  if (id > 247 || !buf || quantity == 0 || quantity > 1968) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _buf[6] = byteCount;
-  for (uint16_t i = 0; i < quantity; i++) {
-    bitWrite(_buf[7 + (i >> 3)], i & 7, buf[i]);
-  }
-  for (uint16_t i = quantity; i < (byteCount * 8); i++) {
-    bitClear(_buf[7 + (i >> 3)], i & 7);
-  }
-  _writeRequest(7 + byteCount);
-  if (id == 0) return true;
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != startAddress || _bytesToWord(_buf[4], _buf[5]) != quantity) return false;
-  return true;
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 15;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.coils = buf;
+  return _transact(transaction);
 }
 
 bool ModbusRTUMaster::writeMultipleHoldingRegisters(uint8_t id, uint16_t startAddress, uint16_t *buf, uint16_t quantity) {
-  const uint8_t functionCode = 16;
-  uint8_t byteCount = quantity * 2;
-  if (id > 247 || !buf || quantity == 0 || quantity > 123) return false;
-  _buf[0] = id;
-  _buf[1] = functionCode;
-  _buf[2] = highByte(startAddress);
-  _buf[3] = lowByte(startAddress);
-  _buf[4] = highByte(quantity);
-  _buf[5] = lowByte(quantity);
-  _buf[6] = byteCount;
-  for (uint16_t i = 0; i < quantity; i++) {
-    _buf[7 + (i * 2)] = highByte(buf[i]);
-    _buf[8 + (i * 2)] = lowByte(buf[i]);
+  ModbusRTUMasterTransaction transaction;
+  transaction.id = id;
+  transaction.functionCode = 16;
+  transaction.address = startAddress;
+  transaction.quantity = quantity;
+  transaction.registers = buf;
+  return _transact(transaction);
+}
+
+
+
+bool ModbusRTUMaster::submit(ModbusRTUMasterTransaction *transaction) {
+  if (!transaction || _state != _STATE_IDLE || !_lineIdle()) return false;
+  uint8_t len;
+  if (!_buildRequest(*transaction, len)) {
+    transaction->status = MODBUS_RTU_MASTER_INVALID_REQUEST;
+    return false;
   }
-  _writeRequest(7 + byteCount);
-  if (id == 0) return true;
-  uint16_t responseLength = _readResponse(id, functionCode);
-  if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != startAddress || _bytesToWord(_buf[4], _buf[5]) != quantity) return false;
+  _transport->discard();
+  if (!_writeRequest(len)) return false;
+  transaction->exceptionCode = 0;
+  transaction->responseTime = 0;
+  transaction->status = MODBUS_RTU_MASTER_PENDING;
+  _numBytes = 0;
+  _transaction = transaction;
+  _state = _STATE_SENDING;
+  poll();
   return true;
 }
 
+void ModbusRTUMaster::poll() {
+  switch (_state) {
+    case _STATE_IDLE:
+      return;
+
+    case _STATE_SENDING:
+      // The response timeout runs from the end of the request, not from when it was queued
+      if (_transport->sending()) return;
+      if (_transaction->id == 0) {
+        // Broadcast requests are never answered
+        _complete(MODBUS_RTU_MASTER_SUCCESS);
+        return;
+      }
+      _requestTime = micros();
+      _timeout = _transaction->timeout ? _transaction->timeout : _responseTimeout * 1000;
+      _state = _STATE_WAIT_RESPONSE;
+      // fall through
+
+    case _STATE_WAIT_RESPONSE:
+      if (!_transport->available()) {
+        if (micros() - _requestTime >= _timeout) _complete(MODBUS_RTU_MASTER_TIMEOUT);
+        return;
+      }
+      _numBytes = 0;
+      _expectedBytes = 0;
+      _crc = MODBUS_CRC_INIT;
+      _state = _STATE_RECEIVING;
+      // fall through
+
+    case _STATE_RECEIVING:
+      // The CRC is folded in as bytes arrive. Once the header gives the response length, a frame
+      // of that length with a valid CRC completes without waiting out the inter-frame silence.
+      while (_transport->available()) {
+        if (_numBytes >= MODBUS_RTU_MASTER_BUF_SIZE) {
+          _transport->discard();
+          break;
+        }
+        uint16_t count = _transport->read(_buf + _numBytes, MODBUS_RTU_MASTER_BUF_SIZE - _numBytes);
+        while (count--) {
+          _crc = modbusCRCUpdate(_crc, _buf[_numBytes++]);
+          if (!_expectedBytes) _expectedBytes = _expectedLength();
+          if (_numBytes == _expectedBytes && _crc == 0) {
+            _complete(_processResponse(*_transaction));
+            return;
+          }
+        }
+      }
+      if (micros() - _transport->lastRxMicros() <= _charTimeout) return;
+      _state = _STATE_FRAME_GAP;
+      // fall through
+
+    case _STATE_FRAME_GAP:
+      // Anything arriving inside the inter-frame silence belongs to a corrupt frame
+      if (_transport->available()) {
+        _complete(MODBUS_RTU_MASTER_FRAME_ERROR);
+        return;
+      }
+      if (micros() - _transport->lastRxMicros() < _frameTimeout) return;
+      _complete(_processResponse(*_transaction));
+      return;
+  }
+}
+
+bool ModbusRTUMaster::isBusy() {
+  return _state != _STATE_IDLE;
+}
+
 bool ModbusRTUMaster::getTimeoutFlag() {
   return _timeoutFlag;
 }
@@ -260,47 +280,194 @@ void ModbusRTUMaster::clearExceptionResponse() {
 
 
 
-void ModbusRTUMaster::_writeRequest(uint8_t len) {
-  uint16_t crc = _crc(len);
+bool ModbusRTUMaster::_transact(ModbusRTUMasterTransaction& transaction) {
+  // Let any in-flight asynchronous transaction finish before taking the bus
+  while (_state != _STATE_IDLE || !_lineIdle()) poll();
+  if (!submit(&transaction)) return false;
+  while (transaction.status == MODBUS_RTU_MASTER_PENDING) poll();
+  return transaction.status == MODBUS_RTU_MASTER_SUCCESS;
+}
+
+bool ModbusRTUMaster::_buildRequest(ModbusRTUMasterTransaction& transaction, uint8_t& len) {
+  uint8_t id = transaction.id;
+  uint16_t quantity = transaction.quantity;
+  uint8_t byteCount;
+  _buf[0] = id;
+  _buf[1] = transaction.functionCode;
+  _buf[2] = highByte(transaction.address);
+  _buf[3] = lowByte(transaction.address);
+  switch (transaction.functionCode) {
+    case 1:
+    case 2:
+      if (id < 1 || id > 247 || !transaction.coils || quantity == 0 || quantity > 2000) return false;
+      _buf[4] = highByte(quantity);
+      _buf[5] = lowByte(quantity);
+      len = 6;
+      return true;
+
+    case 3:
+    case 4:
+      if (id < 1 || id > 247 || !transaction.registers || quantity == 0 || quantity > 125) return false;
+      _buf[4] = highByte(quantity);
+      _buf[5] = lowByte(quantity);
+      len = 6;
+      return true;
+
+    case 5:
+      if (id > 247) return false;
+      _buf[4] = transaction.value ? 255 : 0;
+      _buf[5] = 0;
+      len = 6;
+      return true;
+
+    case 6:
+      if (id > 247) return false;
+      _buf[4] = highByte(transaction.value);
+      _buf[5] = lowByte(transaction.value);
+      len = 6;
+      return true;
+
+    case 15:
+      if (id > 247 || !transaction.coils || quantity == 0 || quantity > 1968) return false;
+      byteCount = _div8RndUp(quantity);
+      _buf[4] = highByte(quantity);
+      _buf[5] = lowByte(quantity);
+      _buf[6] = byteCount;
+      for (uint16_t i = 0; i < quantity; i++) {
+        bitWrite(_buf[7 + (i >> 3)], i & 7, transaction.coils[i]);
+      }
+      for (uint16_t i = quantity; i < (byteCount * 8); i++) {
+        bitClear(_buf[7 + (i >> 3)], i & 7);
+      }
+      len = 7 + byteCount;
+      return true;
+
+    case 16:
+      if (id > 247 || !transaction.registers || quantity == 0 || quantity > 123) return false;
+      byteCount = quantity * 2;
+      _buf[4] = highByte(quantity);
+      _buf[5] = lowByte(quantity);
+      _buf[6] = byteCount;
+      for (uint16_t i = 0; i < quantity; i++) {
+        _buf[7 + (i * 2)] = highByte(transaction.registers[i]);
+        _buf[8 + (i * 2)] = lowByte(transaction.registers[i]);
+      }
+      len = 7 + byteCount;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool ModbusRTUMaster::_writeRequest(uint8_t len) {
+  uint16_t crc = modbusCRC(_buf, len);
   _buf[len] = lowByte(crc);
   _buf[len + 1] = highByte(crc);
-  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, HIGH);
-  _serial->write(_buf, len + 2);
-  _serial->flush();
-  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, LOW);
-}
-
-uint16_t ModbusRTUMaster::_readResponse(uint8_t id, uint8_t functionCode) {
-  uint32_t startTime = millis();
-  uint16_t numBytes = 0;
-  while (!_serial->available()) {
-    if (millis() - startTime >= _responseTimeout) {
-      _timeoutFlag = true;
+  return _transport->send(_buf, len + 2);
+}
+
+ModbusRTUMasterStatus ModbusRTUMaster::_processResponse(ModbusRTUMasterTransaction& transaction) {
+  uint8_t functionCode = transaction.functionCode;
+  if (_numBytes < 5 || _numBytes > MODBUS_RTU_MASTER_BUF_SIZE - 1) return MODBUS_RTU_MASTER_FRAME_ERROR;
+  // A frame followed by its own CRC leaves a CRC residue of 0
+  if (_buf[0] != transaction.id || (_buf[1] != functionCode && _buf[1] != (functionCode + 128)) || _crc != 0) return MODBUS_RTU_MASTER_FRAME_ERROR;
+  if (_buf[1] == (functionCode + 128)) {
+    _exceptionResponse = _buf[2];
+    transaction.exceptionCode = _buf[2];
+    return MODBUS_RTU_MASTER_EXCEPTION;
+  }
+  uint16_t responseLength = _numBytes - 2;
+  uint16_t quantity = transaction.quantity;
+  uint8_t byteCount;
+  switch (functionCode) {
+    case 1:
+    case 2:
+      byteCount = _div8RndUp(quantity);
+      if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return MODBUS_RTU_MASTER_FRAME_ERROR;
+      for (uint16_t i = 0; i < quantity; i++) {
+        transaction.coils[i] = bitRead(_buf[3 + (i >> 3)], i & 7);
+      }
+      break;
+
+    case 3:
+    case 4:
+      byteCount = quantity * 2;
+      if (responseLength != (uint16_t)(3 + byteCount) || _buf[2] != byteCount) return MODBUS_RTU_MASTER_FRAME_ERROR;
+      for (uint16_t i = 0; i < quantity; i++) {
+        transaction.registers[i] = _bytesToWord(_buf[3 + (i * 2)], _buf[4 + (i * 2)]);
+      }
+      break;
+
+    case 5:
+      if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != transaction.address || _buf[4] != (transaction.value ? 255 : 0) || _buf[5] != 0) return MODBUS_RTU_MASTER_FRAME_ERROR;
+      break;
+
+    case 6:
+      if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != transaction.address || _bytesToWord(_buf[4], _buf[5]) != transaction.value) return MODBUS_RTU_MASTER_FRAME_ERROR;
+      break;
+
+    case 15:
+    case 16:
+      if (responseLength != 6 || _bytesToWord(_buf[2], _buf[3]) != transaction.address || _bytesToWord(_buf[4], _buf[5]) != quantity) return MODBUS_RTU_MASTER_FRAME_ERROR;
+      break;
+  }
+  return MODBUS_RTU_MASTER_SUCCESS;
+}
+
+// Length of the response being received, derived from its function code and byte count.
+// Returns 0 while not enough of the header has arrived or if the header doesn't match the request.
+uint16_t ModbusRTUMaster::_expectedLength() {
+  uint8_t functionCode = _transaction->functionCode;
+  if (_numBytes < 2) return 0;
+  if (_buf[1] == (functionCode | 0x80)) return 5;
+  if (_buf[1] != functionCode) return 0;
+  switch (functionCode) {
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+      if (_numBytes < 3) return 0;
+      return 5 + _buf[2];
+    case 5:
+    case 6:
+    case 15:
+    case 16:
+      return 8;
+    default:
       return 0;
-    }
   }
-  do {
-    if (_serial->available()) {
-      startTime = micros();
-      _buf[numBytes] = _serial->read();
-      numBytes++;
-    }
-  } while (micros() - startTime <= _charTimeout && numBytes < MODBUS_RTU_MASTER_BUF_SIZE);
-  while (micros() - startTime < _frameTimeout);
-  if (_serial->available() || _buf[0] != id || (_buf[1] != functionCode && _buf[1] != (functionCode + 128)) || _crc(numBytes - 2) != _bytesToWord(_buf[numBytes - 1], _buf[numBytes - 2])) return 0;
-  else if (_buf[1] == (functionCode + 128)) {
-    _exceptionResponse = _buf[2];
-    return 0;
+}
+
+void ModbusRTUMaster::_complete(ModbusRTUMasterStatus status) {
+  ModbusRTUMasterTransaction *transaction = _transaction;
+  _transaction = 0;
+  _state = _STATE_IDLE;
+  // A response completed on its last byte hasn't had its inter-frame silence yet. Without a
+  // response (broadcast, timeout) the line is treated as busy until now.
+  _lineIdleTime = _numBytes ? _transport->lastRxMicros() : micros();
+  if (status == MODBUS_RTU_MASTER_TIMEOUT) _timeoutFlag = true;
+  if ((status == MODBUS_RTU_MASTER_SUCCESS || status == MODBUS_RTU_MASTER_EXCEPTION) && transaction->id != 0) {
+    // Time to the start of the response, the frame's own time on the wire is taken off
+    uint32_t elapsed = _transport->lastRxMicros() - _requestTime;
+    uint32_t frameTime = (_numBytes - 1) * _charTime;
+    transaction->responseTime = elapsed > frameTime ? elapsed - frameTime : 1;
   }
-  return (numBytes - 2);
+  transaction->status = status;
+  if (transaction->callback) transaction->callback(*transaction);
+}
+
+// True once the line has been silent for t3.5 since the last frame, the next request may go out
+bool ModbusRTUMaster::_lineIdle() {
+  return micros() - _lineIdleTime >= _frameTimeout;
 }
 
 void ModbusRTUMaster::_clearRxBuffer() {
   unsigned long startTime = micros();
   do {
-    if (_serial->available() > 0) {
+    if (_transport->available() > 0) {
       startTime = micros();
-      _serial->read();
+      _transport->discard();
     }
   } while (micros() - startTime < _frameTimeout);
 }
@@ -312,6 +479,7 @@ void ModbusRTUMaster::_calculateTimeouts(unsigned long baud, uint32_t config) {
   if (config == SERIAL_8E2 || config == SERIAL_8O2) bitsPerChar = 12;
   else if (config == SERIAL_8N2 || config == SERIAL_8E1 || config == SERIAL_8O1) bitsPerChar = 11;
   else bitsPerChar = 10;
+  _charTime = (bitsPerChar * 1000000) / baud;
   if (baud <= 19200) {
     _charTimeout = (bitsPerChar * 2500000) / baud;
     _frameTimeout = (bitsPerChar * 4500000) / baud;
@@ -322,19 +490,6 @@ void ModbusRTUMaster::_calculateTimeouts(unsigned long baud, uint32_t config) {
   }
 }
 
-uint16_t ModbusRTUMaster::_crc(uint8_t len) {
-  uint16_t value = 0xFFFF;
-  for (uint8_t i = 0; i < len; i++) {
-    value ^= (uint16_t)_buf[i];
-    for (uint8_t j = 0; j < 8; j++) {
-      bool lsb = value & 1;
-      value >>= 1;
-      if (lsb == true) value ^= 0xA001;
-    }
-  }
-  return value;
-}
-
 uint16_t ModbusRTUMaster::_div8RndUp(uint16_t value) {
   return (value + 7) >> 3;
 }
@@ -2,13 +2,46 @@
 #define ModbusRTUMaster_h
 
 #define MODBUS_RTU_MASTER_BUF_SIZE 256
-#define NO_DE_PIN 255
 
 #include "Arduino.h"
+#include "ModbusCRC.h"
+#include "ModbusRTUTransport.h"
 #ifdef __AVR__
 #include <SoftwareSerial.h>
 #endif
 
+enum ModbusRTUMasterStatus : uint8_t {
+  MODBUS_RTU_MASTER_IDLE,             // Prepared but not yet submitted
+  MODBUS_RTU_MASTER_PENDING,          // Request submitted, waiting for the response
+  MODBUS_RTU_MASTER_SUCCESS,
+  MODBUS_RTU_MASTER_TIMEOUT,
+  MODBUS_RTU_MASTER_EXCEPTION,
+  MODBUS_RTU_MASTER_FRAME_ERROR,
+  MODBUS_RTU_MASTER_INVALID_REQUEST
+};
+
+struct ModbusRTUMasterTransaction;
+typedef void (*ModbusRTUMasterCallback)(ModbusRTUMasterTransaction& transaction);
+
+// A single request/response exchange. The caller owns the transaction and the
+// data buffers it points to, and they must remain valid until the status
+// leaves MODBUS_RTU_MASTER_PENDING.
+struct ModbusRTUMasterTransaction {
+  uint8_t id = 0;
+  uint8_t functionCode = 0;
+  uint16_t address = 0;
+  uint16_t quantity = 0;
+  bool *coils = 0;          // FC01/02 destination, FC15 source
+  uint16_t *registers = 0;  // FC03/04 destination, FC16 source
+  uint16_t value = 0;       // FC05/06 value
+  volatile ModbusRTUMasterStatus status = MODBUS_RTU_MASTER_IDLE;
+  uint8_t exceptionCode = 0;
+  uint32_t timeout = 0;       // Response timeout in microseconds, 0 to use setTimeout()
+  uint32_t responseTime = 0;  // Microseconds from the end of the request to the start of the response, 0 if none
+  ModbusRTUMasterCallback callback = 0;
+  void *context = 0;
+};
+
 class ModbusRTUMaster {
   public:
     ModbusRTUMaster(HardwareSerial& serial, uint8_t dePin = NO_DE_PIN);
@@ -18,6 +51,8 @@ class ModbusRTUMaster {
     #ifdef HAVE_CDCSERIAL
     ModbusRTUMaster(Serial_& serial, uint8_t dePin = NO_DE_PIN);
     #endif
+    // Run over a custom transport (e.g. DMA driven), begin() only starts the transport
+    ModbusRTUMaster(ModbusRTUTransport& transport);
     void setTimeout(uint32_t timeout);
     #ifdef ESP32
     void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1, bool invert = false);
@@ -32,6 +67,16 @@ class ModbusRTUMaster {
     bool writeSingleHoldingRegister(uint8_t id, uint16_t address, uint16_t value);
     bool writeMultipleCoils(uint8_t id, uint16_t startAddress, bool *buf, uint16_t quantity);
     bool writeMultipleHoldingRegisters(uint8_t id, uint16_t startAddress, uint16_t *buf, uint16_t quantity);
+
+    // Asynchronous transaction engine. submit() sends the request and returns
+    // immediately, poll() advances the receive state machine and must be called
+    // regularly until the transaction completes. submit() returns false, leaving
+    // the status untouched, until the line has been silent for 3.5 characters
+    // after the previous frame.
+    bool submit(ModbusRTUMasterTransaction *transaction);
+    void poll();
+    bool isBusy();
+
     bool getTimeoutFlag();
     void clearTimeoutFlag();
     uint8_t getExceptionResponse();
@@ -45,21 +90,42 @@ class ModbusRTUMaster {
     #ifdef HAVE_CDCSERIAL
     Serial_ *_usbSerial;
     #endif
-    Stream *_serial;
-    uint8_t _dePin;
+    ModbusRTUStreamTransport _streamTransport;
+    ModbusRTUTransport *_transport;
     uint8_t _buf[MODBUS_RTU_MASTER_BUF_SIZE];
+    uint32_t _charTime;
     uint32_t _charTimeout;
     uint32_t _frameTimeout;
     uint32_t _responseTimeout = 100;
     bool _timeoutFlag = false;
     uint8_t _exceptionResponse = 0;
-    
-    void _writeRequest(uint8_t len);
-    uint16_t _readResponse(uint8_t id, uint8_t function);
+
+    enum _State : uint8_t {
+      _STATE_IDLE,
+      _STATE_SENDING,
+      _STATE_WAIT_RESPONSE,
+      _STATE_RECEIVING,
+      _STATE_FRAME_GAP
+    };
+    _State _state = _STATE_IDLE;
+    ModbusRTUMasterTransaction *_transaction = 0;
+    uint16_t _numBytes = 0;
+    uint16_t _expectedBytes = 0;  // Response length once known from the header, 0 until then
+    uint16_t _crc = MODBUS_CRC_INIT;  // Running CRC of the bytes received so far
+    uint32_t _requestTime = 0;  // micros() at the end of the request
+    uint32_t _lineIdleTime = 0; // micros() at the end of the last frame on the line
+    uint32_t _timeout = 0;
+
+    bool _transact(ModbusRTUMasterTransaction& transaction);
+    bool _buildRequest(ModbusRTUMasterTransaction& transaction, uint8_t& len);
+    bool _writeRequest(uint8_t len);
+    ModbusRTUMasterStatus _processResponse(ModbusRTUMasterTransaction& transaction);
+    uint16_t _expectedLength();
+    void _complete(ModbusRTUMasterStatus status);
+    bool _lineIdle();
     void _clearRxBuffer();
 
     void _calculateTimeouts(unsigned long baud, uint32_t config);
-    uint16_t _crc(uint8_t len);
     uint16_t _div8RndUp(uint16_t value);
     uint16_t _bytesToWord(uint8_t high, uint8_t low);
 };
@@ -0,0 +1,33 @@
+#include "ModbusRTUTransport.h"
+
+void ModbusRTUStreamTransport::begin(unsigned long baud, uint32_t config) {
+  (void)baud;
+  (void)config;
+  if (_dePin != NO_DE_PIN) {
+    pinMode(_dePin, OUTPUT);
+    digitalWrite(_dePin, LOW);
+  }
+}
+
+bool ModbusRTUStreamTransport::send(const uint8_t *frame, uint16_t len) {
+  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, HIGH);
+  _serial->write(frame, len);
+  _serial->flush();
+  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, LOW);
+  return true;
+}
+
+uint16_t ModbusRTUStreamTransport::read(uint8_t *buf, uint16_t len) {
+  uint16_t count = 0;
+  while (count < len && _serial->available()) {
+    buf[count++] = _serial->read();
+  }
+  if (count) _lastRxTime = micros();
+  return count;
+}
+
+void ModbusRTUStreamTransport::discard() {
+  if (!_serial->available()) return;
+  while (_serial->available()) _serial->read();
+  _lastRxTime = micros();
+}
@@ -0,0 +1,53 @@
+#ifndef ModbusRTUTransport_h
+#define ModbusRTUTransport_h
+
+#include "Arduino.h"
+
+#ifndef NO_DE_PIN
+#define NO_DE_PIN 255
+#endif
+
+// Byte transport under ModbusRTUMaster. Frames are handed over whole for transmission, received
+// bytes are read in blocks, and the transport timestamps the end of the last received byte so the
+// master can detect the inter-frame gap without watching the line itself. Implementations can do
+// the work in hardware (DMA/IRQ) and leave the CPU free while a frame is on the wire.
+class ModbusRTUTransport {
+  public:
+    virtual ~ModbusRTUTransport() {}
+    virtual void begin(unsigned long baud, uint32_t config) = 0;
+
+    // Start sending a complete frame (the frame is copied). Returns false if still sending.
+    virtual bool send(const uint8_t *frame, uint16_t len) = 0;
+    // True until the last stop bit of the frame has left the line and the driver is released
+    virtual bool sending() = 0;
+
+    // Received bytes waiting to be read
+    virtual int available() = 0;
+    virtual uint16_t read(uint8_t *buf, uint16_t len) = 0;
+    // micros() at the end of the last received byte
+    virtual uint32_t lastRxMicros() = 0;
+    // Drop all received bytes
+    virtual void discard() = 0;
+};
+
+// Transport over any Arduino Stream, driving an optional DE pin around each frame. Sending blocks
+// until the frame has been written out, and the receive timestamp is taken when bytes are read.
+class ModbusRTUStreamTransport : public ModbusRTUTransport {
+  public:
+    ModbusRTUStreamTransport() : _serial(0), _dePin(NO_DE_PIN) {}
+    ModbusRTUStreamTransport(Stream& serial, uint8_t dePin = NO_DE_PIN) : _serial(&serial), _dePin(dePin) {}
+    void begin(unsigned long baud, uint32_t config) override;
+    bool send(const uint8_t *frame, uint16_t len) override;
+    bool sending() override { return false; }
+    int available() override { return _serial->available(); }
+    uint16_t read(uint8_t *buf, uint16_t len) override;
+    uint32_t lastRxMicros() override { return _lastRxTime; }
+    void discard() override;
+
+  private:
+    Stream *_serial;
+    uint8_t _dePin;
+    uint32_t _lastRxTime = 0;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include "ModbusRTUTransportRP2040.h"
+#include <hardware/uart.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/gpio.h>
+#include <pico/time.h>
+
+static ModbusRTUTransportRP2040 *_irqTransport[2] = {0, 0};
+
+static void _uart0Irq() {
+  if (_irqTransport[0]) _irqTransport[0]->handleIrq();
+}
+
+static void _uart1Irq() {
+  if (_irqTransport[1]) _irqTransport[1]->handleIrq();
+}
+
+static int64_t _txDoneAlarm(alarm_id_t id, void *transport) {
+  (void)id;
+  return ((ModbusRTUTransportRP2040 *)transport)->handleTxDone();
+}
+
+ModbusRTUTransportRP2040::ModbusRTUTransportRP2040(uint8_t uart, uint8_t txPin, uint8_t rxPin, uint8_t dePin) {
+  _uart = uart ? 1 : 0;
+  _txPin = txPin;
+  _rxPin = rxPin;
+  _dePin = dePin;
+}
+
+void ModbusRTUTransportRP2040::begin(unsigned long baud, uint32_t config) {
+  uart_inst_t *uart = uart_get_instance(_uart);
+  uint irq = _uart ? UART1_IRQ : UART0_IRQ;
+  irq_set_enabled(irq, false);
+
+  uint dataBits = 8;
+  switch (config & SERIAL_DATA_MASK) {
+    case SERIAL_DATA_5: dataBits = 5; break;
+    case SERIAL_DATA_6: dataBits = 6; break;
+    case SERIAL_DATA_7: dataBits = 7; break;
+    default: break;
+  }
+  uart_parity_t parity = UART_PARITY_NONE;
+  switch (config & SERIAL_PARITY_MASK) {
+    case SERIAL_PARITY_EVEN: parity = UART_PARITY_EVEN; break;
+    case SERIAL_PARITY_ODD: parity = UART_PARITY_ODD; break;
+    default: break;
+  }
+  uint stopBits = (config & SERIAL_STOP_BIT_MASK) == SERIAL_STOP_BIT_2 ? 2 : 1;
+
+  uart_init(uart, baud);
+  uart_set_format(uart, dataBits, stopBits, parity);
+  uart_set_fifo_enabled(uart, true);
+  uart_set_hw_flow(uart, false, false);
+  gpio_set_function(_txPin, GPIO_FUNC_UART);
+  gpio_set_function(_rxPin, GPIO_FUNC_UART);
+  if (_dePin != NO_DE_PIN) {
+    pinMode(_dePin, OUTPUT);
+    digitalWrite(_dePin, LOW);
+  }
+  _timeoutUs = (32 * 1000000UL) / baud;
+  uint32_t charBits = 1 + dataBits + (parity != UART_PARITY_NONE ? 1 : 0) + stopBits;
+  _charUs = (charBits * 1000000UL + baud - 1) / baud;
+  _bitUs = max(1UL, 1000000UL / baud);
+
+  if (_txDma < 0) _txDma = dma_claim_unused_channel(true);
+  dma_channel_config dmaConfig = dma_channel_get_default_config(_txDma);
+  channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_8);
+  channel_config_set_read_increment(&dmaConfig, true);
+  channel_config_set_write_increment(&dmaConfig, false);
+  channel_config_set_dreq(&dmaConfig, uart_get_dreq(uart, true));
+  dma_channel_set_config(_txDma, &dmaConfig, false);
+  dma_channel_set_write_addr(_txDma, &uart_get_hw(uart)->dr, false);
+
+  _rxHead = 0;
+  _rxTail = 0;
+  _sending = false;
+  _irqTransport[_uart] = this;
+  irq_set_exclusive_handler(irq, _uart ? _uart1Irq : _uart0Irq);
+  uart_set_irq_enables(uart, true, false);  // RX FIFO level (1/8) and receive timeout
+  irq_set_enabled(irq, true);
+}
+
+bool ModbusRTUTransportRP2040::send(const uint8_t *frame, uint16_t len) {
+  if (sending() || len > MODBUS_RTU_RP2040_TX_BUF_SIZE) return false;
+  memcpy(_txBuf, frame, len);
+  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, HIGH);
+  _sending = true;
+  dma_channel_transfer_from_buffer_now(_txDma, _txBuf, len);
+  if (_dePin != NO_DE_PIN) {
+    // Release DE from the timer interrupt at the end of the frame, polled from sending() only if
+    // no alarm is free
+    _deAlarm = true;
+    if (add_alarm_in_us((uint64_t)len * _charUs, _txDoneAlarm, this, true) < 0) _deAlarm = false;
+  }
+  return true;
+}
+
+// Timer interrupt: the frame should be out, wait a bit period at a time for the last stop bit
+int64_t ModbusRTUTransportRP2040::handleTxDone() {
+  if (dma_channel_is_busy(_txDma) || (uart_get_hw(uart_get_instance(_uart))->fr & UART_UARTFR_BUSY_BITS)) {
+    return -(int64_t)_bitUs;
+  }
+  gpio_put(_dePin, 0);
+  _sending = false;
+  return 0;
+}
+
+bool ModbusRTUTransportRP2040::sending() {
+  if (!_sending) return false;
+  if (_deAlarm) return true;
+  if (dma_channel_is_busy(_txDma)) return true;
+  // DMA done only means the FIFO has been loaded, wait for the last stop bit
+  if (uart_get_hw(uart_get_instance(_uart))->fr & UART_UARTFR_BUSY_BITS) return true;
+  if (_dePin != NO_DE_PIN) digitalWrite(_dePin, LOW);
+  _sending = false;
+  return false;
+}
+
+int ModbusRTUTransportRP2040::available() {
+  return (uint16_t)(_rxHead - _rxTail);
+}
+
+uint16_t ModbusRTUTransportRP2040::read(uint8_t *buf, uint16_t len) {
+  uint16_t tail = _rxTail;
+  uint16_t count = (uint16_t)(_rxHead - tail);
+  if (count > len) count = len;
+  for (uint16_t i = 0; i < count; i++) {
+    buf[i] = _rxBuf[(tail + i) & (MODBUS_RTU_RP2040_RX_BUF_SIZE - 1)];
+  }
+  _rxTail = tail + count;
+  return count;
+}
+
+void ModbusRTUTransportRP2040::discard() {
+  _rxTail = _rxHead;
+}
+
+void ModbusRTUTransportRP2040::handleIrq() {
+  uart_hw_t *hw = uart_get_hw(uart_get_instance(_uart));
+  bool idle = hw->mis & UART_UARTMIS_RTMIS_BITS;
+  uint16_t head = _rxHead;
+  while (!(hw->fr & UART_UARTFR_RXFE_BITS)) {
+    uint32_t data = hw->dr;
+    if (data & (UART_UARTDR_FE_BITS | UART_UARTDR_PE_BITS | UART_UARTDR_BE_BITS | UART_UARTDR_OE_BITS)) _rxErrors++;
+    if ((uint16_t)(head - _rxTail) >= MODBUS_RTU_RP2040_RX_BUF_SIZE) {
+      _rxOverruns++;
+      continue;
+    }
+    _rxBuf[head & (MODBUS_RTU_RP2040_RX_BUF_SIZE - 1)] = (uint8_t)data;
+    head++;
+  }
+  _rxHead = head;
+  hw->icr = UART_UARTICR_RTIC_BITS | UART_UARTICR_RXIC_BITS;
+
+  // The receive timeout fires 32 bit periods after the last byte arrived
+  uint32_t now = time_us_32();
+  _lastRxTime = idle ? now - _timeoutUs : now;
+}
+
+#endif
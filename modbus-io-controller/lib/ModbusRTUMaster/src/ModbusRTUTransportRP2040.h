@@ -0,0 +1,59 @@
+#ifndef ModbusRTUTransportRP2040_h
+#define ModbusRTUTransportRP2040_h
+
+#include "ModbusRTUTransport.h"
+
+#define MODBUS_RTU_RP2040_RX_BUF_SIZE 512  // Power of 2
+#define MODBUS_RTU_RP2040_TX_BUF_SIZE 256
+
+// RS485 transport driving an RP2040 UART directly (the Arduino SerialN object for the same UART
+// must not be started).
+// - TX: the frame is copied to a buffer and sent by a DMA channel. sending() stays true until the
+//   UART shift register is empty. The DE pin (if any) is released by a timer alarm set for the end
+//   of the frame, which then waits for the shift register to empty, so the driver is never held
+//   into the slave's response by a caller that is slow to check sending().
+// - RX: the UART interrupt drains the hardware FIFO into a ring buffer when it is 1/8 full, and
+//   on the receive timeout (32 idle bit periods with data in the FIFO) for the tail of a frame.
+//   The receive timeout marks the end of a frame in hardware, the timestamp of the last byte is
+//   back-dated by the timeout so the master's inter-frame gap is measured from the real end.
+// Reception errors (framing, parity, break, overrun) are counted, the bytes are kept and fail the
+// frame CRC.
+class ModbusRTUTransportRP2040 : public ModbusRTUTransport {
+  public:
+    ModbusRTUTransportRP2040(uint8_t uart, uint8_t txPin, uint8_t rxPin, uint8_t dePin = NO_DE_PIN);
+    void begin(unsigned long baud, uint32_t config) override;
+    bool send(const uint8_t *frame, uint16_t len) override;
+    bool sending() override;
+    int available() override;
+    uint16_t read(uint8_t *buf, uint16_t len) override;
+    uint32_t lastRxMicros() override { return _lastRxTime; }
+    void discard() override;
+
+    uint32_t rxErrors() const { return _rxErrors; }
+    uint32_t rxOverruns() const { return _rxOverruns; }
+
+    void handleIrq();       // Called from the UART interrupt
+    int64_t handleTxDone(); // Called from the DE release alarm, returns the alarm reschedule time
+
+  private:
+    uint8_t _uart;
+    uint8_t _txPin;
+    uint8_t _rxPin;
+    uint8_t _dePin;
+    int _txDma = -1;
+    volatile bool _sending = false;
+    bool _deAlarm = false;    // DE is released by the alarm rather than in sending()
+    uint32_t _timeoutUs = 0;  // Receive timeout, 32 bit periods
+    uint32_t _charUs = 0;     // Character time, start to last stop bit
+    uint32_t _bitUs = 1;
+
+    uint8_t _txBuf[MODBUS_RTU_RP2040_TX_BUF_SIZE];
+    uint8_t _rxBuf[MODBUS_RTU_RP2040_RX_BUF_SIZE];
+    volatile uint16_t _rxHead = 0;  // Written by the interrupt
+    volatile uint16_t _rxTail = 0;
+    volatile uint32_t _lastRxTime = 0;
+    volatile uint32_t _rxErrors = 0;
+    volatile uint32_t _rxOverruns = 0;
+};
+
+#endif
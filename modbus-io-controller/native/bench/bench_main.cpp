@@ -0,0 +1,295 @@
+#include <Arduino.h>
+#include "native_host.h"
+#include "RS485BusSim.h"
+#include "sys_init.h"
+#include "io_core/board_config.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Poll-cycle benchmark. Runs the real io_core scheduler (manage_io_core()) against two simulated
+// RS485 buses under the virtual clock and reports, per scenario, one JSON object per line:
+//
+//   boards_per_s      board snapshots published to thermocoupleIO_index per simulated second
+//   age_us            sensor conversion to its value being visible in the published snapshot
+//                     (p50/p99/p999/max)
+//   interval_us       time between updates of the same board (p50/p99/max)
+//   bytes_per_cycle   bytes on the wire (both directions, both buses) per poll cycle
+//   cpu_ns_per_cycle  host CPU time in manage_io_core() per poll cycle, board emulation excluded
+//
+// A poll cycle is one scheduled poll of every configured board. Each scenario runs in a forked
+// process so firmware globals start from scratch.
+
+struct benchOptions_t {
+    const char *scenario = "all";
+    uint32_t seconds = 30;          // Simulated run time per scenario
+    uint32_t pollMs = MIN_POLL_TIME;
+    uint8_t boards = MAX_BOARDS;
+    uint32_t stepUs = 10;           // Virtual time between manage_io_core() calls
+    uint32_t conversionUs = SIM_TC_CONVERSION_US; // Simulated sensor conversion time, 0 samples per request
+    uint32_t seed = 1;
+};
+
+struct benchScenario_t {
+    const char *name;
+    float offlineFraction;
+    float bitErrorRate;
+    float dropRate;
+    uint32_t churnMs;               // Board config update interval, 0 for none
+};
+
+static const benchScenario_t scenarios[] = {
+    {"healthy",   0.0f,  0.0f,    0.0f,  0},
+    {"offline25", 0.25f, 0.0f,    0.0f,  0},
+    {"noisy",     0.0f,  0.001f,  0.01f, 0},
+    {"churn",     0.0f,  0.0f,    0.0f,  250},
+};
+
+static uint64_t threadCpuNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+template <typename T>
+static T percentile(std::vector<T> &values, double p) {
+    if (values.empty()) return 0;
+    size_t rank = (size_t)(p * (double)(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+// Setup -------------------------------------------------------------------->
+static void configureBoards(const benchOptions_t &opt) {
+    memset(boardConfigs, 0, sizeof(boardConfigs));
+    boardCount = opt.boards;
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        BoardConfig &cfg = boardConfigs[i];
+        snprintf(cfg.boardName, sizeof(cfg.boardName), "Bench %d", i);
+        cfg.type = THERMOCOUPLE_IO;
+        cfg.boardIndex = i;
+        cfg.modbusPort = i & 1;
+        cfg.slaveID = i / 2 + 1;
+        cfg.pollTime = opt.pollMs;
+        cfg.recordInterval = 60000;
+        cfg.initialised = true;
+        for (uint8_t ch = 0; ch < 8; ch++) {
+            cfg.settings.thermocoupleIO.channels[ch].alertEnable = true;
+            cfg.settings.thermocoupleIO.channels[ch].outputEnable = true;
+            cfg.settings.thermocoupleIO.channels[ch].alertSetpoint = 200.0f;
+            cfg.settings.thermocoupleIO.channels[ch].alertHysteresis = 5;
+        }
+    }
+}
+
+// Poll counters live in the device index and are kept across apply_board_configs()
+static void collectPollStats(uint8_t boards, uint64_t &polls, uint64_t &missed) {
+    for (uint8_t i = 0; i < boards; i++) {
+        pollStats_t *stats = getPollStats(i);
+        if (!stats) continue;
+        polls += stats->polls;
+        missed += stats->missed;
+    }
+}
+
+// Same path as the board update API: save the config, then re-apply all boards
+static void churnBoard(uint8_t index) {
+    BoardConfig cfg = boardConfigs[index];
+    auto &channel = cfg.settings.thermocoupleIO.channels[0];
+    channel.alertSetpoint = channel.alertSetpoint == 200.0f ? 210.0f : 200.0f;
+    channel.outputEnable = !channel.outputEnable;
+    updateBoard(index, cfg);
+    apply_board_configs();
+}
+
+// Scenario run ------------------------------------------------------------->
+static void runScenario(const benchScenario_t &scenario, const benchOptions_t &opt) {
+    nativeUseVirtualClock(true);
+    nativeSetMicros(1000000);
+    globalDateTime = epochToDateTime(1767225600); // RTC as if set, record_thermocouple() needs a valid time
+
+    char root[] = "/tmp/modbus-io-bench.XXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "[bench] Failed to create temp dir\n");
+        exit(1);
+    }
+    std::string littleFSRoot = std::string(root) + "/littlefs";
+    std::string sdRoot = std::string(root) + "/sd";
+    nativeMakeDirs(littleFSRoot.c_str());
+    nativeMakeDirs(sdRoot.c_str());
+    nativeSetLittleFSRoot(littleFSRoot.c_str());
+    nativeSetSDRoot(sdRoot.c_str());
+
+    rs485SimConfig_t simConfig;
+    simConfig.bitErrorRate = scenario.bitErrorRate;
+    simConfig.dropRate = scenario.dropRate;
+    RS485BusSim *sim[2];
+    for (uint8_t port = 0; port < 2; port++) {
+        simConfig.seed = opt.seed * 2 + port;
+        sim[port] = new RS485BusSim(simConfig);
+    }
+
+    // Boards are spread over both buses, the last offlineFraction of them never answer
+    std::vector<ThermocoupleBoardSim *> boards;
+    uint8_t offline = (uint8_t)(opt.boards * scenario.offlineFraction + 0.5f);
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        ThermocoupleBoardSim *board = new ThermocoupleBoardSim(i / 2 + 1);
+        board->setOnline(i < opt.boards - offline);
+        board->setConversionTime(opt.conversionUs, (opt.seed + i) * 2654435761u);
+        sim[i & 1]->addBoard(board);
+        boards.push_back(board);
+    }
+    nativeAttachRS485(0, sim[0]);
+    nativeAttachRS485(1, sim[1]);
+    bus1.begin(500000);
+    bus2.begin(500000);
+
+    configureBoards(opt);
+    apply_board_configs();
+    for (uint8_t port = 0; port < 2; port++) sim[port]->resetStats();
+
+    std::vector<uint32_t> ages;
+    std::vector<uint32_t> intervals;
+    std::vector<uint32_t> callCpu;
+    std::vector<uint64_t> lastVisible(opt.boards, 0);
+    std::vector<uint64_t> lastSample(opt.boards, 0);
+    thermocoupleSnapshot_t snapshot;
+    uint64_t updates = 0;
+    uint64_t polls = 0;
+    uint64_t missed = 0;
+    uint64_t cpuTotal = 0;
+    uint64_t start = time_us_64();
+    uint64_t end = start + (uint64_t)opt.seconds * 1000000;
+    uint64_t nextChurn = start + (uint64_t)scenario.churnMs * 1000;
+    uint8_t churnIndex = 0;
+    callCpu.reserve((size_t)(end - start) / opt.stepUs + 1);
+
+    while (time_us_64() < end) {
+        uint64_t simCpu = sim[0]->stats().hostCpuNs + sim[1]->stats().hostCpuNs;
+        uint64_t cpu = threadCpuNs();
+        manage_io_core();
+        cpu = threadCpuNs() - cpu;
+        simCpu = sim[0]->stats().hostCpuNs + sim[1]->stats().hostCpuNs - simCpu;
+        cpu = cpu > simCpu ? cpu - simCpu : 0;
+        cpuTotal += cpu;
+        callCpu.push_back((uint32_t)min(cpu, (uint64_t)UINT32_MAX));
+
+        // A new snapshot is a publication, its age is that of the conversion the temperatures
+        // came from. A conversion read by several polls is only counted the first time it shows,
+        // and a board's first one was taken before the run started.
+        uint64_t now = time_us_64();
+        for (uint8_t i = 0; i < opt.boards; i++) {
+            if (!thermocouple_read_snapshot(i, &snapshot) || snapshot.timestamp == lastVisible[i]) continue;
+            updates++;
+            if (lastVisible[i]) intervals.push_back((uint32_t)(now - lastVisible[i]));
+            lastVisible[i] = snapshot.timestamp;
+            uint64_t sampleUs = boards[i]->sampleTime(snapshot.reg.temperature);
+            if (!sampleUs || sampleUs == lastSample[i]) continue;
+            if (lastSample[i]) ages.push_back((uint32_t)(now - sampleUs));
+            lastSample[i] = sampleUs;
+        }
+
+        if (scenario.churnMs && now >= nextChurn) {
+            churnBoard(churnIndex);
+            churnIndex = (churnIndex + 1) % opt.boards;
+            nextChurn += (uint64_t)scenario.churnMs * 1000;
+        }
+        nativeAdvanceMicros(opt.stepUs);
+    }
+
+    // Results --------------------------------------------------------------->
+    double seconds = (double)(time_us_64() - start) / 1e6;
+    collectPollStats(opt.boards, polls, missed);
+    double cycles = (double)polls / opt.boards;
+    rs485SimStats_t s0 = sim[0]->stats();
+    rs485SimStats_t s1 = sim[1]->stats();
+    uint64_t wireBytes = s0.txBytes + s0.rxBytes + s1.txBytes + s1.rxBytes;
+    uint64_t callCpuMean = callCpu.empty() ? 0 : cpuTotal / callCpu.size();
+
+    printf("{\"scenario\":\"%s\",\"boards\":%u,\"offline\":%u,\"poll_ms\":%u,\"step_us\":%u,\"seed\":%u,"
+           "\"sim_s\":%.3f,\"updates\":%llu,\"polls\":%llu,\"missed_polls\":%llu,\"cycles\":%.1f,"
+           "\"boards_per_s\":%.1f,"
+           "\"age_us\":{\"p50\":%u,\"p99\":%u,\"p999\":%u,\"max\":%u},"
+           "\"interval_us\":{\"p50\":%u,\"p99\":%u,\"max\":%u},"
+           "\"bytes_per_cycle\":%.1f,\"bus_utilisation\":[%.3f,%.3f],"
+           "\"cpu_ns_per_cycle\":%.0f,\"cpu_ns_per_call\":{\"mean\":%llu,\"p99\":%u},"
+           "\"errors\":{\"unanswered\":%u,\"dropped\":%u,\"corrupted_bytes\":%u}}\n",
+           scenario.name, opt.boards, offline, opt.pollMs, opt.stepUs, opt.seed,
+           seconds, (unsigned long long)updates, (unsigned long long)polls, (unsigned long long)missed, cycles,
+           updates / seconds,
+           percentile(ages, 0.50), percentile(ages, 0.99), percentile(ages, 0.999),
+           ages.empty() ? 0 : *std::max_element(ages.begin(), ages.end()),
+           percentile(intervals, 0.50), percentile(intervals, 0.99),
+           intervals.empty() ? 0 : *std::max_element(intervals.begin(), intervals.end()),
+           cycles > 0 ? wireBytes / cycles : 0.0, sim[0]->utilisation(), sim[1]->utilisation(),
+           cycles > 0 ? cpuTotal / cycles : 0.0, (unsigned long long)callCpuMean, percentile(callCpu, 0.99),
+           s0.unanswered + s1.unanswered, s0.droppedFrames + s1.droppedFrames, s0.corruptedBytes + s1.corruptedBytes);
+    fflush(stdout);
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--scenario all|healthy|offline25|noisy|churn] [--seconds N] [--poll-ms N]\n"
+                    "          [--boards N] [--step-us N] [--conversion-us N] [--seed N]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    // Results go to stdout with printf, firmware logging through Serial is discarded
+    nativeMuteConsole(true);
+
+    benchOptions_t opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (arg == "--scenario") opt.scenario = value;
+        else if (arg == "--seconds") opt.seconds = strtoul(value, nullptr, 0);
+        else if (arg == "--poll-ms") opt.pollMs = strtoul(value, nullptr, 0);
+        else if (arg == "--boards") opt.boards = (uint8_t)constrain(strtoul(value, nullptr, 0), 1UL, (unsigned long)MAX_BOARDS);
+        else if (arg == "--step-us") opt.stepUs = max(1UL, strtoul(value, nullptr, 0));
+        else if (arg == "--conversion-us") opt.conversionUs = strtoul(value, nullptr, 0);
+        else if (arg == "--seed") opt.seed = strtoul(value, nullptr, 0);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    bool found = false;
+    for (const auto &scenario : scenarios) {
+        if (strcmp(opt.scenario, "all") != 0 && strcmp(opt.scenario, scenario.name) != 0) continue;
+        found = true;
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0) {
+            runScenario(scenario, opt);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "[bench] Scenario %s failed\n", scenario.name);
+            return 1;
+        }
+    }
+    if (!found) {
+        usage(argv[0]);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Note: file name matches the (case-insensitive) include in sys_init.h
+
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+typedef uint16_t neoPixelType;
+
+// NeoPixel shim, keeps the pixel colours in memory so the host can inspect them
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800)
+        : _numLEDs(n > 16 ? 16 : n) { (void)pin; (void)type; }
+
+    void begin(void) {}
+    void show(void) { _shows++; }
+    void setBrightness(uint8_t brightness) { _brightness = brightness; }
+    uint8_t getBrightness(void) const { return _brightness; }
+    void setPixelColor(uint16_t n, uint32_t c) { if (n < _numLEDs) _pixels[n] = c; }
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) { setPixelColor(n, Color(r, g, b)); }
+    uint32_t getPixelColor(uint16_t n) const { return n < _numLEDs ? _pixels[n] : 0; }
+    void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0) {
+        uint16_t end = count ? first + count : _numLEDs;
+        for (uint16_t i = first; i < end && i < _numLEDs; i++) _pixels[i] = c;
+    }
+    void clear(void) { fill(0); }
+    uint16_t numPixels(void) const { return _numLEDs; }
+    uint32_t showCount(void) const { return _shows; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+
+private:
+    uint16_t _numLEDs;
+    uint8_t _brightness = 255;
+    uint32_t _pixels[16] = {0};
+    uint32_t _shows = 0;
+};
@@ -0,0 +1,389 @@
+#pragma once
+
+// Host (Linux) shim for the subset of the Arduino-Pico core used by the controller firmware.
+// Only built by the [env:native] PlatformIO environment, see native/README.md.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#define ARDUINO 10819
+#define ARDUINO_ARCH_RP2040_NATIVE
+
+// Types and constants ------------------------------------------------------>
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+#define INPUT_PULLDOWN  0x3
+
+#define SERIAL_8N1 0x06
+#define SERIAL_8N2 0x0E
+#define SERIAL_8E1 0x26
+#define SERIAL_8E2 0x2E
+#define SERIAL_8O1 0x36
+#define SERIAL_8O2 0x3E
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+template <class T, class L>
+auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template <class T, class L>
+auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Timing ------------------------------------------------------------------->
+unsigned long millis(void);
+unsigned long micros(void);
+uint64_t time_us_64(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+
+// GPIO --------------------------------------------------------------------->
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReadResolution(int bits);
+void analogWrite(uint8_t pin, int value);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// String ------------------------------------------------------------------->
+class String {
+public:
+    String(const char *cstr = "") : _s(cstr ? cstr : "") {}
+    String(const char *cstr, unsigned int length) : _s(cstr ? cstr : "", cstr ? length : 0) {}
+    String(const std::string &s) : _s(s) {}
+    String(const String &other) = default;
+    String(String &&other) = default;
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = DEC) : _s(_fromUnsigned(value, base)) {}
+    explicit String(int value, unsigned char base = DEC) : _s(_fromSigned(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = DEC) : _s(_fromUnsigned(value, base)) {}
+    explicit String(long value, unsigned char base = DEC) : _s(_fromSigned(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = DEC) : _s(_fromUnsigned(value, base)) {}
+    explicit String(long long value, unsigned char base = DEC) : _s(_fromSigned(value, base)) {}
+    explicit String(unsigned long long value, unsigned char base = DEC) : _s(_fromUnsigned(value, base)) {}
+    explicit String(float value, unsigned char decimalPlaces = 2) : _s(_fromDouble(value, decimalPlaces)) {}
+    explicit String(double value, unsigned char decimalPlaces = 2) : _s(_fromDouble(value, decimalPlaces)) {}
+
+    String &operator=(const String &rhs) = default;
+    String &operator=(String &&rhs) = default;
+    String &operator=(const char *cstr) { _s = cstr ? cstr : ""; return *this; }
+
+    unsigned int length(void) const { return _s.length(); }
+    const char *c_str() const { return _s.c_str(); }
+    bool isEmpty(void) const { return _s.empty(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool concat(const char *cstr) { if (cstr) _s += cstr; return true; }
+    bool concat(char c) { _s += c; return true; }
+    bool concat(const char *cstr, unsigned int length) { if (cstr) _s.append(cstr, length); return true; }
+    template <class T> bool concat(T value) { return concat(String(value)); }
+    template <class T> String &operator+=(const T &rhs) { concat(rhs); return *this; }
+
+    char charAt(unsigned int index) const { return index < _s.length() ? _s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return _s[index]; }
+
+    int compareTo(const String &s) const { return _s.compare(s._s); }
+    bool equals(const String &s) const { return _s == s._s; }
+    bool equals(const char *cstr) const { return _s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String &s) const { return strcasecmp(_s.c_str(), s._s.c_str()) == 0; }
+    bool operator==(const String &rhs) const { return equals(rhs); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &rhs) const { return !equals(rhs); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &rhs) const { return _s < rhs._s; }
+    bool operator>(const String &rhs) const { return _s > rhs._s; }
+    bool startsWith(const String &prefix) const { return _s.compare(0, prefix._s.length(), prefix._s) == 0; }
+    bool startsWith(const String &prefix, unsigned int offset) const { return _s.compare(offset, prefix._s.length(), prefix._s) == 0; }
+    bool endsWith(const String &suffix) const {
+        return _s.length() >= suffix._s.length() && _s.compare(_s.length() - suffix._s.length(), suffix._s.length(), suffix._s) == 0;
+    }
+
+    int indexOf(char c, unsigned int fromIndex = 0) const { return _npos(_s.find(c, fromIndex)); }
+    int indexOf(const String &s, unsigned int fromIndex = 0) const { return _npos(_s.find(s._s, fromIndex)); }
+    int lastIndexOf(char c) const { return _npos(_s.rfind(c)); }
+    int lastIndexOf(char c, unsigned int fromIndex) const { return _npos(_s.rfind(c, fromIndex)); }
+    int lastIndexOf(const String &s) const { return _npos(_s.rfind(s._s)); }
+    String substring(unsigned int beginIndex) const { return beginIndex < _s.length() ? String(_s.substr(beginIndex)) : String(); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const {
+        if (beginIndex > endIndex) { unsigned int t = beginIndex; beginIndex = endIndex; endIndex = t; }
+        if (beginIndex >= _s.length()) return String();
+        return String(_s.substr(beginIndex, endIndex - beginIndex));
+    }
+
+    void replace(char find, char replace) { for (auto &c : _s) if (c == find) c = replace; }
+    void replace(const String &find, const String &replace) {
+        if (find._s.empty()) return;
+        size_t pos = 0;
+        while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+            _s.replace(pos, find._s.length(), replace._s);
+            pos += replace._s.length();
+        }
+    }
+    void remove(unsigned int index) { if (index < _s.length()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.length()) _s.erase(index, count); }
+    void toLowerCase(void) { for (auto &c : _s) c = tolower(c); }
+    void toUpperCase(void) { for (auto &c : _s) c = toupper(c); }
+    void trim(void) {
+        size_t first = _s.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) { _s.clear(); return; }
+        _s = _s.substr(first, _s.find_last_not_of(" \t\r\n") - first + 1);
+    }
+
+    long toInt(void) const { return atol(_s.c_str()); }
+    float toFloat(void) const { return atof(_s.c_str()); }
+    double toDouble(void) const { return atof(_s.c_str()); }
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const { getBytes((unsigned char *)buf, bufsize, index); }
+    void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const {
+        if (!bufsize || !buf) return;
+        size_t n = index < _s.length() ? _s.copy((char *)buf, bufsize - 1, index) : 0;
+        buf[n] = 0;
+    }
+
+    friend String operator+(const String &lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+    friend String operator+(const String &lhs, const char *rhs) { String s(lhs); s.concat(rhs); return s; }
+    friend String operator+(const char *lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+    friend String operator+(const String &lhs, char rhs) { String s(lhs); s.concat(rhs); return s; }
+    template <class T> friend String operator+(const String &lhs, T rhs) { String s(lhs); s.concat(String(rhs)); return s; }
+
+private:
+    std::string _s;
+
+    static int _npos(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    static std::string _fromUnsigned(unsigned long long value, unsigned char base);
+    static std::string _fromSigned(long long value, unsigned char base);
+    static std::string _fromDouble(double value, unsigned char decimalPlaces);
+};
+
+// Print and Stream --------------------------------------------------------->
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(int value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned char)digits)); }
+
+    size_t println(void) { return write("\r\n"); }
+    template <class T> size_t println(const T &value) { size_t n = print(value); return n + println(); }
+    template <class T> size_t println(const T &value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout(void) { return _timeout; }
+
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length);
+    size_t readBytesUntil(char terminator, uint8_t *buffer, size_t length) { return readBytesUntil(terminator, (char *)buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long _timeout = 1000;
+    int timedRead();
+};
+
+// Serial ports ------------------------------------------------------------->
+class HardwareSerial : public Stream {
+public:
+    virtual void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
+    virtual void begin(unsigned long baud, uint16_t config) = 0;
+    virtual void end() {}
+    virtual operator bool() { return true; }
+    using Print::write;
+};
+
+// UART shim. Bytes written by the firmware are queued for the host side (e.g. a bus simulator)
+// and bytes injected by the host are returned by read(). Alternatively a host stream can be
+// attached, in which case all traffic is forwarded to it.
+class SerialUART : public HardwareSerial {
+public:
+    SerialUART(int id) : _id(id) {}
+
+    bool setTX(uint8_t pin) { _tx = pin; return true; }
+    bool setRX(uint8_t pin) { _rx = pin; return true; }
+    bool setFIFOSize(size_t size) { _fifoSize = size; return true; }
+
+    using HardwareSerial::begin;
+    void begin(unsigned long baud, uint16_t config) override;
+    void end() override;
+    unsigned long getBaud() const { return _baud; }
+    uint16_t getConfig() const { return _config; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int availableForWrite() override { return (int)_fifoSize; }
+    void flush() override;
+    using Print::write;
+
+    // Host side
+    void attach(HardwareSerial *host) { std::lock_guard<std::mutex> lock(_mutex); _host = host; }
+    void hostInject(const uint8_t *data, size_t length);
+    size_t hostDrain(uint8_t *data, size_t length);
+
+private:
+    int _id;
+    uint8_t _tx = 0;
+    uint8_t _rx = 0;
+    size_t _fifoSize = 32;
+    unsigned long _baud = 0;
+    uint16_t _config = SERIAL_8N1;
+    HardwareSerial *_host = nullptr;
+    std::deque<uint8_t> _rxQueue;
+    std::deque<uint8_t> _txQueue;
+    std::mutex _mutex;
+};
+
+// USB console shim, mapped onto stdin/stdout
+class SerialUSB : public HardwareSerial {
+public:
+    using HardwareSerial::begin;
+    void begin(unsigned long baud, uint16_t config) override { (void)baud; (void)config; }
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    void flush() override { fflush(stdout); }
+    using Print::write;
+
+private:
+    int _peeked = -1;
+};
+
+extern SerialUSB Serial;
+extern SerialUART Serial1;
+extern SerialUART Serial2;
+
+// IPAddress ---------------------------------------------------------------->
+class IPAddress {
+public:
+    IPAddress() { memset(_bytes, 0, sizeof(_bytes)); }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _bytes[0] = a; _bytes[1] = b; _bytes[2] = c; _bytes[3] = d; }
+    IPAddress(uint32_t address) { memcpy(_bytes, &address, sizeof(_bytes)); }
+    IPAddress(const uint8_t *address) { memcpy(_bytes, address, sizeof(_bytes)); }
+
+    bool fromString(const char *address);
+    bool fromString(const String &address) { return fromString(address.c_str()); }
+    String toString() const;
+    bool isSet() const { return (uint32_t)*this != 0; }
+
+    operator uint32_t() const { uint32_t a; memcpy(&a, _bytes, sizeof(a)); return a; }
+    bool operator==(const IPAddress &addr) const { return memcmp(_bytes, addr._bytes, sizeof(_bytes)) == 0; }
+    bool operator!=(const IPAddress &addr) const { return !(*this == addr); }
+    uint8_t operator[](int index) const { return _bytes[index]; }
+    uint8_t &operator[](int index) { return _bytes[index]; }
+
+private:
+    uint8_t _bytes[4];
+};
+
+#define INADDR_NONE IPAddress(0, 0, 0, 0)
+
+// RP2040 helper object ----------------------------------------------------->
+class RP2040 {
+public:
+    void restart();
+    void reboot();
+    int cpuid();    // 0 on the main thread (core 0), 1 on any other thread (core 1)
+    int getFreeHeap() { return 128 * 1024; }
+    int getUsedHeap() { return 0; }
+    int getTotalHeap() { return 256 * 1024; }
+    uint32_t getCycleCount() { return (uint32_t)time_us_64() * 250; }
+    uint64_t getCycleCount64() { return time_us_64() * 250; }
+    void idleOtherCore() {}
+    void resumeOtherCore() {}
+};
+
+extern RP2040 rp2040;
+
+// Sketch entry points
+void setup(void);
+void loop(void);
+void setup1(void) __attribute__((weak));
+void loop1(void) __attribute__((weak));
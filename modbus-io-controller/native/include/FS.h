@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+// Filesystem shim mapping the Arduino-Pico FS API onto a host directory
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class FS;
+
+class File : public Stream {
+public:
+    File() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    size_t read(uint8_t *buf, size_t size);
+    size_t readBytes(char *buffer, size_t length) { return read((uint8_t *)buffer, length); }
+    bool seek(uint32_t pos, SeekMode mode);
+    bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+    size_t position() const;
+    size_t size() const;
+    void close();
+    operator bool() const;
+    const char *name() const;
+    const char *fullName() const;
+    bool isFile() const;
+    bool isDirectory() const;
+    File openNextFile();
+    void rewindDirectory();
+    time_t getLastWrite();
+    using Print::write;
+
+private:
+    friend class FS;
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+};
+
+class Dir {
+public:
+    bool next();
+    bool rewind();
+    String fileName();
+    size_t fileSize();
+    bool isFile() const;
+    bool isDirectory() const;
+    File openFile(const char *mode);
+
+private:
+    friend class FS;
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+};
+
+class FS {
+public:
+    FS(const char *(*root)(void)) : _root(root) {}
+
+    bool begin();
+    void end();
+    bool format();
+    bool info(FSInfo &info);
+    File open(const char *path, const char *mode);
+    File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+    Dir openDir(const char *path);
+    Dir openDir(const String &path) { return openDir(path.c_str()); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *pathFrom, const char *pathTo);
+    bool rename(const String &pathFrom, const String &pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool rmdir(const char *path);
+    bool rmdir(const String &path) { return rmdir(path.c_str()); }
+
+    std::string hostPath(const char *path) const;
+
+private:
+    const char *(*_root)(void);
+    bool _mounted = false;
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::Dir;
+using fs::FSInfo;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "FS.h"
+
+// LittleFS is mapped onto nativeLittleFSRoot() (see native_host.h)
+extern fs::FS LittleFS;
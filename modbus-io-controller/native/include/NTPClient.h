@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+#include "WiFiUdp.h"
+
+// NTP client shim, "synchronises" to the host wall clock
+class NTPClient {
+public:
+    NTPClient(UDP &udp) { (void)udp; }
+    NTPClient(UDP &udp, long timeOffset) : _timeOffset(timeOffset) { (void)udp; }
+    NTPClient(UDP &udp, const char *poolServerName) { (void)udp; (void)poolServerName; }
+    NTPClient(UDP &udp, const char *poolServerName, long timeOffset) : _timeOffset(timeOffset) { (void)udp; (void)poolServerName; }
+    NTPClient(UDP &udp, const char *poolServerName, long timeOffset, unsigned long updateInterval)
+        : _timeOffset(timeOffset) { (void)udp; (void)poolServerName; (void)updateInterval; }
+
+    void setPoolServerName(const char *poolServerName) { (void)poolServerName; }
+    void begin() {}
+    void begin(unsigned int port) { (void)port; }
+    bool update() { _timeSet = true; return true; }
+    bool forceUpdate() { return update(); }
+    bool isTimeSet() const { return _timeSet; }
+    void setTimeOffset(int timeOffset) { _timeOffset = timeOffset; }
+    void setUpdateInterval(unsigned long updateInterval) { (void)updateInterval; }
+    unsigned long getEpochTime() const { return (unsigned long)time(nullptr) + _timeOffset; }
+    int getDay() const { return ((getEpochTime() / 86400L) + 4) % 7; }
+    int getHours() const { return (getEpochTime() % 86400L) / 3600; }
+    int getMinutes() const { return (getEpochTime() % 3600) / 60; }
+    int getSeconds() const { return getEpochTime() % 60; }
+    void end() {}
+
+private:
+    long _timeOffset = 0;
+    bool _timeSet = false;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Arduino.h>
+
+// SPI shim, pin assignment only (no devices are attached on the host)
+class SPIClass {
+public:
+    bool setMISO(uint8_t pin) { (void)pin; return true; }
+    bool setMOSI(uint8_t pin) { (void)pin; return true; }
+    bool setSCK(uint8_t pin) { (void)pin; return true; }
+    bool setCS(uint8_t pin) { (void)pin; return true; }
+    bool setRX(uint8_t pin) { return setMISO(pin); }
+    bool setTX(uint8_t pin) { return setMOSI(pin); }
+    void begin(bool hwCS = false) { (void)hwCS; }
+    void end() {}
+    uint8_t transfer(uint8_t data) { (void)data; return 0xFF; }
+};
+
+extern SPIClass SPI;
+extern SPIClass SPI1;
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <fcntl.h>
+#include "FS.h"
+
+// SdFat shim. The card is mapped onto nativeSDRoot() (see native_host.h) and always mounts.
+
+typedef int oflag_t;
+
+#ifndef O_READ
+#define O_READ O_RDONLY
+#endif
+#ifndef O_WRITE
+#define O_WRITE O_WRONLY
+#endif
+#ifndef O_AT_END
+#define O_AT_END O_APPEND
+#endif
+
+#define DEDICATED_SPI 1
+#define SHARED_SPI 0
+#define SD_SCK_MHZ(maxMhz) (1000000UL * (maxMhz))
+
+#define FS_DATE(year, month, day) ((year) > 1980 ? ((year) - 1980) << 9 | (month) << 5 | (day) : 1 << 5 | 1)
+#define FS_TIME(hour, minute, second) ((hour) << 11 | (minute) << 5 | (second) >> 1)
+#define FS_YEAR(fatDate) (1980 + ((fatDate) >> 9))
+#define FS_MONTH(fatDate) (((fatDate) >> 5) & 0xF)
+#define FS_DAY(fatDate) ((fatDate) & 0x1F)
+#define FS_HOUR(fatTime) ((fatTime) >> 11)
+#define FS_MINUTE(fatTime) (((fatTime) >> 5) & 0x3F)
+#define FS_SECOND(fatTime) (2 * ((fatTime) & 0x1F))
+
+class SdioConfig {
+public:
+    SdioConfig(uint8_t clkPin = 0, uint8_t cmdPin = 0, uint8_t dat0Pin = 0) { (void)clkPin; (void)cmdPin; (void)dat0Pin; }
+};
+
+class SdSpiConfig {
+public:
+    SdSpiConfig(uint8_t cs, uint8_t opt = SHARED_SPI, uint32_t maxSck = SD_SCK_MHZ(50), SPIClass *port = nullptr) {
+        (void)cs; (void)opt; (void)maxSck; (void)port;
+    }
+};
+
+namespace FsDateTime {
+    extern void (*callback)(uint16_t *date, uint16_t *time);
+    inline void setCallback(void (*dateTime)(uint16_t *date, uint16_t *time)) { callback = dateTime; }
+    inline void clearCallback() { callback = nullptr; }
+}
+
+class SdCardShim {
+public:
+    uint8_t errorCode() const { return 0; }
+    uint32_t sectorCount() const { return 16u * 1024u * 1024u * 2u; } // 16 GB
+};
+
+class FsVolumeShim {
+public:
+    uint32_t bytesPerCluster() const { return 32768; }
+    uint8_t fatType() const { return 64; } // exFAT
+};
+
+class FsFile : public Stream {
+public:
+    bool open(const char *path, oflag_t oflag = O_RDONLY);
+    bool open(FsFile *dir, const char *path, oflag_t oflag = O_RDONLY);
+    bool openNext(FsFile *dir, oflag_t oflag = O_RDONLY);
+    bool close();
+    bool isOpen() const { return (bool)_file; }
+    operator bool() const { return isOpen(); }
+
+    bool isDirectory() const { return _file.isDirectory(); }
+    bool isFile() const { return _file.isFile(); }
+    size_t getName(char *name, size_t len);
+    uint64_t fileSize() const { return _file.size(); }
+    uint64_t size() const { return _file.size(); }
+    uint64_t curPosition() const { return _file.position(); }
+    bool seekSet(uint64_t pos) { return _file.seek(pos, fs::SeekSet); }
+    bool seekEnd(int64_t offset = 0) { return _file.seek(offset, fs::SeekEnd); }
+    bool getModifyDateTime(uint16_t *pdate, uint16_t *ptime);
+    void rewindDirectory() { _file.rewindDirectory(); }
+    bool sync() { _file.flush(); return true; }
+
+    int available() override { return _file.available(); }
+    int read() override { return _file.read(); }
+    int read(void *buf, size_t count) { return (int)_file.read((uint8_t *)buf, count); }
+    int peek() override { return _file.peek(); }
+    void flush() override { _file.flush(); }
+    size_t write(uint8_t c) override { return _file.write(c); }
+    size_t write(const uint8_t *buf, size_t size) override { return _file.write(buf, size); }
+    using Print::write;
+
+private:
+    friend class SdFs;
+    fs::File _file;
+};
+
+class SdFs {
+public:
+    bool begin(SdioConfig config);
+    bool begin(SdSpiConfig config);
+    void end() {}
+
+    SdCardShim *card() { return &_card; }
+    FsVolumeShim *vol() { return &_vol; }
+    uint32_t freeClusterCount() { return 8u * 1024u * 1024u / 32u; } // 8 GB free
+
+    bool exists(const char *path);
+    bool mkdir(const char *path, bool pFlag = true);
+    bool remove(const char *path);
+    bool rename(const char *oldPath, const char *newPath);
+    bool rmdir(const char *path);
+    FsFile open(const char *path, oflag_t oflag = O_RDONLY);
+    FsFile open(const String &path, oflag_t oflag = O_RDONLY) { return open(path.c_str(), oflag); }
+
+private:
+    SdCardShim _card;
+    FsVolumeShim _vol;
+};
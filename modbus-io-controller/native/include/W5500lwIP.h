@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+#include "WiFiUdp.h"
+
+enum wl_status_t {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL,
+    WL_SCAN_COMPLETED,
+    WL_CONNECTED,
+    WL_CONNECT_FAILED,
+    WL_CONNECTION_LOST,
+    WL_DISCONNECTED
+};
+
+enum EthernetLinkStatus {
+    Unknown,
+    LinkON,
+    LinkOFF
+};
+
+// W5500 Ethernet shim. The host network stack is used directly, so the interface is always up
+// and reports a fixed loopback configuration unless a static config has been applied.
+class Wiznet5500lwIP {
+public:
+    Wiznet5500lwIP(int8_t cs = 17, SPIClass &spi = SPI, int8_t intrpin = -1) { (void)cs; (void)spi; (void)intrpin; }
+
+    bool begin(const uint8_t *macAddress = nullptr, uint16_t mtu = 1500) { (void)macAddress; (void)mtu; _up = true; return true; }
+    void end() { _up = false; }
+    bool config(const IPAddress &local, const IPAddress &gateway = IPAddress(), const IPAddress &subnet = IPAddress(), const IPAddress &dns1 = IPAddress()) {
+        _ip = local;
+        _gateway = gateway;
+        _subnet = subnet;
+        _dns = dns1;
+        return true;
+    }
+    void setSPISpeed(int speed) { (void)speed; }
+    void hostname(const char *name) { (void)name; }
+
+    wl_status_t status() { return _up ? WL_CONNECTED : WL_DISCONNECTED; }
+    EthernetLinkStatus linkStatus() { return _up ? LinkON : LinkOFF; }
+    bool connected() { return _up; }
+    IPAddress localIP() { return _ip; }
+    IPAddress subnetMask() { return _subnet; }
+    IPAddress gatewayIP() { return _gateway; }
+    IPAddress dnsIP(int n = 0) { (void)n; return _dns; }
+    uint8_t *macAddress(uint8_t *mac) {
+        static const uint8_t hostMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        memcpy(mac, hostMac, sizeof(hostMac));
+        return mac;
+    }
+
+private:
+    bool _up = false;
+    IPAddress _ip = IPAddress(127, 0, 0, 1);
+    IPAddress _subnet = IPAddress(255, 0, 0, 0);
+    IPAddress _gateway = IPAddress(127, 0, 0, 1);
+    IPAddress _dns = IPAddress(127, 0, 0, 1);
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "WiFiServer.h"
+
+// HTTP server shim covering the subset of the Arduino-Pico WebServer API used by the firmware.
+// One request is handled per connection (Connection: close) and request data is accumulated
+// across handleClient() calls so the loop never blocks on a slow client.
+
+enum HTTPMethod {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+enum HTTPUploadStatus {
+    UPLOAD_FILE_START,
+    UPLOAD_FILE_WRITE,
+    UPLOAD_FILE_END,
+    UPLOAD_FILE_ABORTED
+};
+
+#ifndef HTTP_UPLOAD_BUFLEN
+#define HTTP_UPLOAD_BUFLEN 1436
+#endif
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) - 1)
+#define CONTENT_LENGTH_NOT_SET ((size_t) - 2)
+
+struct HTTPUpload {
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;
+    size_t currentSize;
+    uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80) : _port(port), _listener(port) {}
+
+    void begin();
+    void begin(uint16_t port);
+    void close();
+    void stop() { close(); }
+    void handleClient();
+
+    void on(const String &uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn) { on(uri, method, fn, nullptr); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void onNotFound(THandlerFunction fn) { _notFoundHandler = fn; }
+    void onFileUpload(THandlerFunction fn) { _fileUploadHandler = fn; }
+
+    String uri() const { return _currentUri; }
+    HTTPMethod method() const { return _currentMethod; }
+    WiFiClient client() { return _currentClient; }
+    HTTPUpload &upload() { return _upload; }
+
+    String arg(const String &name) const;
+    String arg(int i) const;
+    String argName(int i) const;
+    int args() const { return (int)_args.size(); }
+    bool hasArg(const String &name) const;
+    void collectHeaders(const char *headerKeys[], const size_t headerKeysCount) { (void)headerKeys; (void)headerKeysCount; }
+    String header(const String &name) const;
+    String header(int i) const;
+    String headerName(int i) const;
+    int headers() const { return (int)_headers.size(); }
+    bool hasHeader(const String &name) const;
+    String hostHeader() const { return header("Host"); }
+
+    void send(int code, const char *content_type = nullptr, const String &content = String(""));
+    void send(int code, const String &content_type, const String &content) { send(code, content_type.c_str(), content); }
+    void send(int code, const char *content_type, const char *content) { send(code, content_type, String(content)); }
+    void send_P(int code, const char *content_type, const char *content) { send(code, content_type, String(content)); }
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void setContentLength(const size_t contentLength) { _contentLength = contentLength; }
+    void sendContent(const String &content);
+    void sendContent(const char *content, size_t size);
+
+    template<typename T>
+    size_t streamFile(T &file, const String &contentType, int code = 200) {
+        // As on target, a .gz file is sent as the gzip encoding of its content type
+        String name(file.name());
+        if (name.endsWith(".gz") && contentType != "application/x-gzip" && contentType != "application/octet-stream") {
+            sendHeader("Content-Encoding", "gzip");
+        }
+        setContentLength(file.size());
+        send(code, contentType, "");
+        uint8_t buf[1024];
+        size_t sent = 0;
+        while (file.available()) {
+            int n = file.read(buf, sizeof(buf));
+            if (n <= 0) break;
+            if (_currentClient.write(buf, n) != (size_t)n) break;
+            sent += n;
+        }
+        return sent;
+    }
+
+private:
+    struct Handler {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+        THandlerFunction ufn;
+    };
+    struct Pair {
+        String name;
+        String value;
+    };
+
+    bool _parseRequest();
+    void _parseArgs(const String &data);
+    void _parseMultipart(const String &boundary, const std::string &body, Handler *handler);
+    void _dispatch();
+    void _finishClient();
+
+    int _port;
+    WiFiServer _listener;
+    std::vector<Handler> _handlers;
+    THandlerFunction _notFoundHandler;
+    THandlerFunction _fileUploadHandler;
+
+    WiFiClient _currentClient;
+    std::string _rxBuffer;
+    uint32_t _clientStart = 0;
+    String _currentUri;
+    HTTPMethod _currentMethod = HTTP_ANY;
+    std::vector<Pair> _args;
+    std::vector<Pair> _headers;
+    std::vector<Pair> _responseHeaders;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool _headersSent = false;
+    bool _chunked = false;          // Content length unknown, sendContent() writes chunks
+    HTTPUpload _upload;
+};
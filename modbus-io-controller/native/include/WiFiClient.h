@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+// TCP client shim backed by a non-blocking POSIX socket. Copies share the same connection, as
+// with the lwIP client on target.
+class WiFiClient : public Stream {
+public:
+    WiFiClient();
+    explicit WiFiClient(int fd);
+
+    int connect(IPAddress ip, uint16_t port);
+    int connect(const char *host, uint16_t port);
+    uint8_t connected();
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size);
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int availableForWrite() override;
+    void flush() override;
+    void stop();
+    void setNoDelay(bool nodelay);
+    IPAddress remoteIP();
+    uint16_t remotePort();
+    IPAddress localIP();
+    uint16_t localPort();
+    operator bool();
+    bool operator==(const WiFiClient &other) const { return _ctx == other._ctx; }
+    bool operator!=(const WiFiClient &other) const { return _ctx != other._ctx; }
+    using Print::write;
+
+private:
+    struct Context;
+    std::shared_ptr<Context> _ctx;
+
+    void _fill();
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+// TCP listener shim. The listen port is offset by nativePortOffset() so the firmware can run
+// without root privileges.
+class WiFiServer {
+public:
+    WiFiServer(uint16_t port = 23) : _port(port) {}
+    WiFiServer(const IPAddress &addr, uint16_t port) : _port(port) { (void)addr; }
+    ~WiFiServer() { stop(); }
+
+    void begin() { begin(_port); }
+    void begin(uint16_t port, int backlog = 5);
+    void stop();
+    void close() { stop(); }
+    bool hasClient();
+    WiFiClient accept();
+    WiFiClient available() { return accept(); }
+    void setNoDelay(bool nodelay) { _noDelay = nodelay; }
+    uint8_t status() { return _fd >= 0 ? 1 : 0; }
+    uint16_t port() const { return _port; }
+
+private:
+    uint16_t _port;
+    int _fd = -1;
+    bool _noDelay = false;
+};
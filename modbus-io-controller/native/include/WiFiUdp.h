@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Minimal UDP interface used by NTPClient
+class UDP : public Stream {
+public:
+    virtual uint8_t begin(uint16_t port) = 0;
+    virtual void stop() = 0;
+    virtual int beginPacket(IPAddress ip, uint16_t port) = 0;
+    virtual int beginPacket(const char *host, uint16_t port) = 0;
+    virtual int endPacket() = 0;
+    virtual int parsePacket() = 0;
+    virtual int read(unsigned char *buffer, size_t len) = 0;
+    using Stream::read;
+};
+
+// UDP shim that never receives anything (no network access from the native build)
+class WiFiUDP : public UDP {
+public:
+    uint8_t begin(uint16_t port) override { (void)port; return 1; }
+    void stop() override {}
+    int beginPacket(IPAddress ip, uint16_t port) override { (void)ip; (void)port; return 1; }
+    int beginPacket(const char *host, uint16_t port) override { (void)host; (void)port; return 1; }
+    int endPacket() override { return 0; }
+    int parsePacket() override { return 0; }
+    int read(unsigned char *buffer, size_t len) override { (void)buffer; (void)len; return 0; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t c) override { (void)c; return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { (void)buffer; return size; }
+    using Print::write;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+// I2C shim with no devices on the bus. Every transmission is NACKed, so drivers see the device
+// as absent (e.g. the MCP79410 RTC falls back to its error path).
+class TwoWire : public Stream {
+public:
+    bool setSDA(uint8_t pin) { (void)pin; return true; }
+    bool setSCL(uint8_t pin) { (void)pin; return true; }
+    void setClock(uint32_t freq) { (void)freq; }
+    void begin() {}
+    void begin(uint8_t address) { (void)address; }
+    void end() {}
+
+    void beginTransmission(uint8_t address) { (void)address; }
+    uint8_t endTransmission(bool stopBit = true) { (void)stopBit; return 2; } // Address NACK
+    size_t requestFrom(uint8_t address, size_t quantity, bool stopBit = true) { (void)address; (void)quantity; (void)stopBit; return 0; }
+
+    size_t write(uint8_t c) override { (void)c; return 1; }
+    size_t write(const uint8_t *data, size_t quantity) override { (void)data; return quantity; }
+    size_t write(unsigned long n) { return write((uint8_t)n); }
+    size_t write(long n) { return write((uint8_t)n); }
+    size_t write(unsigned int n) { return write((uint8_t)n); }
+    size_t write(int n) { return write((uint8_t)n); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    using Print::write;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,53 @@
+#pragma once
+
+// Host-side controls for the native shim layer. Firmware sources never include this file, it is
+// used by the native entry point and by host tools (simulators, benchmarks) to drive the shims.
+
+#include <Arduino.h>
+
+// Clock -------------------------------------------------------------------->
+// By default millis()/micros() follow the host monotonic clock. In virtual mode time only moves
+// when advanced by the host (or by delay()), which makes simulations deterministic.
+void nativeUseVirtualClock(bool enable);
+bool nativeVirtualClock(void);
+void nativeAdvanceMicros(uint64_t us);
+void nativeSetMicros(uint64_t us);
+
+// Local clock for running emulated firmware (e.g. a simulated slave) inside a host step. Between
+// begin and end the calling thread sees its own clock that advances 1 us per read, so busy-wait
+// loops terminate without moving global time. End returns the emulated execution time in us.
+void nativeBeginLocalClock(void);
+uint64_t nativeEndLocalClock(void);
+
+// Console ------------------------------------------------------------------>
+// Discard Serial (stdout) output from the calling thread, used to silence emulated firmware.
+// Returns the previous state so nested users can restore it.
+bool nativeMuteConsole(bool mute);
+
+// RS485 -------------------------------------------------------------------->
+// The firmware's ModbusRTUTransportRP2040 instances talk to the transport attached to their UART
+// (0 or 1), e.g. an RS485BusSim. With nothing attached the line is dead and requests time out.
+class ModbusRTUTransport;
+void nativeAttachRS485(uint8_t uart, ModbusRTUTransport *transport);
+
+// GPIO --------------------------------------------------------------------->
+int nativeGetPin(uint8_t pin);
+void nativeSetPin(uint8_t pin, int value);
+void nativeSetAnalog(uint8_t pin, int value);
+
+// Filesystems -------------------------------------------------------------->
+// LittleFS and the SD card are mapped onto host directories. Defaults can be overridden with the
+// NATIVE_LITTLEFS_ROOT and NATIVE_SD_ROOT environment variables.
+#define NATIVE_LITTLEFS_ROOT_DEFAULT "native_fs/littlefs"
+#define NATIVE_SD_ROOT_DEFAULT "native_fs/sd"
+
+void nativeSetLittleFSRoot(const char *path);
+void nativeSetSDRoot(const char *path);
+const char *nativeLittleFSRoot(void);
+const char *nativeSDRoot(void);
+bool nativeMakeDirs(const char *path);
+
+// Network ------------------------------------------------------------------>
+// Port offset added to every WiFiServer/WebServer listen port so the firmware can run as an
+// unprivileged user (port 80 -> 8080, 502 -> 8502). Set with NATIVE_PORT_OFFSET.
+uint16_t nativePortOffset(void);
@@ -0,0 +1,255 @@
+#include <Arduino.h>
+#include "native_host.h"
+#include "RS485BusSim.h"
+#include "sys_init.h"
+#include "io_core/board_config.h"
+#include "io_core/board_status.h"
+
+#include <filesystem>
+#include <string>
+#include <time.h>
+
+// Live telemetry encoding benchmark. Polls simulated boards until every board's registers are
+// published, then compares the JSON and binary forms of /api/live and /api/status/tc. Prints one
+// JSON object per endpoint on stdout:
+//
+//   body_bytes            response body size
+//   encode_ns             host CPU time for one call of the encoder behind the endpoint
+//   served_cpu_ns         host CPU time in WebServer::handleClient() per request served to a
+//                         loopback client (accept, parse, encode, send, close)
+//   requests_per_s        requests served per host second (server and client share the thread)
+//
+// The encoder figures isolate the serialisation, the served figures are dominated by socket
+// system calls on the host.
+
+struct liveBenchOptions_t {
+    const char *endpoint = "all";
+    uint32_t seconds = 3;           // Host time serving each endpoint
+    uint8_t boards = MAX_BOARDS;
+    uint16_t port = 2080;           // Before the native port offset
+};
+
+enum liveBenchEncoder_t {
+    LIVE_JSON,
+    LIVE_BINARY,
+    TC_JSON,
+    TC_BINARY,
+};
+
+struct liveBenchEndpoint_t {
+    const char *name;
+    const char *path;
+    liveBenchEncoder_t encoder;
+};
+
+static const liveBenchEndpoint_t endpoints[] = {
+    {"live",        "/api/live",                    LIVE_JSON},
+    {"live_bin",    "/api/live?format=bin",         LIVE_BINARY},
+    {"tc",          "/api/status/tc?id=0",          TC_JSON},
+    {"tc_bin",      "/api/status/tc?id=0&format=bin", TC_BINARY},
+};
+
+static uint64_t threadCpuNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t hostNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Setup -------------------------------------------------------------------->
+static void configureBoards(const liveBenchOptions_t &opt) {
+    memset(boardConfigs, 0, sizeof(boardConfigs));
+    boardCount = opt.boards;
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        BoardConfig &cfg = boardConfigs[i];
+        snprintf(cfg.boardName, sizeof(cfg.boardName), "Bench %d", i);
+        cfg.type = THERMOCOUPLE_IO;
+        cfg.boardIndex = i;
+        cfg.modbusPort = i & 1;
+        cfg.slaveID = i / 2 + 1;
+        cfg.pollTime = MIN_POLL_TIME;
+        cfg.recordInterval = 60000;
+        cfg.initialised = true;
+    }
+}
+
+// Run the poller under the virtual clock until every board has been read at least once
+static bool publishBoards(const liveBenchOptions_t &opt) {
+    uint64_t end = time_us_64() + 5000000;
+    while (time_us_64() < end) {
+        manage_io_core();
+        nativeAdvanceMicros(10);
+        bool ready = true;
+        for (uint8_t i = 0; i < opt.boards; i++) {
+            thermocoupleSnapshot_t snapshot;
+            if (!thermocoupleIO_index.tcIO[i].configInitialised || !thermocouple_read_snapshot(i, &snapshot)) ready = false;
+            if (!boardConfigs[i].connected) ready = false; // /api/status/tc answers connected boards only
+        }
+        if (ready) return true;
+    }
+    return false;
+}
+
+// Endpoint run ------------------------------------------------------------->
+static size_t encode(liveBenchEncoder_t encoder) {
+    static uint8_t buffer[4096];
+    const char *data;
+    JsonStream json(server);    // Not begun, the body fits the stream's buffer and is never sent
+    switch (encoder) {
+        case LIVE_JSON:     return encode_live_json(&data);
+        case LIVE_BINARY:   return encode_live_binary(buffer, sizeof(buffer));
+        case TC_JSON:       return encode_thermocouple_json(0, json);
+        case TC_BINARY:     return encode_thermocouple_binary(0, buffer, sizeof(buffer));
+    }
+    return 0;
+}
+
+// Call the encoder for a second of CPU time, returns CPU ns per call
+static double encodeNs(liveBenchEncoder_t encoder) {
+    uint64_t calls = 0;
+    uint64_t start = threadCpuNs();
+    uint64_t elapsed = 0;
+    while (elapsed < 1000000000ULL) {
+        for (uint32_t i = 0; i < 256; i++, calls++) encode(encoder);
+        elapsed = threadCpuNs() - start;
+    }
+    return (double)elapsed / calls;
+}
+
+// One GET to the server, returns the response size (headers and body) or 0 on failure
+static size_t serveRequest(const liveBenchEndpoint_t &endpoint, const liveBenchOptions_t &opt, uint64_t &cpuTotal) {
+    WiFiClient client;
+    if (!client.connect("127.0.0.1", opt.port + nativePortOffset())) return 0;
+    char request[128];
+    int length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: bench\r\n\r\n", endpoint.path);
+    client.write((const uint8_t *)request, length);
+
+    uint8_t rx[4096];
+    size_t received = 0;
+    uint64_t start = hostNs();
+    while (client.connected() && hostNs() - start < 1000000000ULL) {
+        uint64_t cpu = threadCpuNs();
+        server.handleClient();
+        cpuTotal += threadCpuNs() - cpu;
+        int count = client.read(rx, sizeof(rx));
+        if (count > 0) received += count;
+    }
+    client.stop();
+    return received;
+}
+
+static void runEndpoint(const liveBenchEndpoint_t &endpoint, const liveBenchOptions_t &opt) {
+    size_t bodyBytes = encode(endpoint.encoder);
+    double encodeTime = encodeNs(endpoint.encoder);
+
+    uint64_t requests = 0;
+    uint64_t responseBytes = 0;
+    uint64_t cpuTotal = 0;
+    uint64_t start = hostNs();
+    uint64_t end = start + (uint64_t)opt.seconds * 1000000000ULL;
+    while (hostNs() < end) {
+        size_t received = serveRequest(endpoint, opt, cpuTotal);
+        if (!received) break;
+        responseBytes += received;
+        requests++;
+    }
+
+    double seconds = (double)(hostNs() - start) / 1e9;
+    printf("{\"endpoint\":\"%s\",\"path\":\"%s\",\"boards\":%u,\"body_bytes\":%zu,\"encode_ns\":%.0f,"
+           "\"requests\":%llu,\"response_bytes\":%.0f,\"served_cpu_ns\":%.0f,\"requests_per_s\":%.0f}\n",
+           endpoint.name, endpoint.path, opt.boards, bodyBytes, encodeTime, (unsigned long long)requests,
+           requests ? (double)responseBytes / requests : 0.0, requests ? (double)cpuTotal / requests : 0.0,
+           requests / seconds);
+    fflush(stdout);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--endpoint all|live|live_bin|tc|tc_bin] [--seconds N] [--boards N] [--port N]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    // Results go to stdout with printf, firmware logging through Serial is discarded
+    nativeMuteConsole(true);
+
+    liveBenchOptions_t opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (arg == "--endpoint") opt.endpoint = value;
+        else if (arg == "--seconds") opt.seconds = strtoul(value, nullptr, 0);
+        else if (arg == "--boards") opt.boards = (uint8_t)constrain(strtoul(value, nullptr, 0), 1UL, (unsigned long)MAX_BOARDS);
+        else if (arg == "--port") opt.port = strtoul(value, nullptr, 0);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    nativeUseVirtualClock(true);
+    nativeSetMicros(1000000);
+    globalDateTime = epochToDateTime(1767225600); // RTC as if set, record_thermocouple() needs a valid time
+
+    char root[] = "/tmp/modbus-io-live-bench.XXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "[bench] Failed to create temp dir\n");
+        return 1;
+    }
+    std::string littleFSRoot = std::string(root) + "/littlefs";
+    std::string sdRoot = std::string(root) + "/sd";
+    nativeMakeDirs(littleFSRoot.c_str());
+    nativeMakeDirs(sdRoot.c_str());
+    nativeSetLittleFSRoot(littleFSRoot.c_str());
+    nativeSetSDRoot(sdRoot.c_str());
+
+    RS485BusSim *sim[2];
+    for (uint8_t port = 0; port < 2; port++) {
+        rs485SimConfig_t simConfig;
+        simConfig.seed = port + 1;
+        sim[port] = new RS485BusSim(simConfig);
+    }
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        sim[i & 1]->addBoard(new ThermocoupleBoardSim(i / 2 + 1));
+    }
+    nativeAttachRS485(0, sim[0]);
+    nativeAttachRS485(1, sim[1]);
+    bus1.begin(500000);
+    bus2.begin(500000);
+
+    configureBoards(opt);
+    apply_board_configs();
+    int result = 0;
+    if (!publishBoards(opt)) {
+        fprintf(stderr, "[bench] Boards were not published\n");
+        result = 1;
+    }
+
+    if (result == 0) {
+        setupBoardStatusAPI();
+        server.begin(opt.port);
+        bool found = false;
+        for (const auto &endpoint : endpoints) {
+            if (strcmp(opt.endpoint, "all") != 0 && strcmp(opt.endpoint, endpoint.name) != 0) continue;
+            found = true;
+            runEndpoint(endpoint, opt);
+        }
+        if (!found) {
+            usage(argv[0]);
+            result = 2;
+        }
+        server.stop();
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return result;
+}
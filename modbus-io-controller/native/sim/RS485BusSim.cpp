@@ -0,0 +1,188 @@
+#include "RS485BusSim.h"
+#include <time.h>
+
+static uint64_t threadCpuNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t bitsPerChar(uint16_t config) {
+    if (config == SERIAL_8E2 || config == SERIAL_8O2) return 12;
+    if (config == SERIAL_8N2 || config == SERIAL_8E1 || config == SERIAL_8O1) return 11;
+    return 10;
+}
+
+RS485BusSim::RS485BusSim(const rs485SimConfig_t &config) {
+    setConfig(config);
+    _masterBaud = config.baud;
+    _masterConfig = config.config;
+    _stats.startUs = time_us_64();
+}
+
+void RS485BusSim::setConfig(const rs485SimConfig_t &config) {
+    _config = config;
+    _rng = config.seed ? config.seed : 1;
+    _charNs = (uint64_t)bitsPerChar(config.config) * 1000000000ULL / config.baud;
+}
+
+void RS485BusSim::resetStats() {
+    _stats = rs485SimStats_t();
+    _stats.startUs = time_us_64();
+    for (auto *board : _boards) board->resetStats();
+}
+
+float RS485BusSim::utilisation() {
+    _service();
+    uint64_t elapsed = time_us_64() - _stats.startUs;
+    return elapsed ? (float)_stats.busyUs / (float)elapsed : 0.0f;
+}
+
+// Master side -------------------------------------------------------------->
+void RS485BusSim::begin(unsigned long baud, uint32_t config) {
+    _masterBaud = baud;
+    _masterConfig = (uint16_t)config;
+    _rx.clear();
+}
+
+int RS485BusSim::available() {
+    _service();
+    uint64_t now = _nowNs();
+    int count = 0;
+    for (const auto &b : _rx) {
+        if (b.dueNs > now) break;
+        count++;
+    }
+    return count;
+}
+
+uint16_t RS485BusSim::read(uint8_t *buf, uint16_t len) {
+    _service();
+    uint64_t now = _nowNs();
+    uint16_t count = 0;
+    while (count < len && !_rx.empty() && _rx.front().dueNs <= now) {
+        _lastRxNs = _rx.front().dueNs;
+        buf[count++] = _rx.front().value;
+        _rx.pop_front();
+    }
+    return count;
+}
+
+void RS485BusSim::discard() {
+    // Bytes still in flight on the line are not affected
+    _service();
+    uint64_t now = _nowNs();
+    while (!_rx.empty() && _rx.front().dueNs <= now) {
+        _lastRxNs = _rx.front().dueNs;
+        _rx.pop_front();
+    }
+}
+
+bool RS485BusSim::sending() {
+    _service();
+    return _requestPending;
+}
+
+bool RS485BusSim::send(const uint8_t *frame, uint16_t len) {
+    if (!len || sending()) return false;
+
+    uint64_t start = max(_nowNs(), _lineFreeNs);
+    uint64_t duration = len * _charNs;
+    _lineFreeNs = start + duration;
+    _stats.busyUs += duration / 1000;
+    _stats.txBytes += len;
+    _stats.requests++;
+    if (frame[0] == 0) _stats.broadcasts++;
+
+    _request.assign(frame, frame + len);
+    _requestEndNs = _lineFreeNs;
+    _requestPending = true;
+    return true;
+}
+
+// Bus model ---------------------------------------------------------------->
+void RS485BusSim::_service() {
+    if (_requestPending && _nowNs() >= _requestEndNs) {
+        _requestPending = false;
+        _deliver(_request, _requestEndNs);
+    }
+}
+
+void RS485BusSim::_deliver(std::vector<uint8_t> &frame, uint64_t endNs) {
+    bool unicast = frame[0] != 0;
+
+    // A master running at a different line speed is just noise to the boards
+    if (_masterBaud != _config.baud || _masterConfig != _config.config) {
+        _stats.corruptedBytes += frame.size();
+        if (unicast) _stats.unanswered++;
+        return;
+    }
+    if (_chance(_config.dropRate)) {
+        _stats.droppedFrames++;
+        if (unicast) _stats.unanswered++;
+        return;
+    }
+    _corrupt(frame);
+
+    std::vector<uint8_t> response;
+    std::vector<uint8_t> merged;
+    uint32_t processingUs = 0;
+    uint32_t latestUs = 0;
+    int responders = 0;
+    uint64_t cpuStart = threadCpuNs();
+    for (auto *board : _boards) {
+        if (!board->process(frame.data(), frame.size(), endNs / 1000, response, processingUs)) continue;
+        if (responders++ == 0) {
+            merged = response;
+        } else {
+            // Two drivers on the line, the result is garbage
+            _stats.collisions++;
+            if (response.size() > merged.size()) merged.resize(response.size(), 0xFF);
+            for (size_t i = 0; i < response.size(); i++) merged[i] &= response[i];
+        }
+        latestUs = max(latestUs, processingUs);
+    }
+    _stats.hostCpuNs += threadCpuNs() - cpuStart;
+    if (!responders) {
+        if (unicast) _stats.unanswered++;
+        return;
+    }
+    if (_chance(_config.dropRate)) {
+        _stats.droppedFrames++;
+        return;
+    }
+    _corrupt(merged);
+
+    uint64_t start = max(endNs + ((uint64_t)latestUs + _config.turnaroundUs) * 1000, _lineFreeNs);
+    for (size_t i = 0; i < merged.size(); i++) {
+        _rx.push_back({start + (i + 1) * _charNs, merged[i]});
+    }
+    uint64_t duration = merged.size() * _charNs;
+    _lineFreeNs = start + duration;
+    _stats.busyUs += duration / 1000;
+    _stats.rxBytes += merged.size();
+    _stats.responses++;
+}
+
+void RS485BusSim::_corrupt(std::vector<uint8_t> &frame) {
+    if (_config.bitErrorRate <= 0.0f) return;
+    for (auto &b : frame) {
+        if (_chance(_config.bitErrorRate)) {
+            b ^= (uint8_t)(1u << (_random() & 7));
+            _stats.corruptedBytes++;
+        }
+    }
+}
+
+bool RS485BusSim::_chance(float probability) {
+    if (probability <= 0.0f) return false;
+    return (_random() >> 8) < (uint32_t)(probability * (float)(1u << 24));
+}
+
+// xorshift32
+uint32_t RS485BusSim::_random() {
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
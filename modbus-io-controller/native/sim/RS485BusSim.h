@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ModbusRTUTransport.h>
+#include <deque>
+#include <vector>
+#include "ThermocoupleBoardSim.h"
+
+// Deterministic half-duplex RS485 bus model. The master side is a ModbusRTUTransport, so it can be
+// handed to ModbusRTUMaster directly or attached behind the firmware's RP2040 UART transports
+// (nativeAttachRS485).
+//
+// Timing is derived from micros(): every send() from the master is one request frame that
+// occupies the line for length * char time, sending() stays true until it has left the master. When it has fully arrived the addressed boards
+// process it, and response bytes become readable one char time apart starting after the board's
+// emulated processing time plus the configured turnaround delay. The model is evaluated lazily
+// whenever the master touches the port, so it needs no thread and works with the real or the
+// virtual clock. Line errors use a seeded PRNG, the same seed gives the same run.
+
+struct rs485SimConfig_t {
+    uint32_t baud = 500000;         // Line speed of the boards
+    uint16_t config = SERIAL_8N1;
+    uint32_t turnaroundUs = 50;     // Transceiver turnaround added before every response
+    float bitErrorRate = 0.0f;      // Probability that a transmitted byte has one bit flipped
+    float dropRate = 0.0f;          // Probability that a frame is lost on the wire
+    uint32_t seed = 1;
+};
+
+struct rs485SimStats_t {
+    uint32_t requests = 0;          // Frames sent by the master
+    uint32_t broadcasts = 0;
+    uint32_t responses = 0;         // Frames sent by boards
+    uint32_t unanswered = 0;        // Unicast requests that got no response
+    uint32_t droppedFrames = 0;
+    uint32_t corruptedBytes = 0;
+    uint32_t collisions = 0;        // More than one board answered
+    uint64_t txBytes = 0;           // Master to boards
+    uint64_t rxBytes = 0;           // Boards to master
+    uint64_t busyUs = 0;            // Time the line was driven
+    uint64_t startUs = 0;
+    uint64_t hostCpuNs = 0;         // Host CPU time spent emulating the boards
+};
+
+class RS485BusSim : public ModbusRTUTransport {
+public:
+    RS485BusSim(const rs485SimConfig_t &config = rs485SimConfig_t());
+
+    void addBoard(ThermocoupleBoardSim *board) { _boards.push_back(board); }
+    void clearBoards() { _boards.clear(); }
+    ThermocoupleBoardSim *board(size_t i) { return i < _boards.size() ? _boards[i] : nullptr; }
+    size_t boardCount() const { return _boards.size(); }
+
+    const rs485SimConfig_t &config() const { return _config; }
+    void setConfig(const rs485SimConfig_t &config);
+    const rs485SimStats_t &stats() const { return _stats; }
+    void resetStats();
+    float utilisation();            // Fraction of time since resetStats() the line was busy
+
+    // Master side
+    void begin(unsigned long baud, uint32_t config) override;
+    bool send(const uint8_t *frame, uint16_t len) override;
+    bool sending() override;
+    int available() override;
+    uint16_t read(uint8_t *buf, uint16_t len) override;
+    uint32_t lastRxMicros() override { return (uint32_t)(_lastRxNs / 1000); }
+    void discard() override;
+
+private:
+    struct rxByte_t {
+        uint64_t dueNs;
+        uint8_t value;
+    };
+
+    void _service();
+    void _deliver(std::vector<uint8_t> &frame, uint64_t endNs);
+    bool _chance(float probability);
+    void _corrupt(std::vector<uint8_t> &frame);
+    uint32_t _random();
+    uint64_t _nowNs() { return time_us_64() * 1000; }
+
+    rs485SimConfig_t _config;
+    rs485SimStats_t _stats;
+    std::vector<ThermocoupleBoardSim *> _boards;
+    unsigned long _masterBaud;
+    uint16_t _masterConfig;
+    uint64_t _charNs;
+    uint64_t _lineFreeNs = 0;
+    uint32_t _rng;
+
+    std::vector<uint8_t> _request;
+    uint64_t _requestEndNs = 0;
+    bool _requestPending = false;
+    std::deque<rxByte_t> _rx;
+    uint64_t _lastRxNs = 0;         // End of the last byte taken by the master
+};
@@ -0,0 +1,221 @@
+#include "ThermocoupleBoardSim.h"
+#include "native_host.h"
+
+static_assert(sizeof(bool) == 1, "register map requires 1 byte bools");
+
+#define SIM_TC_BOARD_TYPE 2
+#define SIM_TC_LATCH_RESET_PTR 32
+#define SIM_TC_SNAPSHOT_REG_PTR 48
+
+int SimBoardPort::read() {
+    if (_rx.empty()) return -1;
+    uint8_t c = _rx.front();
+    _rx.pop_front();
+    return c;
+}
+
+ThermocoupleBoardSim::ThermocoupleBoardSim(uint8_t slaveID, const char *name) : _slave(_port) {
+    static_assert(sizeof(modbus_holding_t) == 42 * 2, "holding register map mismatch");
+    static_assert(sizeof(modbus_snapshot_t) == 52 * 2, "snapshot register map mismatch");
+    static_assert(sizeof(modbus_coil_t) == 40 && sizeof(modbus_discrete_t) == 32, "coil map mismatch");
+
+    _rng = 0x9E3779B9u ^ (slaveID * 2654435761u);
+    memset(&_coils, 0, sizeof(_coils));
+    memset(&_flags, 0, sizeof(_flags));
+    memset(&_holding, 0, sizeof(_holding));
+    memset(&_input, 0, sizeof(_input));
+    memset(&_snapshot, 0, sizeof(_snapshot));
+
+    // Firmware defaults (tc_config_t)
+    _holding.boardType = SIM_TC_BOARD_TYPE;
+    _holding.slaveID = slaveID;
+    strncpy(_holding.boardName, name, sizeof(_holding.boardName) - 1);
+    for (int i = 0; i < SIM_TC_CHANNELS; i++) {
+        _holding.type[i] = 0;
+        _holding.alertSP[i] = 200.0f;
+        _holding.alertHyst[i] = 5;
+        _coils.alertEnable[i] = true;
+        _coils.outputEnable[i] = true;
+        _channels[i].base = 20.0f + 5.0f * i;
+        _channels[i].amplitude = 2.0f;
+        _channels[i].periodMs = 60000 + 1000 * (slaveID % 16);
+    }
+    memcpy(_holdingReg, &_holding, sizeof(_holdingReg));
+    memcpy(_coilReg, &_coils, sizeof(_coilReg));
+    memset(_discreteReg, 0, sizeof(_discreteReg));
+    memset(_inputReg, 0, sizeof(_inputReg));
+
+    _slave.configureCoils(_coilReg, 40);
+    _slave.configureDiscreteInputs(_discreteReg, 32);
+    _slave.configureHoldingRegisters(_holdingReg, 42);
+    _slave.configureInputRegisters(_inputReg, 100);
+    _beginSlave(slaveID);
+}
+
+void ThermocoupleBoardSim::_beginSlave(uint8_t id) {
+    nativeBeginLocalClock();
+    _slave.begin(id, SIM_TC_BAUD);
+    nativeEndLocalClock();
+}
+
+void ThermocoupleBoardSim::setLegacyFirmware(bool legacy) {
+    _legacy = legacy;
+    _slave.configureInputRegisters(_inputReg, legacy ? SIM_TC_SNAPSHOT_REG_PTR : 100);
+}
+
+void ThermocoupleBoardSim::setConversionTime(uint32_t conversionUs, uint32_t phaseUs) {
+    _conversionUs = conversionUs;
+    _conversionPhaseUs = conversionUs ? phaseUs % conversionUs : 0;
+}
+
+uint64_t ThermocoupleBoardSim::sampleTime(const float *temperature) const {
+    for (const simSample_t &sample : _samples) {
+        if (memcmp(sample.temperature, temperature, sizeof(sample.temperature)) == 0) return sample.timeUs;
+    }
+    return 0;
+}
+
+void ThermocoupleBoardSim::pressAddressButton() {
+    _holding.slaveID = SIM_TC_UNCONFIGURED_ID;
+    _holdingReg[9] = SIM_TC_UNCONFIGURED_ID;
+    _beginSlave(SIM_TC_UNCONFIGURED_ID);
+}
+
+// Request handling --------------------------------------------------------->
+bool ThermocoupleBoardSim::process(const uint8_t *frame, size_t length, uint64_t nowUs, std::vector<uint8_t> &response, uint32_t &processingUs) {
+    response.clear();
+    processingUs = 0;
+    if (!_online || length < 4) return false;
+    if (frame[0] != 0 && frame[0] != _holding.slaveID) return false;
+    _stats.requests++;
+
+    // Firmware loop: readAll() and handleStatus() run before the bus is polled
+    _readAll(nowUs);
+    _handleStatus();
+
+    _port.clear();
+    _port.inject(frame, length);
+    bool muted = nativeMuteConsole(true);
+    nativeBeginLocalClock();
+    int fc = _slave.poll();
+    processingUs = (uint32_t)nativeEndLocalClock();
+    nativeMuteConsole(muted);
+
+    if (_loopTimeUs > 0) {
+        _rng ^= _rng << 13;
+        _rng ^= _rng >> 17;
+        _rng ^= _rng << 5;
+        processingUs += _rng % _loopTimeUs;
+    }
+
+    if (fc > 0) _applyWrites(fc);
+    _port.drain(response);
+    if (response.empty()) return false;
+    _stats.responses++;
+    if (response.size() >= 2 && (response[1] & 0x80)) _stats.exceptions++;
+    return true;
+}
+
+void ThermocoupleBoardSim::_readAll(uint64_t nowUs) {
+    // The data read is that of the last finished conversion
+    uint64_t sampleUs = nowUs;
+    if (_conversionUs && nowUs >= _conversionUs) sampleUs -= (nowUs + _conversionUs - _conversionPhaseUs) % _conversionUs;
+    float t = (float)(sampleUs / 1000);
+    float cj = 25.0f + 0.5f * sinf(2.0f * (float)M_PI * t / 600000.0f);
+    for (int i = 0; i < SIM_TC_CHANNELS; i++) {
+        const simChannel_t &ch = _channels[i];
+        float phase = 2.0f * (float)M_PI * (fmodf(t, (float)ch.periodMs) / (float)ch.periodMs);
+        float temp = ch.base + ch.amplitude * sinf(phase + i);
+        if (ch.openCircuit || ch.shortCircuit) temp = 0.0f;
+        _input.temperature[i] = temp;
+        _input.coldJunction[i] = cj;
+        _input.deltaJunction[i] = temp - cj;
+
+        // MCP960x alert 0: setpoint with hysteresis, rising or falling edge, optional latch
+        bool alert = false;
+        if (_coils.alertEnable[i]) {
+            float sp = _holding.alertSP[i];
+            float hyst = _holding.alertHyst[i];
+            bool wasActive = _latched[i] || _flags.alertState[i];
+            if (_coils.alertEdge[i]) alert = wasActive ? temp < sp + hyst : temp <= sp;
+            else alert = wasActive ? temp > sp - hyst : temp >= sp;
+            if (_coils.alertLatch[i]) {
+                _latched[i] = _latched[i] || alert;
+                alert = _latched[i];
+            }
+        }
+        _flags.alertState[i] = alert;
+        _flags.outputState[i] = _coils.outputEnable[i] && alert;
+        _flags.openCircuit[i] = ch.openCircuit;
+        _flags.shortCircuit[i] = ch.shortCircuit;
+    }
+    memcpy(_discreteReg, &_flags, sizeof(_flags));
+    memcpy(_inputReg, &_input, sizeof(_input));
+
+    if (_samples.empty() || _samples.front().timeUs != sampleUs) {
+        simSample_t sample;
+        sample.timeUs = sampleUs;
+        memcpy(sample.temperature, _input.temperature, sizeof(sample.temperature));
+        _samples.push_front(sample);
+        if (_samples.size() > SIM_TC_SAMPLE_HISTORY) _samples.pop_back();
+    }
+
+    _snapshot.status = _holdingReg[0];
+    _snapshot.boardType = _holding.boardType;
+    _snapshot.flags[0] = 0;
+    _snapshot.flags[1] = 0;
+    for (int i = 0; i < 32; i++) {
+        if (_discreteReg[i]) _snapshot.flags[i >> 4] |= (1u << (i & 15));
+    }
+    _snapshot.input = _input;
+    if (!_legacy) memcpy(&_inputReg[SIM_TC_SNAPSHOT_REG_PTR], &_snapshot, sizeof(_snapshot));
+}
+
+void ThermocoupleBoardSim::_handleStatus() {
+    bool psuError = _psuVolts > 30.0f || _psuVolts < 12.0f;
+    uint16_t psuVoltage = (uint16_t)(_psuVolts * 10);
+    _holdingReg[0] = (psuVoltage << 4) | (psuError << 2);
+}
+
+// Mirrors handleModbus() in the thermocouple firmware
+void ThermocoupleBoardSim::_applyWrites(int functionCode) {
+    if (functionCode == MODBUS_FC05_WRITE_SINGLE_COIL || functionCode == MODBUS_FC15_WRITE_MULTIPLE_COILS) {
+        _stats.writes++;
+        modbus_coil_t coilData;
+        memcpy(&coilData, _coilReg, sizeof(coilData));
+        for (int i = 0; i < SIM_TC_CHANNELS; i++) {
+            _coils.outputEnable[i] = coilData.outputEnable[i];
+            _coils.alertEnable[i] = coilData.alertEnable[i];
+            _coils.alertLatch[i] = coilData.alertLatch[i];
+            _coils.alertEdge[i] = coilData.alertEdge[i];
+            if (coilData.resetLatch[i]) {
+                _coilReg[SIM_TC_LATCH_RESET_PTR + i] = false;
+                _latched[i] = false;
+            }
+        }
+    }
+
+    if (functionCode == MODBUS_FC06_WRITE_SINGLE_REGISTER || functionCode == MODBUS_FC16_WRITE_MULTIPLE_REGISTERS) {
+        _stats.writes++;
+        if (_holdingReg[1] != _holding.boardType) _holdingReg[1] = _holding.boardType;
+        modbus_holding_t holdingData;
+        memcpy(&holdingData, _holdingReg, sizeof(holdingData));
+        for (int i = 0; i < SIM_TC_CHANNELS; i++) {
+            if (holdingData.type[i] <= 7) _holding.type[i] = holdingData.type[i];
+            if (holdingData.alertSP[i] < 1500.0f && holdingData.alertSP[i] > -40.0f) _holding.alertSP[i] = holdingData.alertSP[i];
+            _holding.alertHyst[i] = holdingData.alertHyst[i];
+        }
+        if (holdingData.slaveID != _holding.slaveID && holdingData.slaveID > 0) {
+            if (holdingData.slaveID > 244) {
+                _holding.slaveID = SIM_TC_UNCONFIGURED_ID;
+            } else {
+                _holding.slaveID = holdingData.slaveID;
+                _beginSlave((uint8_t)_holding.slaveID);
+            }
+        }
+        if (strlen(holdingData.boardName) > 0) {
+            strncpy(_holding.boardName, holdingData.boardName, sizeof(_holding.boardName));
+            _holding.boardName[sizeof(_holding.boardName) - 1] = '\0';
+        }
+    }
+}
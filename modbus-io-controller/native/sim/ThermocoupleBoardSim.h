@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+#include "ModbusRTUSlave.h"
+
+// Emulated thermocouple IO board. Runs the real ModbusRTUSlave library from the thermocouple
+// firmware against the same register map (sys_init.h) and applies register writes the way the
+// firmware's handleModbus() does. Temperatures come from a deterministic waveform per channel.
+
+#define SIM_TC_CHANNELS 8
+#define SIM_TC_BAUD 500000
+#define SIM_TC_UNCONFIGURED_ID 245
+#define SIM_TC_CONVERSION_US 320000     // MCP960x conversion time at 18-bit resolution (firmware default)
+#define SIM_TC_SAMPLE_HISTORY 64
+
+// Serial endpoint of a single emulated board, fed by the bus simulator
+class SimBoardPort : public HardwareSerial {
+public:
+    using HardwareSerial::begin;
+    void begin(unsigned long baud, uint16_t config) override { _baud = baud; _config = config; }
+    int available() override { return (int)_rx.size(); }
+    int read() override;
+    int peek() override { return _rx.empty() ? -1 : _rx.front(); }
+    size_t write(uint8_t c) override { _tx.push_back(c); return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { _tx.insert(_tx.end(), buffer, buffer + size); return size; }
+    using Print::write;
+
+    void inject(const uint8_t *data, size_t length) { _rx.insert(_rx.end(), data, data + length); }
+    void drain(std::vector<uint8_t> &out) { out.assign(_tx.begin(), _tx.end()); _tx.clear(); }
+    void clear() { _rx.clear(); _tx.clear(); }
+    unsigned long baud() const { return _baud; }
+
+private:
+    std::deque<uint8_t> _rx;
+    std::vector<uint8_t> _tx;
+    unsigned long _baud = 0;
+    uint16_t _config = SERIAL_8N1;
+};
+
+struct simChannel_t {
+    float base = 20.0f;         // Mean temperature (C)
+    float amplitude = 2.0f;     // Peak deviation (C)
+    uint32_t periodMs = 60000;  // Waveform period
+    bool openCircuit = false;
+    bool shortCircuit = false;
+};
+
+struct simBoardStats_t {
+    uint32_t requests = 0;      // Frames addressed to this board
+    uint32_t responses = 0;     // Frames answered (including exceptions)
+    uint32_t exceptions = 0;
+    uint32_t writes = 0;        // FC05/06/15/16 requests applied
+};
+
+class ThermocoupleBoardSim {
+public:
+    ThermocoupleBoardSim(uint8_t slaveID, const char *name = "Sim TC IO");
+
+    // Called by the bus simulator with a complete request frame as seen on the wire. Returns
+    // true with the response frame if the board answered. processingUs is the emulated time the
+    // firmware took between the end of the request and the start of the response.
+    bool process(const uint8_t *frame, size_t length, uint64_t nowUs, std::vector<uint8_t> &response, uint32_t &processingUs);
+
+    uint8_t slaveID() const { return (uint8_t)_holding.slaveID; }
+    const char *name() const { return _holding.boardName; }
+    bool online() const { return _online; }
+    void setOnline(bool online) { _online = online; }
+
+    // Firmware before the snapshot block (input registers 0-47 only)
+    void setLegacyFirmware(bool legacy);
+    bool legacyFirmware() const { return _legacy; }
+
+    // Time spent in the firmware main loop (I2C reads etc.) before the bus is polled. A random
+    // part of it, up to loopTimeUs, is added to every response.
+    void setLoopTime(uint32_t loopTimeUs) { _loopTimeUs = loopTimeUs; }
+
+    // The sensors convert free running every conversionUs, offset by phaseUs, and a read returns
+    // the last finished conversion. 0 (default) samples the waveform on every request.
+    void setConversionTime(uint32_t conversionUs, uint32_t phaseUs = 0);
+
+    // Time of the conversion that produced these temperatures (SIM_TC_CHANNELS floats, as read
+    // from the input registers), 0 if it isn't one of the last SIM_TC_SAMPLE_HISTORY samples
+    uint64_t sampleTime(const float *temperature) const;
+
+    // Hold the address button, board listens on ID 245 until the controller assigns an ID
+    void pressAddressButton();
+
+    simChannel_t &channel(uint8_t ch) { return _channels[ch]; }
+    void setPsuVoltage(float volts) { _psuVolts = volts; }
+    float temperature(uint8_t ch) const { return _input.temperature[ch]; }
+    bool outputEnabled(uint8_t ch) const { return _coils.outputEnable[ch]; }
+    uint16_t thermocoupleType(uint8_t ch) const { return _holding.type[ch]; }
+    const simBoardStats_t &stats() const { return _stats; }
+    void resetStats() { _stats = simBoardStats_t(); }
+
+private:
+    // Register map, identical to the thermocouple firmware (src/sys_init.h)
+    struct modbus_coil_t {
+        bool alertEnable[8];
+        bool outputEnable[8];
+        bool alertLatch[8];
+        bool alertEdge[8];
+        bool resetLatch[8];
+    };
+    struct modbus_discrete_t {
+        bool outputState[8];
+        bool alertState[8];
+        bool openCircuit[8];
+        bool shortCircuit[8];
+    };
+    struct modbus_holding_t {
+        uint16_t status;
+        uint16_t boardType;
+        char boardName[14];
+        uint16_t slaveID;
+        uint16_t type[8];
+        float alertSP[8];
+        uint16_t alertHyst[8];
+    };
+    struct modbus_input_t {
+        float temperature[8];
+        float coldJunction[8];
+        float deltaJunction[8];
+    };
+    struct modbus_snapshot_t {
+        uint16_t status;
+        uint16_t boardType;
+        uint16_t flags[2];
+        modbus_input_t input;
+    };
+
+    void _readAll(uint64_t nowUs);
+    void _handleStatus();
+    void _applyWrites(int functionCode);
+    void _beginSlave(uint8_t id);
+
+    SimBoardPort _port;
+    ModbusRTUSlave _slave;
+    bool _online = true;
+    bool _legacy = false;
+    bool _latched[8] = {false};
+    uint32_t _loopTimeUs = 0;
+    uint32_t _conversionUs = 0;
+    uint32_t _conversionPhaseUs = 0;
+    uint32_t _rng;
+    float _psuVolts = 24.0f;
+    simChannel_t _channels[SIM_TC_CHANNELS];
+    simBoardStats_t _stats;
+
+    struct simSample_t {
+        uint64_t timeUs;
+        float temperature[SIM_TC_CHANNELS];
+    };
+    std::deque<simSample_t> _samples;   // Newest first
+
+    modbus_coil_t _coils;
+    modbus_discrete_t _flags;
+    modbus_holding_t _holding;
+    modbus_input_t _input;
+    modbus_snapshot_t _snapshot;
+
+    bool _coilReg[40];
+    bool _discreteReg[32];
+    uint16_t _inputReg[100];
+    uint16_t _holdingReg[42];
+};
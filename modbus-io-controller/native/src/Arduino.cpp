@@ -0,0 +1,450 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include "native_host.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Object definitions
+SerialUSB Serial;
+SerialUART Serial1(1);
+SerialUART Serial2(2);
+RP2040 rp2040;
+SPIClass SPI;
+SPIClass SPI1;
+TwoWire Wire;
+TwoWire Wire1;
+
+// Clock -------------------------------------------------------------------->
+static const auto clockStart = std::chrono::steady_clock::now();
+static std::atomic<bool> virtualClock(false);
+static std::atomic<uint64_t> virtualMicros(0);
+
+void nativeUseVirtualClock(bool enable) {
+    if (enable && !virtualClock) virtualMicros = time_us_64();
+    virtualClock = enable;
+}
+
+bool nativeVirtualClock(void) {
+    return virtualClock;
+}
+
+void nativeAdvanceMicros(uint64_t us) {
+    virtualMicros += us;
+}
+
+void nativeSetMicros(uint64_t us) {
+    virtualMicros = us;
+}
+
+// Busy-wait loops in the firmware (e.g. ModbusRTUMaster::begin) never return if virtual time is
+// frozen, so a thread that keeps reading the same virtual time is advanced by 1 us every
+// NATIVE_SPIN_READS reads. Normal loops read the clock a few times per host step and never trip it.
+#define NATIVE_SPIN_READS 1000
+
+static thread_local uint64_t spinLast = 0;
+static thread_local uint32_t spinReads = 0;
+
+// Local clock, see nativeBeginLocalClock()
+static thread_local bool localClock = false;
+static thread_local uint64_t localMicros = 0;
+static thread_local uint64_t localStart = 0;
+
+void nativeBeginLocalClock(void) {
+    uint64_t now = time_us_64();
+    localStart = now;
+    localMicros = now;
+    localClock = true;
+}
+
+uint64_t nativeEndLocalClock(void) {
+    localClock = false;
+    return localMicros - localStart;
+}
+
+uint64_t time_us_64(void) {
+    if (localClock) return ++localMicros;
+    if (virtualClock) {
+        uint64_t now = virtualMicros;
+        if (now != spinLast) {
+            spinLast = now;
+            spinReads = 0;
+        } else if (++spinReads >= NATIVE_SPIN_READS) {
+            spinReads = 0;
+            now = ++virtualMicros;
+        }
+        return now;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clockStart).count();
+}
+
+unsigned long millis(void) {
+    return (uint32_t)(time_us_64() / 1000);
+}
+
+unsigned long micros(void) {
+    return (uint32_t)time_us_64();
+}
+
+void delay(unsigned long ms) {
+    if (localClock) {
+        localMicros += (uint64_t)ms * 1000;
+        return;
+    }
+    if (virtualClock) {
+        virtualMicros += (uint64_t)ms * 1000;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (localClock) {
+        localMicros += us;
+        return;
+    }
+    if (virtualClock) {
+        virtualMicros += us;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield(void) {
+    if (!virtualClock) std::this_thread::yield();
+}
+
+// GPIO --------------------------------------------------------------------->
+static int pinState[32];
+static int analogState[32];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < 32 && mode == INPUT_PULLUP) pinState[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < 32) pinState[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < 32 ? pinState[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    return pin < 32 ? analogState[pin] : 0;
+}
+
+void analogReadResolution(int bits) {
+    (void)bits;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    if (pin < 32) pinState[pin] = value ? HIGH : LOW;
+}
+
+int nativeGetPin(uint8_t pin) {
+    return digitalRead(pin);
+}
+
+void nativeSetPin(uint8_t pin, int value) {
+    digitalWrite(pin, value);
+}
+
+void nativeSetAnalog(uint8_t pin, int value) {
+    if (pin < 32) analogState[pin] = value;
+}
+
+long random(long howBig) {
+    return howBig > 0 ? ::random() % howBig : 0;
+}
+
+long random(long howSmall, long howBig) {
+    return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed) srandom(seed);
+}
+
+// Filesystem roots --------------------------------------------------------->
+static std::string littleFSRoot;
+static std::string sdRoot;
+
+void nativeSetLittleFSRoot(const char *path) {
+    littleFSRoot = path;
+}
+
+void nativeSetSDRoot(const char *path) {
+    sdRoot = path;
+}
+
+const char *nativeLittleFSRoot(void) {
+    if (littleFSRoot.empty()) {
+        const char *env = getenv("NATIVE_LITTLEFS_ROOT");
+        littleFSRoot = env ? env : NATIVE_LITTLEFS_ROOT_DEFAULT;
+    }
+    return littleFSRoot.c_str();
+}
+
+const char *nativeSDRoot(void) {
+    if (sdRoot.empty()) {
+        const char *env = getenv("NATIVE_SD_ROOT");
+        sdRoot = env ? env : NATIVE_SD_ROOT_DEFAULT;
+    }
+    return sdRoot.c_str();
+}
+
+bool nativeMakeDirs(const char *path) {
+    std::string p(path);
+    for (size_t pos = 1; pos <= p.length(); pos++) {
+        if (pos == p.length() || p[pos] == '/') {
+            std::string sub = p.substr(0, pos);
+            if (mkdir(sub.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+    }
+    return true;
+}
+
+uint16_t nativePortOffset(void) {
+    const char *env = getenv("NATIVE_PORT_OFFSET");
+    return env ? (uint16_t)atoi(env) : 8000;
+}
+
+// String ------------------------------------------------------------------->
+std::string String::_fromUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[66];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = 0;
+    do {
+        unsigned digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    return p;
+}
+
+std::string String::_fromSigned(long long value, unsigned char base) {
+    if (base == 10 && value < 0) return "-" + _fromUnsigned(-(unsigned long long)value, base);
+    return _fromUnsigned((unsigned long long)value, base);
+}
+
+std::string String::_fromDouble(double value, unsigned char decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    return buf;
+}
+
+// Print and Stream --------------------------------------------------------->
+size_t Print::printf(const char *format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(buf)) return write((const uint8_t *)buf, len);
+
+    std::string big(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&big[0], big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)big.data(), len);
+}
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        yield();
+    } while (millis() - start < _timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String ret;
+    int c;
+    while ((c = timedRead()) >= 0) ret += (char)c;
+    return ret;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String ret;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) ret += (char)c;
+    return ret;
+}
+
+// UART shim ---------------------------------------------------------------->
+void SerialUART::begin(unsigned long baud, uint16_t config) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _baud = baud;
+    _config = config;
+    if (_host) _host->begin(baud, config);
+}
+
+void SerialUART::end() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _rxQueue.clear();
+    _txQueue.clear();
+    if (_host) _host->end();
+}
+
+int SerialUART::available() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_host) return _host->available();
+    return (int)_rxQueue.size();
+}
+
+int SerialUART::read() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_host) return _host->read();
+    if (_rxQueue.empty()) return -1;
+    uint8_t c = _rxQueue.front();
+    _rxQueue.pop_front();
+    return c;
+}
+
+int SerialUART::peek() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_host) return _host->peek();
+    return _rxQueue.empty() ? -1 : _rxQueue.front();
+}
+
+size_t SerialUART::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t SerialUART::write(const uint8_t *buffer, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_host) return _host->write(buffer, size);
+    _txQueue.insert(_txQueue.end(), buffer, buffer + size);
+    return size;
+}
+
+void SerialUART::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_host) _host->flush();
+}
+
+void SerialUART::hostInject(const uint8_t *data, size_t length) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _rxQueue.insert(_rxQueue.end(), data, data + length);
+}
+
+size_t SerialUART::hostDrain(uint8_t *data, size_t length) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    while (count < length && !_txQueue.empty()) {
+        data[count++] = _txQueue.front();
+        _txQueue.pop_front();
+    }
+    return count;
+}
+
+// USB console shim --------------------------------------------------------->
+int SerialUSB::available() {
+    if (_peeked >= 0) return 1;
+    int count = 0;
+    if (ioctl(STDIN_FILENO, FIONREAD, &count) != 0) return 0;
+    return count;
+}
+
+int SerialUSB::read() {
+    if (_peeked >= 0) {
+        int c = _peeked;
+        _peeked = -1;
+        return c;
+    }
+    if (available() <= 0) return -1;
+    uint8_t c;
+    return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+int SerialUSB::peek() {
+    if (_peeked < 0) _peeked = read();
+    return _peeked;
+}
+
+static thread_local bool consoleMuted = false;
+
+bool nativeMuteConsole(bool mute) {
+    bool previous = consoleMuted;
+    consoleMuted = mute;
+    return previous;
+}
+
+size_t SerialUSB::write(uint8_t c) {
+    if (consoleMuted) return 1;
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t SerialUSB::write(const uint8_t *buffer, size_t size) {
+    if (consoleMuted) return size;
+    return fwrite(buffer, 1, size, stdout);
+}
+
+// IPAddress ---------------------------------------------------------------->
+bool IPAddress::fromString(const char *address) {
+    unsigned int a, b, c, d;
+    char tail;
+    if (!address || sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4) return false;
+    if (a > 255 || b > 255 || c > 255 || d > 255) return false;
+    _bytes[0] = a;
+    _bytes[1] = b;
+    _bytes[2] = c;
+    _bytes[3] = d;
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+}
+
+// RP2040 helper object ----------------------------------------------------->
+void RP2040::restart() {
+    fflush(stdout);
+    fprintf(stderr, "[native] rp2040.restart() requested, exiting\n");
+    exit(0);
+}
+
+void RP2040::reboot() {
+    restart();
+}
+
+static const std::thread::id mainThread = std::this_thread::get_id();
+
+int RP2040::cpuid() {
+    return std::this_thread::get_id() == mainThread ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+#include "FS.h"
+#include "LittleFS.h"
+#include "native_host.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include <algorithm>
+
+using namespace fs;
+
+FS LittleFS(nativeLittleFSRoot);
+
+// File --------------------------------------------------------------------->
+struct File::Impl {
+    FILE *fp = nullptr;
+    std::string hostPath;
+    std::string path;
+    std::string baseName;
+    bool directory = false;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~Impl() {
+        if (fp) fclose(fp);
+    }
+};
+
+static std::string joinPath(const std::string &dir, const std::string &name) {
+    if (dir.empty() || dir == "/") return "/" + name;
+    return dir + "/" + name;
+}
+
+static std::string baseNameOf(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static std::vector<std::string> listDir(const std::string &hostPath) {
+    std::vector<std::string> names;
+    DIR *dir = opendir(hostPath.c_str());
+    if (!dir) return names;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    return fwrite(buf, 1, size, _impl->fp);
+}
+
+int File::available() {
+    if (!_impl || !_impl->fp) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!_impl || !_impl->fp) return -1;
+    return fgetc(_impl->fp);
+}
+
+int File::peek() {
+    if (!_impl || !_impl->fp) return -1;
+    int c = fgetc(_impl->fp);
+    if (c != EOF) ungetc(c, _impl->fp);
+    return c;
+}
+
+void File::flush() {
+    if (_impl && _impl->fp) fflush(_impl->fp);
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+    if (!_impl || !_impl->fp) return 0;
+    return fread(buf, 1, size, _impl->fp);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_impl || !_impl->fp) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(_impl->fp, pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!_impl || !_impl->fp) return 0;
+    long pos = ftell(_impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_impl) return 0;
+    if (_impl->fp) fflush(_impl->fp);
+    struct stat st;
+    if (stat(_impl->hostPath.c_str(), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+void File::close() {
+    _impl.reset();
+}
+
+File::operator bool() const {
+    return _impl && (_impl->fp || _impl->directory);
+}
+
+const char *File::name() const {
+    return _impl ? _impl->baseName.c_str() : "";
+}
+
+const char *File::fullName() const {
+    return _impl ? _impl->path.c_str() : "";
+}
+
+bool File::isFile() const {
+    return _impl && !_impl->directory;
+}
+
+bool File::isDirectory() const {
+    return _impl && _impl->directory;
+}
+
+File File::openNextFile() {
+    File next;
+    if (!_impl || !_impl->directory) return next;
+    while (_impl->nextEntry < _impl->entries.size()) {
+        const std::string &name = _impl->entries[_impl->nextEntry++];
+        auto impl = std::make_shared<Impl>();
+        impl->path = joinPath(_impl->path, name);
+        impl->hostPath = _impl->hostPath + "/" + name;
+        impl->baseName = name;
+        struct stat st;
+        if (stat(impl->hostPath.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            impl->directory = true;
+            impl->entries = listDir(impl->hostPath);
+        } else {
+            impl->fp = fopen(impl->hostPath.c_str(), "rb");
+            if (!impl->fp) continue;
+        }
+        next._impl = impl;
+        break;
+    }
+    return next;
+}
+
+void File::rewindDirectory() {
+    if (_impl && _impl->directory) {
+        _impl->entries = listDir(_impl->hostPath);
+        _impl->nextEntry = 0;
+    }
+}
+
+time_t File::getLastWrite() {
+    if (!_impl) return 0;
+    struct stat st;
+    return stat(_impl->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+// Dir ---------------------------------------------------------------------->
+struct Dir::Impl {
+    std::string path;
+    std::string hostPath;
+    std::vector<std::string> entries;
+    int current = -1;
+};
+
+bool Dir::next() {
+    if (!_impl) return false;
+    return ++_impl->current < (int)_impl->entries.size();
+}
+
+bool Dir::rewind() {
+    if (!_impl) return false;
+    _impl->entries = listDir(_impl->hostPath);
+    _impl->current = -1;
+    return true;
+}
+
+String Dir::fileName() {
+    if (!_impl || _impl->current < 0 || _impl->current >= (int)_impl->entries.size()) return String();
+    return String(_impl->entries[_impl->current].c_str());
+}
+
+size_t Dir::fileSize() {
+    if (!_impl || _impl->current < 0 || _impl->current >= (int)_impl->entries.size()) return 0;
+    struct stat st;
+    std::string host = _impl->hostPath + "/" + _impl->entries[_impl->current];
+    return stat(host.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+bool Dir::isFile() const {
+    return !isDirectory();
+}
+
+bool Dir::isDirectory() const {
+    if (!_impl || _impl->current < 0 || _impl->current >= (int)_impl->entries.size()) return false;
+    struct stat st;
+    std::string host = _impl->hostPath + "/" + _impl->entries[_impl->current];
+    return stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+File Dir::openFile(const char *mode) {
+    if (!_impl || _impl->current < 0 || _impl->current >= (int)_impl->entries.size()) return File();
+    return LittleFS.open(joinPath(_impl->path, _impl->entries[_impl->current]).c_str(), mode);
+}
+
+// FS ----------------------------------------------------------------------->
+std::string FS::hostPath(const char *path) const {
+    std::string p = path ? path : "/";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    if (p.length() > 1 && p.back() == '/') p.pop_back();
+    return std::string(_root()) + (p == "/" ? "" : p);
+}
+
+bool FS::begin() {
+    _mounted = nativeMakeDirs(_root());
+    return _mounted;
+}
+
+void FS::end() {
+    _mounted = false;
+}
+
+bool FS::format() {
+    std::string cmd = std::string("rm -rf '") + _root() + "'";
+    if (system(cmd.c_str()) != 0) return false;
+    return nativeMakeDirs(_root());
+}
+
+bool FS::info(FSInfo &info) {
+    info.totalBytes = 1024 * 1024;
+    info.usedBytes = 0;
+    info.blockSize = 4096;
+    info.pageSize = 256;
+    info.maxOpenFiles = 16;
+    info.maxPathLength = 255;
+    return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+    File file;
+    if (!_mounted) return file;
+
+    auto impl = std::make_shared<File::Impl>();
+    impl->hostPath = hostPath(path);
+    impl->path = path ? path : "/";
+    impl->baseName = baseNameOf(impl->path);
+
+    struct stat st;
+    if (stat(impl->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        impl->directory = true;
+        impl->entries = listDir(impl->hostPath);
+        file._impl = impl;
+        return file;
+    }
+
+    // Create parent directories on write, LittleFS on target does the same
+    std::string m = mode ? mode : "r";
+    if (m[0] == 'w' || m[0] == 'a') {
+        size_t slash = impl->hostPath.find_last_of('/');
+        if (slash != std::string::npos) nativeMakeDirs(impl->hostPath.substr(0, slash).c_str());
+    }
+    if (m.find('b') == std::string::npos) m += "b";
+    impl->fp = fopen(impl->hostPath.c_str(), m.c_str());
+    if (!impl->fp) return file;
+    file._impl = impl;
+    return file;
+}
+
+Dir FS::openDir(const char *path) {
+    Dir dir;
+    auto impl = std::make_shared<Dir::Impl>();
+    impl->path = path ? path : "/";
+    impl->hostPath = hostPath(path);
+    impl->entries = listDir(impl->hostPath);
+    dir._impl = impl;
+    return dir;
+}
+
+bool FS::exists(const char *path) {
+    struct stat st;
+    return _mounted && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) {
+    return _mounted && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *pathFrom, const char *pathTo) {
+    return _mounted && ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path) {
+    return _mounted && nativeMakeDirs(hostPath(path).c_str());
+}
+
+bool FS::rmdir(const char *path) {
+    return _mounted && ::rmdir(hostPath(path).c_str()) == 0;
+}
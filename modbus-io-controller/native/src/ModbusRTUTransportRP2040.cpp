@@ -0,0 +1,52 @@
+#include "native_host.h"
+#include <ModbusRTUTransportRP2040.h>
+
+// Host implementation of the RP2040 UART transport. There is no UART or DMA, every call is
+// forwarded to the transport attached with nativeAttachRS485().
+
+static ModbusRTUTransport *rs485Host[2] = {nullptr, nullptr};
+
+void nativeAttachRS485(uint8_t uart, ModbusRTUTransport *transport) {
+    rs485Host[uart ? 1 : 0] = transport;
+}
+
+ModbusRTUTransportRP2040::ModbusRTUTransportRP2040(uint8_t uart, uint8_t txPin, uint8_t rxPin, uint8_t dePin) {
+    _uart = uart ? 1 : 0;
+    _txPin = txPin;
+    _rxPin = rxPin;
+    _dePin = dePin;
+}
+
+void ModbusRTUTransportRP2040::begin(unsigned long baud, uint32_t config) {
+    _timeoutUs = (32 * 1000000UL) / baud;
+    if (rs485Host[_uart]) rs485Host[_uart]->begin(baud, config);
+}
+
+bool ModbusRTUTransportRP2040::send(const uint8_t *frame, uint16_t len) {
+    if (len > MODBUS_RTU_RP2040_TX_BUF_SIZE) return false;
+    return rs485Host[_uart] ? rs485Host[_uart]->send(frame, len) : true;
+}
+
+bool ModbusRTUTransportRP2040::sending() {
+    return rs485Host[_uart] ? rs485Host[_uart]->sending() : false;
+}
+
+int ModbusRTUTransportRP2040::available() {
+    return rs485Host[_uart] ? rs485Host[_uart]->available() : 0;
+}
+
+uint16_t ModbusRTUTransportRP2040::read(uint8_t *buf, uint16_t len) {
+    if (!rs485Host[_uart]) return 0;
+    uint16_t count = rs485Host[_uart]->read(buf, len);
+    if (count) _lastRxTime = rs485Host[_uart]->lastRxMicros();
+    return count;
+}
+
+void ModbusRTUTransportRP2040::discard() {
+    if (!rs485Host[_uart]) return;
+    rs485Host[_uart]->discard();
+    _lastRxTime = rs485Host[_uart]->lastRxMicros();
+}
+
+void ModbusRTUTransportRP2040::handleIrq() {
+}
@@ -0,0 +1,98 @@
+#include "SdFat.h"
+#include "native_host.h"
+
+#include <sys/stat.h>
+
+void (*FsDateTime::callback)(uint16_t *date, uint16_t *time) = nullptr;
+
+// The SD volume reuses the host directory backed FS implementation
+static fs::FS sdHost(nativeSDRoot);
+
+static const char *modeFor(const char *path, oflag_t oflag) {
+    if ((oflag & O_ACCMODE) == O_RDONLY) return "r";
+    if (oflag & O_APPEND) return "a+";
+    if (oflag & O_TRUNC) return "w+";
+    if ((oflag & O_CREAT) && !sdHost.exists(path)) return "w+";
+    return "r+";
+}
+
+// SdFs --------------------------------------------------------------------->
+bool SdFs::begin(SdioConfig config) {
+    (void)config;
+    return sdHost.begin();
+}
+
+bool SdFs::begin(SdSpiConfig config) {
+    (void)config;
+    return sdHost.begin();
+}
+
+bool SdFs::exists(const char *path) {
+    return sdHost.exists(path);
+}
+
+bool SdFs::mkdir(const char *path, bool pFlag) {
+    (void)pFlag;
+    return sdHost.mkdir(path);
+}
+
+bool SdFs::remove(const char *path) {
+    return sdHost.remove(path);
+}
+
+bool SdFs::rename(const char *oldPath, const char *newPath) {
+    return sdHost.rename(oldPath, newPath);
+}
+
+bool SdFs::rmdir(const char *path) {
+    return sdHost.rmdir(path);
+}
+
+FsFile SdFs::open(const char *path, oflag_t oflag) {
+    FsFile file;
+    file.open(path, oflag);
+    return file;
+}
+
+// FsFile ------------------------------------------------------------------->
+bool FsFile::open(const char *path, oflag_t oflag) {
+    _file = sdHost.open(path, modeFor(path, oflag));
+    return isOpen();
+}
+
+bool FsFile::open(FsFile *dir, const char *path, oflag_t oflag) {
+    if (!dir || !dir->isDirectory()) return false;
+    String full = String(dir->_file.fullName());
+    if (!full.endsWith("/")) full += "/";
+    full += path;
+    return open(full.c_str(), oflag);
+}
+
+bool FsFile::openNext(FsFile *dir, oflag_t oflag) {
+    (void)oflag;
+    if (!dir) return false;
+    _file = dir->_file.openNextFile();
+    return isOpen();
+}
+
+bool FsFile::close() {
+    _file.close();
+    return true;
+}
+
+size_t FsFile::getName(char *name, size_t len) {
+    if (!name || len == 0) return 0;
+    strncpy(name, _file.name(), len - 1);
+    name[len - 1] = '\0';
+    return strlen(name);
+}
+
+bool FsFile::getModifyDateTime(uint16_t *pdate, uint16_t *ptime) {
+    if (!isOpen()) return false;
+    time_t t = _file.getLastWrite();
+    struct tm tmv;
+    localtime_r(&t, &tmv);
+    *pdate = FS_DATE(tmv.tm_year + 1900, tmv.tm_mon + 1, tmv.tm_mday);
+    *ptime = FS_TIME(tmv.tm_hour, tmv.tm_min, tmv.tm_sec);
+    return true;
+}
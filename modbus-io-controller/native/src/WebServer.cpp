@@ -0,0 +1,345 @@
+#include "WebServer.h"
+#include "native_host.h"
+
+#define HTTP_MAX_REQUEST_SIZE (2 * 1024 * 1024)
+#define HTTP_CLIENT_TIMEOUT 5000
+
+static const char *statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 423: return "Locked";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static String urlDecode(const String &text) {
+    std::string out;
+    const char *s = text.c_str();
+    for (size_t i = 0; s[i]; i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && isxdigit((unsigned char)s[i + 1]) && isxdigit((unsigned char)s[i + 2])) {
+            char hex[3] = {s[i + 1], s[i + 2], 0};
+            out += (char)strtol(hex, nullptr, 16);
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return String(out);
+}
+
+static HTTPMethod methodFromString(const std::string &m) {
+    if (m == "GET") return HTTP_GET;
+    if (m == "HEAD") return HTTP_HEAD;
+    if (m == "POST") return HTTP_POST;
+    if (m == "PUT") return HTTP_PUT;
+    if (m == "PATCH") return HTTP_PATCH;
+    if (m == "DELETE") return HTTP_DELETE;
+    if (m == "OPTIONS") return HTTP_OPTIONS;
+    return HTTP_ANY;
+}
+
+// Lifecycle ---------------------------------------------------------------->
+void WebServer::begin() {
+    _listener.begin(_port);
+}
+
+void WebServer::begin(uint16_t port) {
+    _port = port;
+    _listener.begin(_port);
+}
+
+void WebServer::close() {
+    _finishClient();
+    _listener.stop();
+}
+
+void WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn) {
+    _handlers.push_back({uri, method, fn, ufn});
+}
+
+// Request handling --------------------------------------------------------->
+void WebServer::handleClient() {
+    if (!_currentClient) {
+        _currentClient = _listener.accept();
+        if (!_currentClient) return;
+        _rxBuffer.clear();
+        _clientStart = millis();
+    }
+
+    uint8_t buf[2048];
+    while (_currentClient.available() > 0 && _rxBuffer.size() < HTTP_MAX_REQUEST_SIZE) {
+        int n = _currentClient.read(buf, sizeof(buf));
+        if (n <= 0) break;
+        _rxBuffer.append((const char *)buf, n);
+    }
+
+    if (_parseRequest()) {
+        _dispatch();
+        _finishClient();
+    } else if (!_currentClient.connected() || millis() - _clientStart > HTTP_CLIENT_TIMEOUT) {
+        _finishClient();
+    }
+}
+
+bool WebServer::_parseRequest() {
+    size_t headerEnd = _rxBuffer.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return false;
+
+    _args.clear();
+    _headers.clear();
+
+    // Request line
+    size_t lineEnd = _rxBuffer.find("\r\n");
+    std::string requestLine = _rxBuffer.substr(0, lineEnd);
+    size_t sp1 = requestLine.find(' ');
+    size_t sp2 = requestLine.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) return true;
+    _currentMethod = methodFromString(requestLine.substr(0, sp1));
+    std::string target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+    size_t query = target.find('?');
+    _currentUri = urlDecode(String(target.substr(0, query)));
+
+    // Headers
+    size_t pos = lineEnd + 2;
+    while (pos < headerEnd) {
+        size_t eol = _rxBuffer.find("\r\n", pos);
+        std::string line = _rxBuffer.substr(pos, eol - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            String value(line.substr(colon + 1));
+            value.trim();
+            _headers.push_back({String(line.substr(0, colon)), value});
+        }
+        pos = eol + 2;
+    }
+
+    // Wait for the full body
+    size_t contentLength = (size_t)header("Content-Length").toInt();
+    if (_rxBuffer.size() < headerEnd + 4 + contentLength) return false;
+    std::string body = _rxBuffer.substr(headerEnd + 4, contentLength);
+
+    if (query != std::string::npos) _parseArgs(String(target.substr(query + 1)));
+
+    String contentType = header("Content-Type");
+    if (contentType.startsWith("application/x-www-form-urlencoded")) {
+        _parseArgs(String(body));
+    } else if (contentType.startsWith("multipart/form-data")) {
+        int b = contentType.indexOf("boundary=");
+        if (b >= 0) {
+            Handler *handler = nullptr;
+            for (auto &h : _handlers) {
+                if (h.uri == _currentUri && (h.method == HTTP_ANY || h.method == _currentMethod)) {
+                    handler = &h;
+                    break;
+                }
+            }
+            _parseMultipart(contentType.substring(b + 9), body, handler);
+        }
+    } else if (!body.empty()) {
+        _args.push_back({String("plain"), String(body)});
+    }
+    return true;
+}
+
+void WebServer::_parseArgs(const String &data) {
+    int start = 0;
+    while (start < (int)data.length()) {
+        int amp = data.indexOf('&', start);
+        if (amp < 0) amp = data.length();
+        String pair = data.substring(start, amp);
+        int eq = pair.indexOf('=');
+        if (eq >= 0) {
+            _args.push_back({urlDecode(pair.substring(0, eq)), urlDecode(pair.substring(eq + 1))});
+        } else if (pair.length() > 0) {
+            _args.push_back({urlDecode(pair), String()});
+        }
+        start = amp + 1;
+    }
+}
+
+void WebServer::_parseMultipart(const String &boundary, const std::string &body, Handler *handler) {
+    std::string delimiter = std::string("--") + boundary.c_str();
+    size_t pos = body.find(delimiter);
+    while (pos != std::string::npos) {
+        pos += delimiter.size();
+        if (body.compare(pos, 2, "--") == 0) break;
+        pos += 2; // CRLF after the delimiter
+
+        size_t partHeaderEnd = body.find("\r\n\r\n", pos);
+        if (partHeaderEnd == std::string::npos) break;
+        std::string partHeaders = body.substr(pos, partHeaderEnd - pos);
+        size_t dataStart = partHeaderEnd + 4;
+        size_t next = body.find("\r\n" + delimiter, dataStart);
+        if (next == std::string::npos) break;
+
+        String name, filename, type;
+        String headersStr(partHeaders);
+        int n = headersStr.indexOf("name=\"");
+        if (n >= 0) name = headersStr.substring(n + 6, headersStr.indexOf('"', n + 6));
+        int f = headersStr.indexOf("filename=\"");
+        if (f >= 0) filename = headersStr.substring(f + 10, headersStr.indexOf('"', f + 10));
+        int t = headersStr.indexOf("Content-Type:");
+        if (t >= 0) {
+            int eol = headersStr.indexOf("\r\n", t);
+            type = headersStr.substring(t + 13, eol < 0 ? headersStr.length() : eol);
+            type.trim();
+        }
+
+        if (f >= 0) {
+            THandlerFunction ufn = handler && handler->ufn ? handler->ufn : _fileUploadHandler;
+            _upload.filename = filename;
+            _upload.name = name;
+            _upload.type = type;
+            _upload.totalSize = 0;
+            _upload.currentSize = 0;
+            _upload.status = UPLOAD_FILE_START;
+            if (ufn) ufn();
+            for (size_t offset = dataStart; offset < next; offset += HTTP_UPLOAD_BUFLEN) {
+                _upload.currentSize = min((size_t)HTTP_UPLOAD_BUFLEN, next - offset);
+                memcpy(_upload.buf, body.data() + offset, _upload.currentSize);
+                _upload.totalSize += _upload.currentSize;
+                _upload.status = UPLOAD_FILE_WRITE;
+                if (ufn) ufn();
+            }
+            _upload.currentSize = 0;
+            _upload.status = UPLOAD_FILE_END;
+            if (ufn) ufn();
+        } else {
+            _args.push_back({name, String(body.substr(dataStart, next - dataStart))});
+        }
+        pos = next + 2;
+    }
+}
+
+void WebServer::_dispatch() {
+    _responseHeaders.clear();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _headersSent = false;
+    _chunked = false;
+
+    for (auto &h : _handlers) {
+        if (h.uri == _currentUri && (h.method == HTTP_ANY || h.method == _currentMethod)) {
+            h.fn();
+            return;
+        }
+    }
+    if (_notFoundHandler) {
+        _notFoundHandler();
+    } else {
+        send(404, "text/plain", "Not found");
+    }
+}
+
+// Drop our reference rather than stopping the client, as on the target a handler holding a copy
+// (the live event stream) keeps the connection open and the last copy closes it
+void WebServer::_finishClient() {
+    if (_currentClient) _currentClient.flush();
+    _currentClient = WiFiClient();
+    _rxBuffer.clear();
+}
+
+// Arguments and headers ---------------------------------------------------->
+String WebServer::arg(const String &name) const {
+    for (auto &a : _args) if (a.name == name) return a.value;
+    return String();
+}
+
+String WebServer::arg(int i) const {
+    return i >= 0 && i < (int)_args.size() ? _args[i].value : String();
+}
+
+String WebServer::argName(int i) const {
+    return i >= 0 && i < (int)_args.size() ? _args[i].name : String();
+}
+
+bool WebServer::hasArg(const String &name) const {
+    for (auto &a : _args) if (a.name == name) return true;
+    return false;
+}
+
+String WebServer::header(const String &name) const {
+    for (auto &h : _headers) if (h.name.equalsIgnoreCase(name)) return h.value;
+    return String();
+}
+
+String WebServer::header(int i) const {
+    return i >= 0 && i < (int)_headers.size() ? _headers[i].value : String();
+}
+
+String WebServer::headerName(int i) const {
+    return i >= 0 && i < (int)_headers.size() ? _headers[i].name : String();
+}
+
+bool WebServer::hasHeader(const String &name) const {
+    for (auto &h : _headers) if (h.name.equalsIgnoreCase(name)) return true;
+    return false;
+}
+
+// Responses ---------------------------------------------------------------->
+void WebServer::sendHeader(const String &name, const String &value, bool first) {
+    if (first) {
+        _responseHeaders.insert(_responseHeaders.begin(), {name, value});
+    } else {
+        _responseHeaders.push_back({name, value});
+    }
+}
+
+void WebServer::send(int code, const char *content_type, const String &content) {
+    if (_headersSent) return;
+    String head = String("HTTP/1.1 ") + String(code) + " " + statusText(code) + "\r\n";
+    bool hasType = false;
+    for (auto &h : _responseHeaders) {
+        if (h.name.equalsIgnoreCase("Content-Type")) hasType = true;
+        head += h.name + ": " + h.value + "\r\n";
+    }
+    if (!hasType && content_type) head += String("Content-Type: ") + content_type + "\r\n";
+    if (_contentLength == CONTENT_LENGTH_NOT_SET) {
+        head += String("Content-Length: ") + String((unsigned long)content.length()) + "\r\n";
+    } else if (_contentLength != CONTENT_LENGTH_UNKNOWN) {
+        head += String("Content-Length: ") + String((unsigned long)_contentLength) + "\r\n";
+    } else {
+        // As on target, an unknown length is sent chunked and ended with sendContent("")
+        head += "Transfer-Encoding: chunked\r\n";
+        _chunked = true;
+    }
+    head += "Connection: close\r\n\r\n";
+
+    _currentClient.write((const uint8_t *)head.c_str(), head.length());
+    _headersSent = true;
+    if (content.length()) sendContent(content);
+}
+
+void WebServer::sendContent(const String &content) {
+    sendContent(content.c_str(), content.length());
+}
+
+void WebServer::sendContent(const char *content, size_t size) {
+    if (_currentMethod == HTTP_HEAD) return;
+    if (!_chunked) {
+        _currentClient.write((const uint8_t *)content, size);
+        return;
+    }
+    char chunkSize[12];
+    int length = snprintf(chunkSize, sizeof(chunkSize), "%zx\r\n", size);
+    _currentClient.write((const uint8_t *)chunkSize, length);
+    _currentClient.write((const uint8_t *)content, size);
+    _currentClient.write((const uint8_t *)"\r\n", 2);
+    if (size == 0) _chunked = false; // Last chunk
+}
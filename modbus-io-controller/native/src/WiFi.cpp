@@ -0,0 +1,253 @@
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+#include "native_host.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#define CLIENT_WRITE_TIMEOUT 5000
+
+static void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// WiFiClient --------------------------------------------------------------->
+struct WiFiClient::Context {
+    int fd = -1;
+    bool connected = false;
+    std::vector<uint8_t> rx;
+    size_t rxPos = 0;
+
+    ~Context() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+WiFiClient::WiFiClient() {}
+
+WiFiClient::WiFiClient(int fd) : _ctx(std::make_shared<Context>()) {
+    setNonBlocking(fd);
+    _ctx->fd = fd;
+    _ctx->connected = true;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+    stop();
+    struct addrinfo hints = {};
+    struct addrinfo *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res) return 0;
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd < 0 || ::connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        if (fd >= 0) ::close(fd);
+        freeaddrinfo(res);
+        return 0;
+    }
+    freeaddrinfo(res);
+    *this = WiFiClient(fd);
+    return 1;
+}
+
+void WiFiClient::_fill() {
+    if (!_ctx || _ctx->fd < 0 || !_ctx->connected) return;
+    if (_ctx->rxPos > 0 && _ctx->rxPos == _ctx->rx.size()) {
+        _ctx->rx.clear();
+        _ctx->rxPos = 0;
+    }
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(_ctx->fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            _ctx->rx.insert(_ctx->rx.end(), buf, buf + n);
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) _ctx->connected = false;
+        break;
+    }
+}
+
+uint8_t WiFiClient::connected() {
+    if (!_ctx) return 0;
+    _fill();
+    return _ctx->connected || _ctx->rxPos < _ctx->rx.size();
+}
+
+int WiFiClient::available() {
+    if (!_ctx) return 0;
+    _fill();
+    return (int)(_ctx->rx.size() - _ctx->rxPos);
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size) {
+    if (available() <= 0) return -1;
+    size_t n = min(size, _ctx->rx.size() - _ctx->rxPos);
+    memcpy(buf, _ctx->rx.data() + _ctx->rxPos, n);
+    _ctx->rxPos += n;
+    return (int)n;
+}
+
+int WiFiClient::peek() {
+    if (available() <= 0) return -1;
+    return _ctx->rx[_ctx->rxPos];
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size) {
+    if (!_ctx || _ctx->fd < 0 || !_ctx->connected) return 0;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(_ctx->fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            struct pollfd pfd = {_ctx->fd, POLLOUT, 0};
+            if (::poll(&pfd, 1, CLIENT_WRITE_TIMEOUT) <= 0) break;
+        } else {
+            _ctx->connected = false;
+            break;
+        }
+    }
+    return sent;
+}
+
+// Free space in the socket's send buffer, like the lwIP send buffer on target
+int WiFiClient::availableForWrite() {
+    if (!_ctx || _ctx->fd < 0 || !_ctx->connected) return 0;
+    int size = 0;
+    int queued = 0;
+    socklen_t length = sizeof(size);
+    if (getsockopt(_ctx->fd, SOL_SOCKET, SO_SNDBUF, &size, &length) != 0 || ioctl(_ctx->fd, TIOCOUTQ, &queued) != 0) return 0;
+    return size > queued ? size - queued : 0;
+}
+
+void WiFiClient::flush() {}
+
+void WiFiClient::stop() {
+    if (_ctx && _ctx->fd >= 0) {
+        ::shutdown(_ctx->fd, SHUT_RDWR);
+        ::close(_ctx->fd);
+        _ctx->fd = -1;
+        _ctx->connected = false;
+    }
+    _ctx.reset();
+}
+
+void WiFiClient::setNoDelay(bool nodelay) {
+    if (!_ctx || _ctx->fd < 0) return;
+    int flag = nodelay ? 1 : 0;
+    setsockopt(_ctx->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+static bool socketAddress(int fd, bool peer, IPAddress &ip, uint16_t &port) {
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    int res = peer ? getpeername(fd, (struct sockaddr *)&addr, &len) : getsockname(fd, (struct sockaddr *)&addr, &len);
+    if (res != 0) return false;
+    ip = IPAddress((uint32_t)addr.sin_addr.s_addr);
+    port = ntohs(addr.sin_port);
+    return true;
+}
+
+IPAddress WiFiClient::remoteIP() {
+    IPAddress ip;
+    uint16_t port;
+    if (_ctx && _ctx->fd >= 0) socketAddress(_ctx->fd, true, ip, port);
+    return ip;
+}
+
+uint16_t WiFiClient::remotePort() {
+    IPAddress ip;
+    uint16_t port = 0;
+    if (_ctx && _ctx->fd >= 0) socketAddress(_ctx->fd, true, ip, port);
+    return port;
+}
+
+IPAddress WiFiClient::localIP() {
+    IPAddress ip;
+    uint16_t port;
+    if (_ctx && _ctx->fd >= 0) socketAddress(_ctx->fd, false, ip, port);
+    return ip;
+}
+
+uint16_t WiFiClient::localPort() {
+    IPAddress ip;
+    uint16_t port = 0;
+    if (_ctx && _ctx->fd >= 0) socketAddress(_ctx->fd, false, ip, port);
+    return port;
+}
+
+WiFiClient::operator bool() {
+    return _ctx && (_ctx->fd >= 0 || _ctx->rxPos < _ctx->rx.size());
+}
+
+// WiFiServer --------------------------------------------------------------->
+void WiFiServer::begin(uint16_t port, int backlog) {
+    stop();
+    _port = port;
+    uint16_t hostPort = port + nativePortOffset();
+
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_fd < 0) return;
+    int reuse = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(hostPort);
+    if (bind(_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(_fd, backlog) != 0) {
+        fprintf(stderr, "[native] Failed to listen on port %u: %s\n", hostPort, strerror(errno));
+        ::close(_fd);
+        _fd = -1;
+        return;
+    }
+    setNonBlocking(_fd);
+    fprintf(stderr, "[native] Listening on port %u (firmware port %u)\n", hostPort, port);
+}
+
+void WiFiServer::stop() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool WiFiServer::hasClient() {
+    if (_fd < 0) return false;
+    struct pollfd pfd = {_fd, POLLIN, 0};
+    return ::poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+WiFiClient WiFiServer::accept() {
+    if (_fd < 0) return WiFiClient();
+    int fd = ::accept(_fd, nullptr, nullptr);
+    if (fd < 0) return WiFiClient();
+    WiFiClient client(fd);
+    if (_noDelay) client.setNoDelay(true);
+    return client;
+}
@@ -0,0 +1,74 @@
+#include <Arduino.h>
+#include "native_host.h"
+#include "RS485BusSim.h"
+
+#include <sys/stat.h>
+#include <thread>
+
+// Native entry point. Core 0 (setup/loop) runs on the main thread and core 1 (setup1/loop1) on a
+// second thread, mirroring the RP2040 dual core layout.
+// Left out of unit test builds (pio test -e native), the tests in test/ bring their own main().
+
+#ifndef PIO_UNIT_TESTING
+
+static void seedLittleFS(void) {
+    // First run: populate the LittleFS directory with the web assets from data/
+    struct stat st;
+    if (stat(nativeLittleFSRoot(), &st) == 0) return;
+    if (stat("data", &st) != 0 || !S_ISDIR(st.st_mode)) return;
+    nativeMakeDirs(nativeLittleFSRoot());
+    std::string cmd = std::string("cp -r data/. '") + nativeLittleFSRoot() + "'";
+    if (system(cmd.c_str()) != 0) {
+        fprintf(stderr, "[native] Failed to seed %s from data/\n", nativeLittleFSRoot());
+    }
+}
+
+static RS485BusSim *simBus[2];
+
+static void attachSimulatedBus(int index, const char *env) {
+    // NATIVE_SIM_BUS1=N / NATIVE_SIM_BUS2=N put N emulated thermocouple boards (IDs 1..N) on the bus
+    const char *value = getenv(env);
+    int count = value ? atoi(value) : 0;
+    if (count <= 0) return;
+    count = min(count, 244);
+    simBus[index] = new RS485BusSim();
+    for (int id = 1; id <= count; id++) {
+        char name[32];      // Room for any two ints, the board keeps the first 13 characters
+        snprintf(name, sizeof(name), "Sim %d-%d", index + 1, id);
+        simBus[index]->addBoard(new ThermocoupleBoardSim(id, name));
+    }
+    nativeAttachRS485(index, simBus[index]);
+    fprintf(stderr, "[native] RS485 bus %d: simulated RS485 bus with %d thermocouple boards\n", index + 1, count);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    seedLittleFS();
+    nativeMakeDirs(nativeSDRoot());
+    attachSimulatedBus(0, "NATIVE_SIM_BUS1");
+    attachSimulatedBus(1, "NATIVE_SIM_BUS2");
+    fprintf(stderr, "[native] LittleFS: %s, SD: %s, port offset: %u\n",
+            nativeLittleFSRoot(), nativeSDRoot(), nativePortOffset());
+
+    std::thread core1([]() {
+        if (!setup1 || !loop1) return;
+        setup1();
+        for (;;) {
+            loop1();
+            yield();
+        }
+    });
+    core1.detach();
+
+    setup();
+    for (;;) {
+        loop();
+        yield();
+    }
+    return 0;
+}
+
+#endif
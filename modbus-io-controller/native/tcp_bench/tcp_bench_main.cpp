@@ -0,0 +1,290 @@
+#include <Arduino.h>
+#include "native_host.h"
+#include "RS485BusSim.h"
+#include "sys_init.h"
+#include "io_core/board_config.h"
+#include "network/modbus_tcp.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <time.h>
+
+// Modbus TCP read benchmark. Polls simulated boards until every board's registers are published,
+// then serves pipelined read requests from a loopback client through the real ModbusTCPServer and
+// reports one JSON object per request mix on stdout:
+//
+//   requests_per_s        answered requests per host second (server and client share the thread)
+//   cpu_ns_per_request    host CPU time in ModbusTCPServer::poll() per answered request
+//   exceptions            requests answered with an exception (should be 0)
+//   cache_requests_per_s  handleReadRequest() calls per host CPU second, the cached read path alone
+//
+// On the host the served figures are dominated by socket system calls, the cache figure isolates
+// the register read itself. Only the server's public API is used.
+
+struct tcpBenchOptions_t {
+    const char *mix = "all";
+    uint32_t seconds = 5;           // Host time per request mix
+    uint8_t boards = MAX_BOARDS;
+    uint16_t pipeline = 32;         // Requests in flight
+    uint16_t port = 1502;           // Before the native port offset
+};
+
+struct tcpBenchMix_t {
+    const char *name;
+    uint8_t functionCode;           // 0 cycles through all four reads
+    uint16_t quantity;
+};
+
+static const tcpBenchMix_t mixes[] = {
+    {"coils",     0x01, 32},
+    {"discrete",  0x02, 32},
+    {"holding",   0x03, TCIO_HOLDING_REG_COUNT},
+    {"input",     0x04, TCIO_INPUT_REG_COUNT},
+    {"mixed",     0,    0},
+};
+
+static uint64_t threadCpuNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t hostNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Setup -------------------------------------------------------------------->
+static void configureBoards(const tcpBenchOptions_t &opt) {
+    memset(boardConfigs, 0, sizeof(boardConfigs));
+    boardCount = opt.boards;
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        BoardConfig &cfg = boardConfigs[i];
+        snprintf(cfg.boardName, sizeof(cfg.boardName), "Bench %d", i);
+        cfg.type = THERMOCOUPLE_IO;
+        cfg.boardIndex = i;
+        cfg.modbusPort = i & 1;
+        cfg.slaveID = i / 2 + 1;
+        cfg.tcpUnitId = (i & 1) ? 100 + cfg.slaveID : 0; // Slave IDs repeat on the second bus
+        cfg.pollTime = MIN_POLL_TIME;
+        cfg.recordInterval = 60000;
+        cfg.initialised = true;
+        for (uint8_t ch = 0; ch < 8; ch++) {
+            cfg.settings.thermocoupleIO.channels[ch].alertEnable = true;
+            cfg.settings.thermocoupleIO.channels[ch].alertSetpoint = 200.0f + ch;
+            cfg.settings.thermocoupleIO.channels[ch].alertHysteresis = 5;
+        }
+    }
+}
+
+// Run the poller under the virtual clock until every board has been read at least once
+static bool publishBoards(const tcpBenchOptions_t &opt) {
+    uint64_t end = time_us_64() + 5000000;
+    while (time_us_64() < end) {
+        manage_io_core();
+        nativeAdvanceMicros(10);
+        bool ready = true;
+        for (uint8_t i = 0; i < opt.boards; i++) {
+            thermocoupleSnapshot_t snapshot;
+            if (!thermocoupleIO_index.tcIO[i].configInitialised || !thermocouple_read_snapshot(i, &snapshot)) ready = false;
+        }
+        if (ready) return true;
+    }
+    return false;
+}
+
+// Request mix run ---------------------------------------------------------->
+static uint8_t unitId(uint8_t board) {
+    return boardConfigs[board].tcpUnitId ? boardConfigs[board].tcpUnitId : boardConfigs[board].slaveID;
+}
+
+static void writeRequest(WiFiClient &client, uint16_t transactionId, uint8_t unitId, uint8_t functionCode, uint16_t quantity) {
+    uint8_t adu[12] = {
+        (uint8_t)(transactionId >> 8), (uint8_t)transactionId, 0, 0, 0, 6, unitId,
+        functionCode, 0, 0, (uint8_t)(quantity >> 8), (uint8_t)quantity
+    };
+    client.write(adu, sizeof(adu));
+}
+
+static const uint8_t allFunctions[] = {0x01, 0x02, 0x03, 0x04};
+static const uint16_t allQuantities[] = {32, 32, TCIO_HOLDING_REG_COUNT, TCIO_INPUT_REG_COUNT};
+
+// Call the cached read path directly for a second of CPU time, returns reads per CPU second
+static double cacheReadRate(const tcpBenchMix_t &mix, const tcpBenchOptions_t &opt) {
+    uint8_t response[256];
+    uint16_t responseLength;
+    uint64_t reads = 0;
+    uint64_t start = threadCpuNs();
+    uint64_t elapsed = 0;
+    while (elapsed < 1000000000ULL) {
+        for (uint32_t i = 0; i < 1024; i++, reads++) {
+            uint8_t board = reads % opt.boards;
+            uint8_t which = (reads / opt.boards) % 4;
+            uint8_t functionCode = mix.functionCode ? mix.functionCode : allFunctions[which];
+            uint16_t quantity = mix.functionCode ? mix.quantity : allQuantities[which];
+            modbusServer.handleReadRequest(unitId(board), functionCode, 0, quantity, response, responseLength);
+        }
+        elapsed = threadCpuNs() - start;
+    }
+    return reads / (elapsed / 1e9);
+}
+
+static void runMix(const tcpBenchMix_t &mix, const tcpBenchOptions_t &opt, WiFiClient &client) {
+    uint8_t rx[4096];
+    uint32_t rxLength = 0;
+    uint64_t sent = 0;
+    uint64_t answered = 0;
+    uint64_t exceptions = 0;
+    uint64_t cpuTotal = 0;
+    uint64_t start = hostNs();
+    uint64_t end = start + (uint64_t)opt.seconds * 1000000000ULL;
+
+    while (hostNs() < end) {
+        // Keep the pipeline full, rotating over the boards (and function codes for the mixed run)
+        while (sent - answered < opt.pipeline) {
+            uint8_t board = sent % opt.boards;
+            uint8_t which = (sent / opt.boards) % 4;
+            uint8_t functionCode = mix.functionCode ? mix.functionCode : allFunctions[which];
+            uint16_t quantity = mix.functionCode ? mix.quantity : allQuantities[which];
+            writeRequest(client, (uint16_t)sent, unitId(board), functionCode, quantity);
+            sent++;
+        }
+
+        uint64_t cpu = threadCpuNs();
+        modbusServer.poll();
+        cpuTotal += threadCpuNs() - cpu;
+
+        int count = client.read(&rx[rxLength], sizeof(rx) - rxLength);
+        if (count > 0) rxLength += count;
+        uint32_t pos = 0;
+        while (rxLength - pos >= 7) {
+            uint16_t length = (rx[pos + 4] << 8) | rx[pos + 5];
+            if (rxLength - pos < 6U + length) break;
+            if (rx[pos + 7] & 0x80) exceptions++;
+            answered++;
+            pos += 6 + length;
+        }
+        memmove(rx, &rx[pos], rxLength - pos);
+        rxLength -= pos;
+    }
+
+    // Let the requests still in flight finish so the next mix starts clean
+    for (uint32_t i = 0; i < 1000 && sent > answered; i++) {
+        modbusServer.poll();
+        int count = client.read(&rx[rxLength], sizeof(rx) - rxLength);
+        if (count > 0) rxLength += count;
+        uint32_t pos = 0;
+        while (rxLength - pos >= 7 && rxLength - pos >= 6U + ((rx[pos + 4] << 8) | rx[pos + 5])) {
+            answered++;
+            pos += 6 + ((rx[pos + 4] << 8) | rx[pos + 5]);
+        }
+        memmove(rx, &rx[pos], rxLength - pos);
+        rxLength -= pos;
+    }
+
+    double seconds = (double)(hostNs() - start) / 1e9;
+    double cacheRate = cacheReadRate(mix, opt);
+    printf("{\"mix\":\"%s\",\"boards\":%u,\"pipeline\":%u,\"host_s\":%.3f,\"requests\":%llu,"
+           "\"requests_per_s\":%.0f,\"cpu_ns_per_request\":%.0f,\"exceptions\":%llu,\"cache_requests_per_s\":%.0f}\n",
+           mix.name, opt.boards, opt.pipeline, seconds, (unsigned long long)answered,
+           answered / seconds, answered ? (double)cpuTotal / answered : 0.0, (unsigned long long)exceptions, cacheRate);
+    fflush(stdout);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--mix all|coils|discrete|holding|input|mixed] [--seconds N] [--boards N]\n"
+                    "          [--pipeline N] [--port N]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    // Results go to stdout with printf, firmware logging through Serial is discarded
+    nativeMuteConsole(true);
+
+    tcpBenchOptions_t opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (arg == "--mix") opt.mix = value;
+        else if (arg == "--seconds") opt.seconds = strtoul(value, nullptr, 0);
+        else if (arg == "--boards") opt.boards = (uint8_t)constrain(strtoul(value, nullptr, 0), 1UL, (unsigned long)MAX_BOARDS);
+        else if (arg == "--pipeline") opt.pipeline = (uint16_t)constrain(strtoul(value, nullptr, 0), 1UL, 256UL);
+        else if (arg == "--port") opt.port = strtoul(value, nullptr, 0);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    nativeUseVirtualClock(true);
+    nativeSetMicros(1000000);
+    globalDateTime = epochToDateTime(1767225600); // RTC as if set, record_thermocouple() needs a valid time
+
+    char root[] = "/tmp/modbus-io-tcp-bench.XXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "[bench] Failed to create temp dir\n");
+        return 1;
+    }
+    std::string littleFSRoot = std::string(root) + "/littlefs";
+    std::string sdRoot = std::string(root) + "/sd";
+    nativeMakeDirs(littleFSRoot.c_str());
+    nativeMakeDirs(sdRoot.c_str());
+    nativeSetLittleFSRoot(littleFSRoot.c_str());
+    nativeSetSDRoot(sdRoot.c_str());
+
+    RS485BusSim *sim[2];
+    for (uint8_t port = 0; port < 2; port++) {
+        rs485SimConfig_t simConfig;
+        simConfig.seed = port + 1;
+        sim[port] = new RS485BusSim(simConfig);
+    }
+    for (uint8_t i = 0; i < opt.boards; i++) {
+        sim[i & 1]->addBoard(new ThermocoupleBoardSim(i / 2 + 1));
+    }
+    nativeAttachRS485(0, sim[0]);
+    nativeAttachRS485(1, sim[1]);
+    bus1.begin(500000);
+    bus2.begin(500000);
+
+    configureBoards(opt);
+    apply_board_configs();
+    int result = 0;
+    if (!publishBoards(opt)) {
+        fprintf(stderr, "[bench] Boards were not published\n");
+        result = 1;
+    }
+
+    WiFiClient client;
+    if (result == 0) {
+        modbusServer.begin(opt.port);
+        if (!client.connect("127.0.0.1", opt.port + nativePortOffset())) {
+            fprintf(stderr, "[bench] Failed to connect to the Modbus TCP server\n");
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        client.setNoDelay(true);
+        bool found = false;
+        for (const auto &mix : mixes) {
+            if (strcmp(opt.mix, "all") != 0 && strcmp(opt.mix, mix.name) != 0) continue;
+            found = true;
+            runMix(mix, opt, client);
+        }
+        if (!found) {
+            usage(argv[0]);
+            result = 2;
+        }
+        client.stop();
+        modbusServer.stop();
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return result;
+}
@@ -4,7 +4,11 @@ PlatformIO Build Script for Web Asset Minification
 Minifies JS and CSS files from /web folder and copies to /data folder
 """
 
+import gzip
+import hashlib
+import json
 import os
+import re
 import shutil
 import subprocess
 import sys
@@ -200,6 +204,8 @@ def minify_files(target=None, source=None, env=None):
                 shutil.copy2(font_file, output_file)
     
     print("Web asset minification completed!")
+
+    compress_assets(data_dir)
     
     # Clean up package files
     for file in ["package.json", "package-lock.json"]:
@@ -208,6 +214,87 @@ def minify_files(target=None, source=None, env=None):
     if os.path.exists("node_modules"):
         shutil.rmtree("node_modules")
 
+# Precompression and fingerprinting ------------------------------------------>
+# Served files get a content hash in /assets.json. The web server sends it as a strong ETag, answers
+# If-None-Match with 304 and lets browsers keep a file for a year when it is requested with ?v=<hash>,
+# so references between assets are rewritten to carry the hash of the file they point to.
+ASSET_MANIFEST = "assets.json"
+ASSET_HASH_LENGTH = 16                                  # Hex digits, WEB_ASSET_HASH_LENGTH in network.h
+GZIP_EXTENSIONS = {".html", ".css", ".js", ".json", ".svg", ".ico"}   # png and woff2 are compressed already
+GZIP_MIN_SAVING = 0.1                                   # Keep a .gz only when it saves at least 10%
+REFERENCE_EXTENSIONS = {".html", ".css", ".js"}         # Files whose references to other assets are versioned
+
+def asset_url(path, data_dir):
+    """Site path of a file in data_dir, as requested by the browser"""
+    return "/" + path.relative_to(data_dir).as_posix()
+
+def asset_references(path, content, data_dir, assets):
+    """Site paths of the assets referenced from a text file with their offsets in it.
+    URLs in HTML and CSS are relative to the file, URLs in scripts to the page (index.html)."""
+    base = path.parent if path.suffix in (".html", ".css") else data_dir
+    found = []
+    for match in re.finditer(r'(?<=["\'(])((?:\./)?[\w./-]+?)(?:\?v=[0-9a-f]+)?(?=["\')])', content):
+        target = (base / match.group(1)).resolve()
+        if target.is_relative_to(data_dir.resolve()):
+            url = asset_url(target, data_dir.resolve())
+            if url in assets and target != path.resolve():
+                found.append((match.start(), match.end(), match.group(1), url))
+    return found
+
+def compress_assets(data_dir):
+    """Version asset references, write .gz variants and the hash manifest to data_dir"""
+    data_dir = Path(data_dir)
+    files = sorted(p for p in data_dir.rglob("*")
+                   if p.is_file() and p.suffix != ".gz" and p.name != ASSET_MANIFEST)
+    assets = {asset_url(p, data_dir): p for p in files}
+    hashes = {}
+
+    # Hash an asset after the assets it references, their hashes are part of its content
+    def fingerprint(url, visiting=()):
+        if url in hashes:
+            return hashes[url]
+        path = assets[url]
+        if path.suffix in REFERENCE_EXTENSIONS:
+            content = path.read_text(encoding="utf-8")
+            versioned = []
+            last = 0
+            for start, end, reference, target in asset_references(path, content, data_dir, assets):
+                if target in visiting:
+                    continue
+                versioned.append(content[last:start])
+                versioned.append(f"{reference}?v={fingerprint(target, visiting + (url,))}")
+                last = end
+            versioned.append(content[last:])
+            versioned = "".join(versioned)
+            if versioned != content:
+                print(f"Versioned references: {url}")
+                path.write_text(versioned, encoding="utf-8")
+        hashes[url] = hashlib.sha256(path.read_bytes()).hexdigest()[:ASSET_HASH_LENGTH]
+        return hashes[url]
+
+    manifest = {}
+    for url, path in assets.items():
+        fingerprint(url)
+        gz_path = path.with_name(path.name + ".gz")
+        compressed = False
+        if path.suffix in GZIP_EXTENSIONS:
+            content = path.read_bytes()
+            # mtime 0 keeps the output identical for identical input
+            packed = gzip.compress(content, compresslevel=9, mtime=0)
+            if len(packed) <= len(content) * (1 - GZIP_MIN_SAVING):
+                if not gz_path.exists() or gz_path.read_bytes() != packed:
+                    gz_path.write_bytes(packed)
+                print(f"Compressed: {url} {len(content)} -> {len(packed)} bytes")
+                compressed = True
+        if not compressed and gz_path.exists():
+            gz_path.unlink()
+        manifest[url] = {"hash": hashes[url], "gzip": compressed}
+
+    with open(data_dir / ASSET_MANIFEST, "w", encoding="utf-8") as f:
+        json.dump(manifest, f, indent=1, sort_keys=True)
+        f.write("\n")
+    print(f"Asset manifest written: {len(manifest)} files")
+
 def build_filesystem(target=None, source=None, env=None):
     """Build the filesystem image after minification"""
     print("Building filesystem image...")
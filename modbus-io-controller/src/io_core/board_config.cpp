@@ -1,11 +1,17 @@
 #include "board_config.h"
 #include "io_core.h"
+#include "../utils/jsonStream.h"
 #include <WebServer.h>
+#include <atomic>
 
 // Global variables
 BoardConfig boardConfigs[MAX_BOARDS];
 uint8_t boardCount = 0;
 
+// Set when a config is changed outside the web API, see manageBoardConfig()
+static std::atomic<bool> boardConfigChanged(false);
+static uint32_t lastBoardConfigSave = 0;
+
 // Initialise board configuration
 void init_board_config(void) {
     // Load existing configuration from LittleFS
@@ -32,6 +38,22 @@ bool saveBoardConfig() {
     return saveBoardConfigBinary();
 }
 
+// Request a save of configs changed by the poller on core 1 (Modbus TCP writes applied by a board)
+void markBoardConfigChanged(void) {
+    boardConfigChanged = true;
+}
+
+// Called from the core 0 loop, the config file is written from core 0 only. Writes that arrive in
+// quick succession are saved together, at most every BOARD_CONFIG_SAVE_INTERVAL_MS.
+void manageBoardConfig(void) {
+    if (!boardConfigChanged || millis() - lastBoardConfigSave < BOARD_CONFIG_SAVE_INTERVAL_MS) return;
+    boardConfigChanged = false;
+    lastBoardConfigSave = millis();
+    if (!saveBoardConfig()) {
+        log(LOG_WARNING, true, "Failed to save board configuration changed over Modbus TCP\n");
+    }
+}
+
 // Set up API endpoints for board configuration
 void setupBoardConfigAPI() {
     log(LOG_INFO, false, "Setting up board configuration API\n");
@@ -100,74 +122,71 @@ void setupBoardConfigAPI() {
     log(LOG_INFO, false, "Board API setup complete\n");
 }
 
-void handleGetBoardConfig() {
-    // Add CORS headers
-    server.sendHeader("Access-Control-Allow-Origin", "*");
-    server.sendHeader("Access-Control-Allow-Methods", "GET");
-    server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
-
-    // If there are no boards, return an empty array
-    if (boardCount == 0) {
-        server.send(200, "application/json", "{\"boards\":[]}");
-        return;
-    }
-    
-    // Create JSON response with smaller buffer (was 4096, now optimized)
-    DynamicJsonDocument doc(2048);
-    JsonArray boards = doc.createNestedArray("boards");
-    
-    // Add each board to the JSON response
+// Write {"boards":[...]} with every board's configuration, shared by the config API and export
+static void writeBoardsJson(JsonStream &json) {
+    json.beginObject();
+    json.beginArray("boards");
     for (uint8_t i = 0; i < boardCount; i++) {
-        JsonObject board = boards.createNestedObject();
+        BoardConfig *config = &boardConfigs[i];
+        json.beginObject();
         
-        // Add common board properties
-        board["id"] = i; // Board ID for frontend reference
-        board["name"] = boardConfigs[i].boardName;
-        board["type"] = boardConfigs[i].type;
-        board["type_name"] = getDeviceTypeName(boardConfigs[i].type);
-        board["board_index"] = boardConfigs[i].boardIndex;
-        board["slave_id"] = boardConfigs[i].slaveID;
-        board["modbus_port"] = boardConfigs[i].modbusPort;
-        board["poll_time"] = boardConfigs[i].pollTime;
-        board["record_interval"] = boardConfigs[i].recordInterval;
-        board["initialised"] = boardConfigs[i].initialised; // Add initialization status
-        board["connected"] = boardConfigs[i].connected; // Add connection status
+        // Common board properties
+        json.add("id", i); // Board ID for frontend reference
+        json.add("name", config->boardName);
+        json.add("type", config->type);
+        json.add("type_name", getDeviceTypeName(config->type));
+        json.add("board_index", config->boardIndex);
+        json.add("slave_id", config->slaveID);
+        json.add("modbus_port", config->modbusPort);
+        json.add("tcp_unit_id", config->tcpUnitId);
+        json.add("poll_time", config->pollTime);
+        json.add("record_interval", config->recordInterval);
+        json.add("initialised", config->initialised);
+        json.add("connected", config->connected);
         
-        // Add board-specific settings based on type
-        if (boardConfigs[i].type == THERMOCOUPLE_IO) {
-            JsonArray channels = board.createNestedArray("channels");
-            
+        // Board-specific settings based on type
+        if (config->type == THERMOCOUPLE_IO) {
+            json.beginArray("channels");
             for (int j = 0; j < 8; j++) {
-                JsonObject channel = channels.createNestedObject();
-                
-                channel["alert_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEnable;
-                channel["output_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].outputEnable;
-                channel["alert_latch"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertLatch;
-                channel["alert_edge"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEdge;
-                channel["tc_type"] = boardConfigs[i].settings.thermocoupleIO.channels[j].tcType;
-                channel["alert_setpoint"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertSetpoint;
-                channel["alert_hysteresis"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertHysteresis;
-                channel["channel_name"] = boardConfigs[i].settings.thermocoupleIO.channels[j].channelName;
-                channel["record_temperature"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordTemperature;
-                channel["record_cold_junction"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordColdJunction;
-                channel["record_status"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordStatus;
-                channel["show_on_dashboard"] = boardConfigs[i].settings.thermocoupleIO.channels[j].showOnDashboard;
-                channel["monitor_fault"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorFault;
-                channel["monitor_alarm"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorAlarm;
+                auto &channel = config->settings.thermocoupleIO.channels[j];
+                json.beginObject();
+                json.add("alert_enable", channel.alertEnable);
+                json.add("output_enable", channel.outputEnable);
+                json.add("alert_latch", channel.alertLatch);
+                json.add("alert_edge", channel.alertEdge);
+                json.add("tc_type", channel.tcType);
+                json.add("alert_setpoint", channel.alertSetpoint);
+                json.add("alert_hysteresis", channel.alertHysteresis);
+                json.add("channel_name", channel.channelName);
+                json.add("record_temperature", channel.recordTemperature);
+                json.add("record_cold_junction", channel.recordColdJunction);
+                json.add("record_status", channel.recordStatus);
+                json.add("show_on_dashboard", channel.showOnDashboard);
+                json.add("monitor_fault", channel.monitorFault);
+                json.add("monitor_alarm", channel.monitorAlarm);
+                json.endObject();
             }
+            json.endArray();
         }
         // Add more board types as needed
+        json.endObject();
     }
-    
-    // Debug the response
-    String debugResponse;
-    serializeJson(doc, debugResponse);
-    
-    // Send response
-    String response;
-    serializeJson(doc, response);
-    log(LOG_DEBUG, false, "handleGetBoardConfig API response size: %d, doc size: %d\n", response.length(), doc.memoryUsage());
-    server.send(200, "application/json", response);
+    json.endArray();
+    json.endObject();
+}
+
+void handleGetBoardConfig() {
+    // Add CORS headers
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+    server.sendHeader("Access-Control-Allow-Methods", "GET");
+    server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
+
+    // Streamed a board at a time, the response is larger than a document worth keeping on the heap
+    JsonStream json(server);
+    json.begin();
+    writeBoardsJson(json);
+    size_t length = json.end();
+    log(LOG_DEBUG, false, "handleGetBoardConfig API response size: %d, free heap: %d\n", length, rp2040.getFreeHeap());
 }
 
 void handleAddBoard() {
@@ -218,11 +237,17 @@ void handleAddBoard() {
     const char* name = doc["name"] | "Unnamed";
     int type = doc["type"] | 0;
     int modbusPort = doc["modbus_port"] | 0;
+    int tcpUnitId = doc["tcp_unit_id"] | 0;
     int pollTime = doc["poll_time"] | 15000;
     int recordInterval = doc["record_interval"] | 15000;
     
     log(LOG_INFO, true, "Adding board: %s, type: %d, port: %d, poll: %d, record: %d\n", 
         name, type, modbusPort, pollTime, recordInterval);
+
+    if (tcpUnitId < 0 || tcpUnitId > TCP_UNIT_ID_MAX || (tcpUnitId && tcpUnitIdInUse(tcpUnitId, 255))) {
+        server.send(400, "application/json", "{\"error\":\"Invalid or duplicate TCP unit ID\"}");
+        return;
+    }
     
     // Create new board config at the end of the array
     BoardConfig newBoard;
@@ -231,6 +256,7 @@ void handleAddBoard() {
     newBoard.boardIndex = boardCount; // Use boardCount as index
     newBoard.slaveID = 1; // Default slave ID
     newBoard.modbusPort = modbusPort;
+    newBoard.tcpUnitId = tcpUnitId;
     newBoard.pollTime = pollTime;
     newBoard.recordInterval = recordInterval;
     newBoard.initialised = false; // New boards are not initialised by default
@@ -292,14 +318,14 @@ void handleAddBoard() {
         log(LOG_INFO, false, "Applied board configurations\n");
         
         // Create response with the new board
-        DynamicJsonDocument responseDoc(1024);
-        responseDoc["success"] = true;
-        responseDoc["message"] = "Board added successfully";
-        responseDoc["id"] = boardCount - 1; // ID of the newly added board
-        
-        String response;
-        serializeJson(responseDoc, response);
-        server.send(200, "application/json", response);
+        JsonStream json(server);
+        json.begin();
+        json.beginObject();
+        json.add("success", true);
+        json.add("message", "Board added successfully");
+        json.add("id", boardCount - 1); // ID of the newly added board
+        json.endObject();
+        json.end();
         
         log(LOG_INFO, true, "Board added successfully, new count: %d\n", boardCount);
     } else {
@@ -360,11 +386,20 @@ void handleUpdateBoard() {
     if (doc.containsKey("modbus_port")) {
         updatedBoard.modbusPort = doc["modbus_port"];
     }
+
+    if (doc.containsKey("tcp_unit_id")) {
+        int tcpUnitId = doc["tcp_unit_id"];
+        if (tcpUnitId < 0 || tcpUnitId > TCP_UNIT_ID_MAX || (tcpUnitId && tcpUnitIdInUse(tcpUnitId, boardId))) {
+            server.send(400, "application/json", "{\"error\":\"Invalid or duplicate TCP unit ID\"}");
+            return;
+        }
+        updatedBoard.tcpUnitId = tcpUnitId;
+    }
     
     if (doc.containsKey("poll_time")) {
         uint32_t pollTime = doc["poll_time"];
-        if (pollTime < 1000) pollTime = 1000; // Minimum 1 second
-        if (pollTime > 3600000) pollTime = 3600000; // Maximum 1 hour
+        if (pollTime < MIN_POLL_TIME) pollTime = MIN_POLL_TIME; // Minimum 20 ms
+        if (pollTime > MAX_POLL_TIME) pollTime = MAX_POLL_TIME; // Maximum 1 hour
         updatedBoard.pollTime = pollTime;
     }
 
@@ -505,138 +540,24 @@ void handleGetAllBoards() {
     server.sendHeader("Access-Control-Allow-Methods", "GET");
     server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
     
-    // If there are no boards, return an empty array
-    if (boardCount == 0) {
-        server.send(200, "application/json", "{\"boards\":[]}");
-        return;
-    }
-    
-    // Create JSON response
-    DynamicJsonDocument doc(32768);
-    JsonArray boards = doc.createNestedArray("boards");
-    
-    // Add each board to the JSON response
-    for (uint8_t i = 0; i < boardCount; i++) {
-        JsonObject board = boards.createNestedObject();
-        
-        // Add common board properties
-        board["id"] = i; // Board ID for frontend reference
-        board["name"] = boardConfigs[i].boardName;
-        board["type"] = boardConfigs[i].type;
-        board["type_name"] = getDeviceTypeName(boardConfigs[i].type);
-        board["board_index"] = boardConfigs[i].boardIndex;
-        board["slave_id"] = boardConfigs[i].slaveID;
-        board["modbus_port"] = boardConfigs[i].modbusPort;
-        board["poll_time"] = boardConfigs[i].pollTime;
-        board["record_interval"] = boardConfigs[i].recordInterval;
-        board["initialised"] = boardConfigs[i].initialised; // Add initialization status
-        board["connected"] = boardConfigs[i].connected; // Add connection status
-        
-        // Add board-specific settings based on type
-        if (boardConfigs[i].type == THERMOCOUPLE_IO) {
-            JsonArray channels = board.createNestedArray("channels");
-            
-            for (int j = 0; j < 8; j++) {
-                JsonObject channel = channels.createNestedObject();
-                
-                channel["alert_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEnable;
-                channel["output_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].outputEnable;
-                channel["alert_latch"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertLatch;
-                channel["alert_edge"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEdge;
-                channel["tc_type"] = boardConfigs[i].settings.thermocoupleIO.channels[j].tcType;
-                channel["alert_setpoint"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertSetpoint;
-                channel["alert_hysteresis"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertHysteresis;
-                channel["channel_name"] = boardConfigs[i].settings.thermocoupleIO.channels[j].channelName;
-                channel["record_temperature"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordTemperature;
-                channel["record_cold_junction"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordColdJunction;
-                channel["record_status"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordStatus;
-                channel["show_on_dashboard"] = boardConfigs[i].settings.thermocoupleIO.channels[j].showOnDashboard;
-                channel["monitor_fault"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorFault;
-                channel["monitor_alarm"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorAlarm;
-            }
-        }
-        // Add more board types as needed
-    }
-    
-    // Debug the response
-    String debugResponse;
-    serializeJson(doc, debugResponse);
-    
-    // Send response
-    String response;
-    serializeJson(doc, response);
-    log(LOG_DEBUG, false, "handleGetAllBoards API response size: %d, doc size: %d\n", response.length(), doc.memoryUsage());
-    server.send(200, "application/json", response);
+    JsonStream json(server);
+    json.begin();
+    writeBoardsJson(json);
+    size_t length = json.end();
+    log(LOG_DEBUG, false, "handleGetAllBoards API response size: %d, free heap: %d\n", length, rp2040.getFreeHeap());
 }
 
 void handleExportConfig() {
     log(LOG_INFO, true, "Exporting board configuration from binary storage\n");
     
-    // Check if we have any boards to export
-    if (boardCount == 0) {
-        server.send(200, "application/json", "{\"boards\":[]}");
-        log(LOG_INFO, true, "No boards to export\n");
-        return;
-    }
-    
-    // Create JSON response using the same logic as handleGetBoardConfig
-    DynamicJsonDocument doc(32768);
-    JsonArray boards = doc.createNestedArray("boards");
-    
-    // Add each board to the JSON response
-    for (uint8_t i = 0; i < boardCount; i++) {
-        JsonObject board = boards.createNestedObject();
-        
-        // Add common board properties
-        board["id"] = i; // Board ID for frontend reference
-        board["name"] = boardConfigs[i].boardName;
-        board["type"] = boardConfigs[i].type;
-        board["type_name"] = getDeviceTypeName(boardConfigs[i].type);
-        board["board_index"] = boardConfigs[i].boardIndex;
-        board["slave_id"] = boardConfigs[i].slaveID;
-        board["modbus_port"] = boardConfigs[i].modbusPort;
-        board["poll_time"] = boardConfigs[i].pollTime;
-        board["record_interval"] = boardConfigs[i].recordInterval;
-        board["initialised"] = boardConfigs[i].initialised;
-        board["connected"] = boardConfigs[i].connected;
-        
-        // Add board-specific settings based on type
-        if (boardConfigs[i].type == THERMOCOUPLE_IO) {
-            JsonArray channels = board.createNestedArray("channels");
-            
-            for (int j = 0; j < 8; j++) {
-                JsonObject channel = channels.createNestedObject();
-                
-                // Add channel properties
-                channel["alert_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEnable;
-                channel["output_enable"] = boardConfigs[i].settings.thermocoupleIO.channels[j].outputEnable;
-                channel["alert_latch"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertLatch;
-                channel["alert_edge"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertEdge;
-                channel["tc_type"] = boardConfigs[i].settings.thermocoupleIO.channels[j].tcType;
-                channel["alert_setpoint"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertSetpoint;
-                channel["alert_hysteresis"] = boardConfigs[i].settings.thermocoupleIO.channels[j].alertHysteresis;
-                channel["channel_name"] = boardConfigs[i].settings.thermocoupleIO.channels[j].channelName;
-                channel["record_temperature"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordTemperature;
-                channel["record_cold_junction"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordColdJunction;
-                channel["record_status"] = boardConfigs[i].settings.thermocoupleIO.channels[j].recordStatus;
-                channel["show_on_dashboard"] = boardConfigs[i].settings.thermocoupleIO.channels[j].showOnDashboard;
-                channel["monitor_fault"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorFault;
-                channel["monitor_alarm"] = boardConfigs[i].settings.thermocoupleIO.channels[j].monitorAlarm;
-            }
-        }
-    }
-    
-    // Convert JSON to string
-    String jsonString;
-    serializeJsonPretty(doc, jsonString);
-    
     // Set headers for file download
     server.sendHeader("Content-Disposition", "attachment; filename=\"board_config.json\"");
-    server.sendHeader("Content-Type", "application/json");
-    server.sendHeader("Content-Length", String(jsonString.length()));
     
-    // Send JSON content
-    server.send(200, "application/json", jsonString);
+    // Same content as handleGetBoardConfig, pretty printed for the file
+    JsonStream json(server, true);
+    json.begin();
+    writeBoardsJson(json);
+    json.end();
     
     log(LOG_INFO, true, "Board configuration exported successfully (%d boards)\n", boardCount);
 }
@@ -757,6 +678,7 @@ void handleImportConfig() {
                     newBoard.boardIndex = boardCount;
                     newBoard.slaveID = board["slave_id"] | 1;
                     newBoard.modbusPort = board["modbus_port"] | 0;
+                    newBoard.tcpUnitId = board["tcp_unit_id"] | 0;
                     newBoard.pollTime = board["poll_time"] | 15000;
                     newBoard.recordInterval = board["record_interval"] | 15000;
                     
@@ -1072,6 +994,17 @@ uint8_t assignSlaveID(uint8_t modbusPort) {
     return 247;
 }
 
+// Check if another board answers Modbus TCP requests on a unit ID (configured, or its slave ID)
+bool tcpUnitIdInUse(uint8_t unitId, uint8_t exceptIndex) {
+    for (uint8_t i = 0; i < boardCount; i++) {
+        if (i == exceptIndex) continue;
+        uint8_t boardUnitId = boardConfigs[i].tcpUnitId;
+        if (!boardUnitId && boardConfigs[i].initialised) boardUnitId = boardConfigs[i].slaveID;
+        if (boardUnitId == unitId) return true;
+    }
+    return false;
+}
+
 // Helper function to get device type name
 const char* getDeviceTypeName(deviceType_t type) {
     switch (type) {
@@ -1190,6 +1123,7 @@ bool saveBoardConfigBinary() {
         binaryBoard.boardIndex = boardConfigs[i].boardIndex;
         binaryBoard.slaveID = boardConfigs[i].slaveID;
         binaryBoard.modbusPort = boardConfigs[i].modbusPort;
+        binaryBoard.tcpUnitId = boardConfigs[i].tcpUnitId;
         binaryBoard.pollTime = boardConfigs[i].pollTime;
         binaryBoard.recordInterval = boardConfigs[i].recordInterval;
         
@@ -1297,6 +1231,7 @@ bool loadBoardConfigBinary() {
         boardConfigs[i].boardIndex = binaryBoard.boardIndex;
         boardConfigs[i].slaveID = binaryBoard.slaveID;
         boardConfigs[i].modbusPort = binaryBoard.modbusPort;
+        boardConfigs[i].tcpUnitId = binaryBoard.tcpUnitId <= TCP_UNIT_ID_MAX ? binaryBoard.tcpUnitId : 0;
         boardConfigs[i].pollTime = binaryBoard.pollTime;
         boardConfigs[i].recordInterval = binaryBoard.recordInterval;
         
@@ -13,6 +13,16 @@
 // Maximum board name length (13 chars + null terminator)
 #define MAX_BOARD_NAME_LENGTH 14
 
+// Modbus TCP unit IDs a board can be given (0 uses the board's slave ID)
+#define TCP_UNIT_ID_MAX 247
+
+// Minimum time between saves of configs changed over Modbus TCP (ms)
+#define BOARD_CONFIG_SAVE_INTERVAL_MS 5000
+
+// Poll time limits (ms)
+#define MIN_POLL_TIME 20
+#define MAX_POLL_TIME 3600000
+
 // Forward declaration of WebServer class from Arduino framework
 //class WebServer;
 extern WebServer server;
@@ -24,6 +34,7 @@ struct BoardConfig {
     uint8_t boardIndex;
     uint8_t slaveID;
     uint8_t modbusPort;
+    uint8_t tcpUnitId;  // Modbus TCP unit ID, 0 to use the slave ID
     uint32_t pollTime;
     uint32_t recordInterval;
     bool initialised; // Track if board has been initialised with address assignment
@@ -82,7 +93,8 @@ struct __attribute__((packed)) BinaryBoardConfig {
     uint32_t pollTime;
     uint32_t recordInterval;
     uint8_t flags;            // initialised, connected flags
-    uint8_t reserved[3];      // Padding for alignment
+    uint8_t tcpUnitId;        // Modbus TCP unit ID, 0 (as written by older firmware) uses the slave ID
+    uint8_t reserved[2];      // Padding for alignment
     
     // Board-specific data follows
     union {
@@ -113,6 +125,8 @@ void init_board_config(void);
 bool loadBoardConfig(void);
 bool saveBoardConfig(void);
 void setupBoardConfigAPI(void);
+void markBoardConfigChanged(void);
+void manageBoardConfig(void);
 
 // Binary serialization functions
 bool saveBoardConfigBinary(void);
@@ -140,6 +154,7 @@ uint8_t getBoardCount(void);
 BoardConfig* getBoard(uint8_t index);
 uint8_t assignBoardIndex(deviceType_t type);
 uint8_t assignSlaveID(uint8_t modbusPort);
+bool tcpUnitIdInUse(uint8_t unitId, uint8_t exceptIndex);
 bool initialiseBoard(uint8_t index);
 
 // Helper functions
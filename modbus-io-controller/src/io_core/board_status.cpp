@@ -2,10 +2,17 @@
 #include "io_core.h"
 #include "board_config.h"
 #include "../utils/logger.h"
-#include <ArduinoJson.h>
+#include "../utils/jsonStream.h"
+#include <math.h>
+#include <stddef.h>
 
 // Temperature history is removed to save RAM
 
+// Largest /api/live response or live event, 8 boards of 16 temperatures plus flags
+#define LIVE_DATA_BUFFER_SIZE 3072
+#define LIVE_EVENT_CLIENTS 4            // Browsers subscribed to /api/events at once
+#define LIVE_EVENT_KEEPALIVE_MS 15000
+
 // Setup the API endpoints for board status
 void setupBoardStatusAPI() {
     log(LOG_INFO, false, "Setting up board status API\n");
@@ -42,6 +49,15 @@ void setupBoardStatusAPI() {
     
     // Get thermocouple data for a specific board
     server.on("/api/status/tc", HTTP_GET, handleGetThermocoupleData);
+
+    // Get the changing values of every board in one response (dashboard refresh)
+    server.on("/api/live", HTTP_GET, handleGetLiveData);
+
+    // Describe the binary layout of /api/live and /api/status/tc (?format=bin)
+    server.on("/api/live/schema", HTTP_GET, handleGetTelemetrySchema);
+
+    // Stream the changes to the live values as they are published
+    server.on("/api/events", HTTP_GET, handleLiveEvents);
     
     // Reset a specific channel's latched alarm
     server.on("/api/status/reset_alarm", HTTP_GET, handleResetAlarm);
@@ -59,13 +75,9 @@ void handleGetAllBoardsStatus() {
     server.sendHeader("Access-Control-Allow-Methods", "GET");
     server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
     
-    // Create JSON document to hold response
-    const size_t capacity = JSON_ARRAY_SIZE(MAX_BOARDS) + 
-                           MAX_BOARDS * JSON_OBJECT_SIZE(5); // Each board has 5 basic properties
-    DynamicJsonDocument doc(capacity);
-    
-    // Create JSON array for boards
-    JsonArray boardsArray = doc.to<JsonArray>();
+    JsonStream json(server);
+    json.begin();
+    json.beginArray();
     
     // Add basic status for each board
     for (uint8_t i = 0; i < boardCount; i++) {
@@ -73,18 +85,17 @@ void handleGetAllBoardsStatus() {
         BoardConfig* config = &boardConfigs[i];
         
         // Add board basic information
-        JsonObject boardObj = boardsArray.createNestedObject();
-        boardObj["id"] = i;
-        boardObj["name"] = config->boardName;
-        boardObj["type"] = getDeviceTypeName(config->type);
-        boardObj["initialised"] = config->initialised;
-        boardObj["connected"] = config->connected;
-    }
-    
-    // Return the response
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+        json.beginObject();
+        json.add("id", i);
+        json.add("name", config->boardName);
+        json.add("type", getDeviceTypeName(config->type));
+        json.add("initialised", config->initialised);
+        json.add("connected", config->connected);
+        json.endObject();
+    }
+    
+    json.endArray();
+    json.end();
 }
 
 // Handler for getting detailed status of a specific board
@@ -112,69 +123,106 @@ void handleGetBoardStatus() {
     // Get the board configuration
     BoardConfig* config = &boardConfigs[boardId];
     
-    // Create JSON document to hold response
-    DynamicJsonDocument doc(4096);
+    JsonStream json(server);
+    json.begin();
+    json.beginObject();
     
     // Add board information
-    doc["id"] = boardId;
-    doc["name"] = config->boardName;
-    doc["type"] = getDeviceTypeName(config->type);
-    doc["initialised"] = config->initialised;
-    doc["connected"] = config->connected;
-    doc["slave_id"] = config->slaveID;
-    doc["modbus_port"] = config->modbusPort;
-    doc["poll_time"] = config->pollTime;
+    json.add("id", boardId);
+    json.add("name", config->boardName);
+    json.add("type", getDeviceTypeName(config->type));
+    json.add("initialised", config->initialised);
+    json.add("connected", config->connected);
+    json.add("slave_id", config->slaveID);
+    json.add("modbus_port", config->modbusPort);
+    json.add("poll_time", config->pollTime);
+
+    // Poll timing statistics (lateness in microseconds)
+    pollStats_t *pollStats = getPollStats(config->boardIndex);
+    if (pollStats) {
+        json.beginObject("poll_stats");
+        json.add("polls", pollStats->polls);
+        json.add("missed", pollStats->missed);
+        json.add("last_lateness_us", pollStats->lastLateness);
+        json.add("max_lateness_us", pollStats->maxLateness);
+        json.add("avg_lateness_us", pollStats->avgLateness);
+        json.endObject();
+    }
+
+    // Response timing and offline backoff (times in microseconds)
+    linkState_t *link = getLinkState(config->boardIndex);
+    if (link) {
+        json.beginObject("link");
+        json.add("srtt_us", link->srtt);
+        json.add("rttvar_us", link->rttvar);
+        json.add("last_rtt_us", link->lastRtt);
+        json.add("timeout_us", link->timeout);
+        json.add("timeouts", link->timeouts);
+        json.add("backoff", link->backoff);
+        json.endObject();
+    }
     
     // Add type-specific information
     switch (config->type) {
         case THERMOCOUPLE_IO: {
             // Get the thermocouple board index
             uint8_t tcIndex = config->boardIndex;
+
+            // Consistent copy of the registers last read by the poller
+            thermocoupleSnapshot_t snapshot;
+            thermocouple_read_snapshot(tcIndex, &snapshot);
             
             // Add thermocouple-specific information
-            JsonObject tcObj = doc.createNestedObject("thermocouple");
+            json.beginObject("thermocouple");
+            json.add("data_age_ms", snapshot.timestamp ? (uint32_t)((time_us_64() - snapshot.timestamp) / 1000) : 0);
             
             // Board status information
-            tcObj["status"] = thermocoupleIO_index.tcIO[tcIndex].reg.status;
-            tcObj["board_type"] = thermocoupleIO_index.tcIO[tcIndex].reg.boardType;
-            tcObj["last_update"] = thermocoupleIO_index.tcIO[tcIndex].lastUpdate;
-            tcObj["psu_voltage"] = thermocoupleIO_index.tcIO[tcIndex].Vpsu;
+            json.add("status", snapshot.reg.status);
+            json.add("board_type", snapshot.reg.boardType);
+            json.add("last_update", thermocoupleIO_index.tcIO[tcIndex].lastUpdate);
+            json.add("psu_voltage", thermocoupleIO_index.tcIO[tcIndex].Vpsu);
             
             // Error flags
-            JsonObject errorObj = tcObj.createNestedObject("errors");
-            errorObj["modbus"] = thermocoupleIO_index.tcIO[tcIndex].modbusError;
-            errorObj["i2c"] = thermocoupleIO_index.tcIO[tcIndex].I2CError;
-            errorObj["psu"] = thermocoupleIO_index.tcIO[tcIndex].PSUError;
+            json.beginObject("errors");
+            json.add("modbus", thermocoupleIO_index.tcIO[tcIndex].modbusError);
+            json.add("i2c", thermocoupleIO_index.tcIO[tcIndex].I2CError);
+            json.add("psu", thermocoupleIO_index.tcIO[tcIndex].PSUError);
+            json.endObject();
             
             // Channel data
-            JsonArray channelsArray = tcObj.createNestedArray("channels");
+            json.beginArray("channels");
             for (int ch = 0; ch < 8; ch++) {
-                JsonObject channelObj = channelsArray.createNestedObject();
-                channelObj["number"] = ch;
-                channelObj["temperature"] = thermocoupleIO_index.tcIO[tcIndex].reg.temperature[ch];
-                channelObj["cold_junction"] = thermocoupleIO_index.tcIO[tcIndex].reg.coldJunction[ch];
-                channelObj["delta_junction"] = thermocoupleIO_index.tcIO[tcIndex].reg.deltaJunction[ch];
-                channelObj["tc_type"] = thermocoupleIO_index.tcIO[tcIndex].reg.type[ch];
-                channelObj["alert_setpoint"] = thermocoupleIO_index.tcIO[tcIndex].reg.alertSP[ch];
-                channelObj["alarm_hysteresis"] = thermocoupleIO_index.tcIO[tcIndex].reg.alarmHyst[ch];
+                json.beginObject();
+                json.add("number", ch);
+                json.add("temperature", snapshot.reg.temperature[ch]);
+                json.add("cold_junction", snapshot.reg.coldJunction[ch]);
+                json.add("delta_junction", snapshot.reg.deltaJunction[ch]);
+                json.add("tc_type", snapshot.reg.type[ch]);
+                json.add("alert_setpoint", snapshot.reg.alertSP[ch]);
+                json.add("alarm_hysteresis", snapshot.reg.alarmHyst[ch]);
                 
                 // Include the channel name from board configuration
-                channelObj["channel_name"] = config->settings.thermocoupleIO.channels[ch].channelName;
+                json.add("channel_name", config->settings.thermocoupleIO.channels[ch].channelName);
                 
                 // Channel settings
-                JsonObject settingsObj = channelObj.createNestedObject("settings");
-                settingsObj["alert_enable"] = thermocoupleIO_index.tcIO[tcIndex].reg.alertEnable[ch];
-                settingsObj["output_enable"] = thermocoupleIO_index.tcIO[tcIndex].reg.outputEnable[ch];
-                settingsObj["alert_latch"] = thermocoupleIO_index.tcIO[tcIndex].reg.alertLatch[ch];
-                settingsObj["alert_edge"] = thermocoupleIO_index.tcIO[tcIndex].reg.alertEdge[ch];
+                json.beginObject("settings");
+                json.add("alert_enable", snapshot.reg.alertEnable[ch]);
+                json.add("output_enable", snapshot.reg.outputEnable[ch]);
+                json.add("alert_latch", snapshot.reg.alertLatch[ch]);
+                json.add("alert_edge", snapshot.reg.alertEdge[ch]);
+                json.endObject();
                 
                 // Channel status
-                JsonObject statusObj = channelObj.createNestedObject("status");
-                statusObj["output_state"] = thermocoupleIO_index.tcIO[tcIndex].reg.outputState[ch];
-                statusObj["alarm_state"] = thermocoupleIO_index.tcIO[tcIndex].reg.alarmState[ch];
-                statusObj["open_circuit"] = thermocoupleIO_index.tcIO[tcIndex].reg.openCircuit[ch];
-                statusObj["short_circuit"] = thermocoupleIO_index.tcIO[tcIndex].reg.shortCircuit[ch];
+                json.beginObject("status");
+                json.add("output_state", snapshot.reg.outputState[ch]);
+                json.add("alarm_state", snapshot.reg.alarmState[ch]);
+                json.add("open_circuit", snapshot.reg.openCircuit[ch]);
+                json.add("short_circuit", snapshot.reg.shortCircuit[ch]);
+                json.endObject();
+                json.endObject();
             }
+            json.endArray();
+            json.endObject();
             break;
         }
         
@@ -184,13 +232,8 @@ void handleGetBoardStatus() {
             break;
     }
     
-    // Return the response
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
-    // Debug logging to check that doc size is appropriate - don't delete
-    //log(LOG_DEBUG, false, "Board status doc size: %d bytes\n", doc.memoryUsage());
-    //log(LOG_DEBUG, false, "Board status response size: %d bytes\n", response.length());
+    json.endObject();
+    json.end();
 }
 
 // Handler for getting thermocouple data for a specific board
@@ -230,37 +273,426 @@ void handleGetThermocoupleData() {
         return;
     }
     
-    // Get the thermocouple board index
-    uint8_t tcIndex = config->boardIndex;
-    
-    // Create JSON document to hold response
-    DynamicJsonDocument doc(2048);
-    
-    // Add basic board information
-    doc["id"] = boardId;
-    doc["name"] = config->boardName;
-    
-    // Add temperature data
-    JsonArray temperatureArray = doc.createNestedArray("temperatures");
-    JsonArray alarmArray = doc.createNestedArray("alarms");
-    JsonArray faultArray = doc.createNestedArray("faults");
-    
-    for (int ch = 0; ch < 8; ch++) {
-        // Temperature data
-        temperatureArray.add(thermocoupleIO_index.tcIO[tcIndex].reg.temperature[ch]);
-        
-        // Alarm state
-        alarmArray.add(thermocoupleIO_index.tcIO[tcIndex].reg.alarmState[ch]);
-        
-        // Fault state (open or short circuit)
-        faultArray.add(thermocoupleIO_index.tcIO[tcIndex].reg.openCircuit[ch] || 
-                      thermocoupleIO_index.tcIO[tcIndex].reg.shortCircuit[ch]);
+    // Compact binary record on request, see /api/live/schema
+    if (server.arg("format") == "bin") {
+        uint8_t buffer[sizeof(TelemetryHeader) + sizeof(TelemetryBoard)];
+        size_t length = encode_thermocouple_binary(boardId, buffer, sizeof(buffer));
+        server.setContentLength(length);
+        server.send(200, "application/octet-stream", "");
+        server.sendContent((const char *)buffer, length);
+        return;
+    }
+
+    JsonStream json(server);
+    json.begin();
+    encode_thermocouple_json(boardId, json);
+    json.end();
+}
+
+size_t encode_thermocouple_json(uint8_t boardId, JsonStream &json) {
+    BoardConfig* config = &boardConfigs[boardId];
+
+    // Consistent copy of the registers last read by the poller
+    thermocoupleSnapshot_t snapshot;
+    thermocouple_read_snapshot(config->boardIndex, &snapshot);
+    
+    json.beginObject();
+    json.add("id", boardId);
+    json.add("name", config->boardName);
+    json.add("data_age_ms", snapshot.timestamp ? (uint32_t)((time_us_64() - snapshot.timestamp) / 1000) : 0);
+    
+    // Temperature, alarm and fault (open or short circuit) per channel
+    json.beginArray("temperatures");
+    for (int ch = 0; ch < 8; ch++) json.add(nullptr, snapshot.reg.temperature[ch]);
+    json.endArray();
+    json.beginArray("alarms");
+    for (int ch = 0; ch < 8; ch++) json.add(nullptr, snapshot.reg.alarmState[ch]);
+    json.endArray();
+    json.beginArray("faults");
+    for (int ch = 0; ch < 8; ch++) json.add(nullptr, snapshot.reg.openCircuit[ch] || snapshot.reg.shortCircuit[ch]);
+    json.endArray();
+    json.endObject();
+    return json.size();
+}
+
+// Live data ---------------------------------------------------------------->
+// Only the values that change between polls, for all boards at once, so a dashboard refresh is a
+// single small request instead of a full board status (with its config) per board. Written with
+// snprintf into a static buffer, the handlers all run on core 0 so one buffer is enough.
+//   {"uptime_ms":n,"boards":[{"id":0,"connected":true,"initialised":true,"data_age_ms":n,
+//    "temperature":[8],"cold_junction":[8],"output":m,"alarm":m,"open_circuit":m,"short_circuit":m,
+//    "psu_voltage":v,"errors":m},...]}
+// Flags are channel bit masks (bit n = channel n), errors is LIVE_ERROR_x bits, temperatures and
+// voltages have one decimal place.
+
+#define LIVE_NO_VALUE INT32_MIN     // Temperature that isn't a number, sent as null
+#define LIVE_ERROR_MODBUS   0x01
+#define LIVE_ERROR_I2C      0x02
+#define LIVE_ERROR_PSU      0x04
+
+// A board's live values as sent, temperatures in tenths of a degree
+struct liveValues_t {
+    bool valid;
+    bool connected;
+    bool initialised;
+    int32_t temperature[8];
+    int32_t coldJunction[8];
+    uint8_t output;
+    uint8_t alarm;
+    uint8_t openCircuit;
+    uint8_t shortCircuit;
+    int32_t psuVoltage;
+    uint8_t errors;
+};
+
+static char liveBuffer[LIVE_DATA_BUFFER_SIZE];
+
+// Append to the live buffer, returns false once it is full
+static bool live_append(size_t &length, const char *format, ...) {
+    if (length >= sizeof(liveBuffer)) return false;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(&liveBuffer[length], sizeof(liveBuffer) - length, format, args);
+    va_end(args);
+    if (written < 0 || length + written >= sizeof(liveBuffer)) {
+        length = sizeof(liveBuffer);
+        return false;
+    }
+    length += written;
+    return true;
+}
+
+static bool live_append_tenths(size_t &length, const char *key, const int32_t *values) {
+    bool ok = live_append(length, ",\"%s\":[", key);
+    for (uint8_t ch = 0; ch < 8 && ok; ch++) {
+        if (values[ch] == LIVE_NO_VALUE) ok = live_append(length, ch ? ",null" : "null");
+        else ok = live_append(length, ch ? ",%.1f" : "%.1f", values[ch] / 10.0);
+    }
+    return ok && live_append(length, "]");
+}
+
+static uint8_t live_mask(const bool *flags) {
+    uint8_t mask = 0;
+    for (uint8_t ch = 0; ch < 8; ch++) {
+        if (flags[ch]) mask |= 1 << ch;
+    }
+    return mask;
+}
+
+static void live_tenths(const float *values, int32_t *tenths) {
+    for (uint8_t ch = 0; ch < 8; ch++) {
+        tenths[ch] = isfinite(values[ch]) ? (int32_t)lroundf(values[ch] * 10) : LIVE_NO_VALUE;
+    }
+}
+
+// Read a board's live values from its published snapshot, returns the data age in ms
+static int32_t live_read(uint8_t id, liveValues_t *values) {
+    BoardConfig* config = &boardConfigs[id];
+    memset(values, 0, sizeof(*values));
+    values->valid = true;
+    values->connected = config->connected;
+    values->initialised = config->initialised;
+    if (config->type != THERMOCOUPLE_IO) return 0;
+
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[config->boardIndex];
+    values->psuVoltage = (int32_t)lroundf(tc->Vpsu * 10);
+    values->errors = (tc->modbusError ? LIVE_ERROR_MODBUS : 0) | (tc->I2CError ? LIVE_ERROR_I2C : 0) | (tc->PSUError ? LIVE_ERROR_PSU : 0);
+
+    thermocoupleSnapshot_t snapshot;
+    thermocouple_read_snapshot(config->boardIndex, &snapshot);
+    live_tenths(snapshot.reg.temperature, values->temperature);
+    live_tenths(snapshot.reg.coldJunction, values->coldJunction);
+    values->output = live_mask(snapshot.reg.outputState);
+    values->alarm = live_mask(snapshot.reg.alarmState);
+    values->openCircuit = live_mask(snapshot.reg.openCircuit);
+    values->shortCircuit = live_mask(snapshot.reg.shortCircuit);
+    return snapshot.timestamp ? (int32_t)min((time_us_64() - snapshot.timestamp) / 1000, (uint64_t)INT32_MAX) : 0;
+}
+
+// Append a board's values, or with sent only those that differ from it, and the data age if it
+// isn't negative. Returns false if the buffer is full.
+static bool live_append_board(size_t &length, bool first, uint8_t id, const liveValues_t *values, const liveValues_t *sent, int32_t dataAge) {
+    bool all = !sent || !sent->valid;
+    bool ok = live_append(length, "%s{\"id\":%u", first ? "" : ",", id);
+    if (ok && (all || values->connected != sent->connected)) {
+        ok = live_append(length, ",\"connected\":%s", values->connected ? "true" : "false");
+    }
+    if (ok && (all || values->initialised != sent->initialised)) {
+        ok = live_append(length, ",\"initialised\":%s", values->initialised ? "true" : "false");
+    }
+    if (boardConfigs[id].type == THERMOCOUPLE_IO) {
+        if (ok && dataAge >= 0) ok = live_append(length, ",\"data_age_ms\":%ld", (long)dataAge);
+        if (ok && (all || memcmp(values->temperature, sent->temperature, sizeof(values->temperature)) != 0)) {
+            ok = live_append_tenths(length, "temperature", values->temperature);
+        }
+        if (ok && (all || memcmp(values->coldJunction, sent->coldJunction, sizeof(values->coldJunction)) != 0)) {
+            ok = live_append_tenths(length, "cold_junction", values->coldJunction);
+        }
+        if (ok && (all || values->output != sent->output)) ok = live_append(length, ",\"output\":%u", values->output);
+        if (ok && (all || values->alarm != sent->alarm)) ok = live_append(length, ",\"alarm\":%u", values->alarm);
+        if (ok && (all || values->openCircuit != sent->openCircuit)) ok = live_append(length, ",\"open_circuit\":%u", values->openCircuit);
+        if (ok && (all || values->shortCircuit != sent->shortCircuit)) ok = live_append(length, ",\"short_circuit\":%u", values->shortCircuit);
+        if (ok && (all || values->psuVoltage != sent->psuVoltage)) ok = live_append(length, ",\"psu_voltage\":%.1f", values->psuVoltage / 10.0);
+        if (ok && (all || values->errors != sent->errors)) ok = live_append(length, ",\"errors\":%u", values->errors);
+    }
+    return ok && live_append(length, "}");
+}
+
+// Build the live data for every board into the buffer after prefix, returns the length or 0 if
+// it doesn't fit. The values written are copied to sent if given.
+static size_t live_build(const char *prefix, liveValues_t *sent = nullptr) {
+    size_t length = 0;
+    bool ok = live_append(length, "%s{\"uptime_ms\":%lu,\"boards\":[", prefix, (unsigned long)millis());
+    for (uint8_t i = 0; i < boardCount && ok; i++) {
+        liveValues_t values;
+        int32_t dataAge = live_read(i, &values);
+        ok = live_append_board(length, i == 0, i, &values, nullptr, dataAge);
+        if (sent) memcpy(&sent[i], &values, sizeof(values));
+    }
+    ok = ok && live_append(length, "]}");
+    return ok ? length : 0;
+}
+
+size_t encode_live_json(const char **data) {
+    *data = liveBuffer;
+    return live_build("");
+}
+
+void handleGetLiveData() {
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+    server.sendHeader("Cache-Control", "no-store");
+
+    // The binary records reuse the live buffer
+    bool binary = server.arg("format") == "bin";
+    const char *data = liveBuffer;
+    size_t length = binary ? encode_live_binary((uint8_t *)liveBuffer, sizeof(liveBuffer)) : encode_live_json(&data);
+    if (!length) {
+        server.send(500, "application/json", "{\"error\":\"Live data too large\"}");
+        return;
+    }
+    server.setContentLength(length);
+    server.send(200, binary ? "application/octet-stream" : "application/json", "");
+    server.sendContent(data, length);
+}
+
+// Binary telemetry --------------------------------------------------------->
+// The records are filled from the same values as the live JSON and written as they are, both the
+// RP2040 and the hosts running the native build are little-endian.
+
+static_assert(sizeof(TelemetryHeader) == 8, "Telemetry header layout changed, update the version");
+static_assert(sizeof(TelemetryBoard) == 44, "Telemetry record layout changed, update the version");
+
+static int16_t telemetry_tenths(int32_t tenths) {
+    if (tenths == LIVE_NO_VALUE) return TELEMETRY_NO_VALUE;
+    return (int16_t)constrain(tenths, (int32_t)INT16_MIN + 1, (int32_t)INT16_MAX);
+}
+
+static void telemetry_board(uint8_t id, TelemetryBoard *record) {
+    liveValues_t values;
+    int32_t dataAge = live_read(id, &values);
+    memset(record, 0, sizeof(*record));
+    record->id = id;
+    record->flags = values.connected ? TELEMETRY_CONNECTED : 0;
+    if (boardConfigs[id].type != THERMOCOUPLE_IO) return;
+
+    record->flags |= TELEMETRY_THERMOCOUPLE;
+    record->output = values.output;
+    record->alarm = values.alarm;
+    record->openCircuit = values.openCircuit;
+    record->shortCircuit = values.shortCircuit;
+    record->dataAgeMs = dataAge;
+    for (uint8_t ch = 0; ch < 8; ch++) {
+        record->temperature[ch] = telemetry_tenths(values.temperature[ch]);
+        record->coldJunction[ch] = telemetry_tenths(values.coldJunction[ch]);
+    }
+}
+
+static void telemetry_header(uint8_t boardCount, TelemetryHeader *header) {
+    header->magic = TELEMETRY_MAGIC;
+    header->version = TELEMETRY_VERSION;
+    header->boardCount = boardCount;
+    header->uptimeMs = millis();
+}
+
+size_t encode_live_binary(uint8_t *buffer, size_t size) {
+    size_t length = sizeof(TelemetryHeader) + boardCount * sizeof(TelemetryBoard);
+    if (length > size) return 0;
+    telemetry_header(boardCount, (TelemetryHeader *)buffer);
+    TelemetryBoard *records = (TelemetryBoard *)&buffer[sizeof(TelemetryHeader)];
+    for (uint8_t i = 0; i < boardCount; i++) telemetry_board(i, &records[i]);
+    return length;
+}
+
+size_t encode_thermocouple_binary(uint8_t boardId, uint8_t *buffer, size_t size) {
+    size_t length = sizeof(TelemetryHeader) + sizeof(TelemetryBoard);
+    if (length > size) return 0;
+    telemetry_header(1, (TelemetryHeader *)buffer);
+    telemetry_board(boardId, (TelemetryBoard *)&buffer[sizeof(TelemetryHeader)]);
+    return length;
+}
+
+// Field table for /api/live/schema, count > 1 for arrays, tenths for values in tenths of a degree
+struct telemetryField_t {
+    const char *name;
+    const char *type;
+    uint8_t offset;
+    uint8_t count;
+    bool tenths;
+};
+
+static const telemetryField_t telemetryHeaderFields[] = {
+    {"magic",           "u16", offsetof(TelemetryHeader, magic),        1, false},
+    {"version",         "u8",  offsetof(TelemetryHeader, version),      1, false},
+    {"board_count",     "u8",  offsetof(TelemetryHeader, boardCount),   1, false},
+    {"uptime_ms",       "u32", offsetof(TelemetryHeader, uptimeMs),     1, false},
+};
+
+static const telemetryField_t telemetryBoardFields[] = {
+    {"id",              "u8",  offsetof(TelemetryBoard, id),            1, false},
+    {"flags",           "u8",  offsetof(TelemetryBoard, flags),         1, false},
+    {"output",          "u8",  offsetof(TelemetryBoard, output),        1, false},
+    {"alarm",           "u8",  offsetof(TelemetryBoard, alarm),         1, false},
+    {"open_circuit",    "u8",  offsetof(TelemetryBoard, openCircuit),   1, false},
+    {"short_circuit",   "u8",  offsetof(TelemetryBoard, shortCircuit),  1, false},
+    {"data_age_ms",     "u32", offsetof(TelemetryBoard, dataAgeMs),     1, false},
+    {"temperature",     "i16", offsetof(TelemetryBoard, temperature),   8, true},
+    {"cold_junction",   "i16", offsetof(TelemetryBoard, coldJunction),  8, true},
+};
+
+static bool schema_append_fields(size_t &length, const char *key, size_t size, const telemetryField_t *fields, size_t count) {
+    bool ok = live_append(length, ",\"%s\":{\"size\":%u,\"fields\":[", key, (unsigned)size);
+    for (size_t i = 0; i < count && ok; i++) {
+        ok = live_append(length, "%s{\"name\":\"%s\",\"type\":\"%s\",\"offset\":%u,\"count\":%u%s}",
+                         i ? "," : "", fields[i].name, fields[i].type, fields[i].offset, fields[i].count,
+                         fields[i].tenths ? ",\"scale\":0.1" : "");
+    }
+    return ok && live_append(length, "]}");
+}
+
+void handleGetTelemetrySchema() {
+    server.sendHeader("Access-Control-Allow-Origin", "*");
+
+    size_t length = 0;
+    bool ok = live_append(length, "{\"version\":%u,\"byte_order\":\"little\",\"magic\":%u,\"no_value\":%d,"
+                          "\"flags\":{\"connected\":%u,\"thermocouple\":%u}",
+                          TELEMETRY_VERSION, TELEMETRY_MAGIC, TELEMETRY_NO_VALUE, TELEMETRY_CONNECTED, TELEMETRY_THERMOCOUPLE) &&
+              schema_append_fields(length, "header", sizeof(TelemetryHeader), telemetryHeaderFields,
+                                   sizeof(telemetryHeaderFields) / sizeof(telemetryHeaderFields[0])) &&
+              schema_append_fields(length, "board", sizeof(TelemetryBoard), telemetryBoardFields,
+                                   sizeof(telemetryBoardFields) / sizeof(telemetryBoardFields[0])) &&
+              live_append(length, "}");
+    if (!ok) {
+        server.send(500, "application/json", "{\"error\":\"Schema too large\"}");
+        return;
+    }
+    server.setContentLength(length);
+    server.send(200, "application/json", "");
+    server.sendContent(liveBuffer, length);
+}
+
+// Live events -------------------------------------------------------------->
+// /api/events keeps the connection open as a Server-Sent Events stream. Every subscriber is sent
+// the same events: the full live data whenever a subscriber connects (so all of them are in step
+// with liveSent again), then "live" events carrying only the boards, and of those only the fields,
+// that changed since the last event, at most once per networkConfig.livePushInterval ms. A comment
+// is sent when nothing has changed for a while so closed connections are noticed. Writes never
+// wait on a slow browser: a subscriber without room for an event in its send buffer is
+// disconnected, and its EventSource reconnects and starts again from the full data.
+
+static WiFiClient liveClients[LIVE_EVENT_CLIENTS];
+static liveValues_t liveSent[MAX_BOARDS];   // Values of the last event, the same for every subscriber
+static uint32_t liveLastCheck = 0;
+static uint32_t liveLastSend = 0;
+
+static const char liveEventHeaders[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-store\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n\r\n";
+
+// Write to a subscriber, dropping it if the data doesn't fit its send buffer or doesn't go through in full
+static void live_send(uint8_t slot, const char *data, size_t length) {
+    if ((size_t)liveClients[slot].availableForWrite() < length ||
+        liveClients[slot].write((const uint8_t *)data, length) != length) {
+        log(LOG_INFO, false, "Live event subscriber %d dropped\n", slot);
+        liveClients[slot].stop();
+        liveClients[slot] = WiFiClient();
+    }
+}
+
+static void live_send_all(const char *data, size_t length) {
+    for (uint8_t i = 0; i < LIVE_EVENT_CLIENTS; i++) {
+        if (liveClients[i]) live_send(i, data, length);
+    }
+    liveLastSend = millis();
+}
+
+void handleLiveEvents() {
+    int slot = -1;
+    for (uint8_t i = 0; i < LIVE_EVENT_CLIENTS; i++) {
+        if (liveClients[i] && !liveClients[i].connected()) {
+            liveClients[i].stop();
+            liveClients[i] = WiFiClient();
+        }
+        if (!liveClients[i] && slot < 0) slot = i;
+    }
+    if (slot < 0) {
+        server.send(503, "application/json", "{\"error\":\"Too many event subscribers\"}");
+        return;
+    }
+
+    // The stream is written directly, the copy keeps the connection open once the server lets go of it
+    liveClients[slot] = server.client();
+    liveClients[slot].setNoDelay(true);
+    live_send(slot, liveEventHeaders, sizeof(liveEventHeaders) - 1);
+
+    // Everyone gets the full data, so the deltas that follow apply to every subscriber
+    size_t length = live_build("event: live\ndata: ", liveSent);
+    if (length && live_append(length, "\n\n")) {
+        live_send_all(liveBuffer, length);
+    } else {
+        memset(liveSent, 0, sizeof(liveSent));  // Not sent, the next event carries everything
+    }
+}
+
+// Send changes to the subscribers (core 0, after the web server)
+void manage_live_events() {
+    bool subscribed = false;
+    for (uint8_t i = 0; i < LIVE_EVENT_CLIENTS; i++) {
+        if (liveClients[i] && !liveClients[i].connected()) {
+            liveClients[i].stop();
+            liveClients[i] = WiFiClient();
+        }
+        if (liveClients[i]) subscribed = true;
+    }
+    if (!subscribed) return;
+
+    uint32_t now = millis();
+    if (now - liveLastCheck < networkConfig.livePushInterval) return;
+    liveLastCheck = now;
+
+    size_t length = 0;
+    bool ok = live_append(length, "event: live\ndata: {\"uptime_ms\":%lu,\"boards\":[", (unsigned long)now);
+    bool changed = false;
+    for (uint8_t i = 0; i < boardCount && ok; i++) {
+        liveValues_t values;
+        live_read(i, &values);
+        if (liveSent[i].valid && memcmp(&values, &liveSent[i], sizeof(values)) == 0) continue;
+        // The data age changes every time, it is left out of events
+        ok = live_append_board(length, !changed, i, &values, &liveSent[i], -1);
+        memcpy(&liveSent[i], &values, sizeof(values));
+        changed = true;
+    }
+    ok = ok && live_append(length, "]}\n\n");
+    if (changed && !ok) memset(liveSent, 0, sizeof(liveSent));  // Not sent, the next event carries everything
+
+    if (changed && ok) {
+        live_send_all(liveBuffer, length);
+    } else if (now - liveLastSend >= LIVE_EVENT_KEEPALIVE_MS) {
+        static const char keepalive[] = ": keepalive\n\n";
+        live_send_all(keepalive, sizeof(keepalive) - 1);
     }
-    
-    // Return the response
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
 }
 
 // Handler for resetting a specific channel's latched alarm
@@ -3,6 +3,7 @@
 #include "../sys_init.h"
 #include "io_objects.h"
 #include "board_config.h"
+#include "../utils/jsonStream.h"
 
 // API function declarations
 void setupBoardStatusAPI(void);
@@ -11,5 +12,50 @@ void setupBoardStatusAPI(void);
 void handleGetBoardStatus(void);
 void handleGetAllBoardsStatus(void);
 void handleGetThermocoupleData(void);
+void handleGetLiveData(void);
+void handleGetTelemetrySchema(void);
+void handleLiveEvents(void);
+
+// Push live value changes to /api/events subscribers (core 0)
+void manage_live_events(void);
 void handleResetAlarm(void);
 void handleResetAllAlarms(void);
+
+// Binary telemetry format --------------------------------------------------->
+// /api/live?format=bin and /api/status/tc?id=N&format=bin return a header followed by one record
+// per board, little-endian and packed. /api/live/schema describes the layout for clients.
+#define TELEMETRY_MAGIC 0x4C54          // "TL"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_NO_VALUE INT16_MIN    // Temperature that isn't a number
+
+// Record flags
+#define TELEMETRY_CONNECTED 0x01
+#define TELEMETRY_THERMOCOUPLE 0x02     // The channel values are set
+
+struct __attribute__((packed)) TelemetryHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t boardCount;       // Records that follow
+    uint32_t uptimeMs;
+};
+
+struct __attribute__((packed)) TelemetryBoard {
+    uint8_t id;
+    uint8_t flags;
+    uint8_t output;           // Channel bit masks (bit n = channel n)
+    uint8_t alarm;
+    uint8_t openCircuit;
+    uint8_t shortCircuit;
+    uint16_t reserved;
+    uint32_t dataAgeMs;
+    int16_t temperature[8];   // Tenths of a degree
+    int16_t coldJunction[8];
+};
+
+// Telemetry encoders behind the handlers, core 0 only. Each returns the length written, 0 if the
+// data doesn't fit. The live JSON is built into a shared buffer returned through data, the
+// thermocouple JSON is written to a stream.
+size_t encode_live_json(const char **data);
+size_t encode_live_binary(uint8_t *buffer, size_t size);
+size_t encode_thermocouple_json(uint8_t boardId, JsonStream &json);
+size_t encode_thermocouple_binary(uint8_t boardId, uint8_t *buffer, size_t size);
@@ -0,0 +1,212 @@
+#include "io_core.h"
+#include "bus_queue.h"
+
+// Slot hand-over --------------------------------------------------------------->
+// A slot moves FREE -> CLAIMED -> QUEUED -> ACTIVE -> DONE -> FREE. The submitter owns it while
+// CLAIMED and DONE, the bus owner while ACTIVE, and every transition between the two sides is a
+// compare-and-swap so a cancel can't cross the owner picking the command up or completing it.
+
+static void counter_increment(volatile uint32_t *counter) {
+    uint32_t value;
+    do {
+        value = *counter;
+    } while (!coreCompareAndSwap(counter, value, value + 1));
+}
+
+// Check the request's data fits in a slot (the master validates the rest)
+static bool request_fits(const ModbusRTUMasterTransaction *request) {
+    switch (request->functionCode) {
+        case 1:
+        case 2:
+            return request->quantity <= BUS_COMMAND_MAX_COILS;
+        case 15:
+            return request->coils && request->quantity <= BUS_COMMAND_MAX_COILS;
+        case 3:
+        case 4:
+            return request->quantity <= BUS_COMMAND_MAX_REGISTERS;
+        case 16:
+            return request->registers && request->quantity <= BUS_COMMAND_MAX_REGISTERS;
+        default:
+            return true;
+    }
+}
+
+// Queue a request on a bus. With a future the result is collected with bus_command_finish(), with
+// nullptr the command is detached. Returns false if the queue is full or the request too large.
+bool bus_command_submit(uint8_t port, busPriority_t priority, const ModbusRTUMasterTransaction *request, busFuture_t *future) {
+    if (future) {
+        future->port = port;
+        future->slot = -1;
+    }
+    if (port >= 2) return false;
+    busCommandQueue_t *queue = &modbusConfig[port].commands;
+    if (!request_fits(request)) {
+        counter_increment(&queue->rejected);
+        return false;
+    }
+
+    for (int8_t slot = 0; slot < BUS_COMMAND_QUEUE_SIZE; slot++) {
+        busCommand_t *command = &queue->commands[slot];
+        if (!coreCompareAndSwap(&command->state, BUS_COMMAND_FREE, BUS_COMMAND_CLAIMED)) continue;
+
+        // Copy the request so the submitter's buffers don't have to outlive the call
+        ModbusRTUMasterTransaction *transaction = &command->transaction;
+        transaction->id = request->id;
+        transaction->functionCode = request->functionCode;
+        transaction->address = request->address;
+        transaction->quantity = request->quantity;
+        transaction->value = request->value;
+        transaction->coils = command->coils;
+        transaction->registers = command->registers;
+        transaction->timeout = request->timeout ? request->timeout : RESPONSE_TIMEOUT_MAX_US;
+        transaction->callback = nullptr;
+        transaction->context = nullptr;
+        transaction->exceptionCode = 0;
+        transaction->responseTime = 0;
+        transaction->status = MODBUS_RTU_MASTER_IDLE;
+        if (request->functionCode == 15) memcpy(command->coils, request->coils, request->quantity * sizeof(bool));
+        if (request->functionCode == 16) memcpy(command->registers, request->registers, request->quantity * sizeof(uint16_t));
+        command->priority = priority;
+        command->attempts = 0;
+        command->detached = future == nullptr;
+        command->queuedAt = time_us_64();
+
+        counter_increment(&queue->submitted);
+        if (future) future->slot = slot;
+        coreCompareAndSwap(&command->state, BUS_COMMAND_CLAIMED, BUS_COMMAND_QUEUED);
+        return true;
+    }
+    counter_increment(&queue->rejected);
+    return false;
+}
+
+bool bus_command_done(const busFuture_t *future) {
+    if (future->port >= 2 || future->slot < 0) return false;
+    return modbusConfig[future->port].commands.commands[future->slot].state == BUS_COMMAND_DONE;
+}
+
+// Collect the result of a completed command and free its slot. Read data is copied into the
+// result's coils/registers buffers if they are set. Returns false if the command isn't done yet.
+bool bus_command_finish(busFuture_t *future, ModbusRTUMasterTransaction *result) {
+    if (!bus_command_done(future)) return false;
+    busCommand_t *command = &modbusConfig[future->port].commands.commands[future->slot];
+    ModbusRTUMasterTransaction *transaction = &command->transaction;
+    if (result) {
+        result->status = transaction->status;
+        result->exceptionCode = transaction->exceptionCode;
+        result->responseTime = transaction->responseTime;
+        if (transaction->status == MODBUS_RTU_MASTER_SUCCESS) {
+            uint8_t functionCode = transaction->functionCode;
+            if ((functionCode == 1 || functionCode == 2) && result->coils) {
+                memcpy(result->coils, command->coils, transaction->quantity * sizeof(bool));
+            }
+            if ((functionCode == 3 || functionCode == 4) && result->registers) {
+                memcpy(result->registers, command->registers, transaction->quantity * sizeof(uint16_t));
+            }
+        }
+    }
+    coreCompareAndSwap(&command->state, BUS_COMMAND_DONE, BUS_COMMAND_FREE);
+    future->slot = -1;
+    return true;
+}
+
+// Drop a command the submitter no longer wants, it is still finished if already on the bus
+void bus_command_cancel(busFuture_t *future) {
+    if (future->port >= 2 || future->slot < 0) return;
+    volatile uint32_t *state = &modbusConfig[future->port].commands.commands[future->slot].state;
+    if (!coreCompareAndSwap(state, BUS_COMMAND_QUEUED, BUS_COMMAND_FREE) &&
+        !coreCompareAndSwap(state, BUS_COMMAND_ACTIVE, BUS_COMMAND_ABANDONED)) {
+        coreCompareAndSwap(state, BUS_COMMAND_DONE, BUS_COMMAND_FREE);
+    }
+    future->slot = -1;
+}
+
+// Submit a request and wait for the result, a blocking replacement for the ModbusRTUMaster
+// read/write calls. Read data is copied into the request's buffers. If the queue is full the
+// request status is left IDLE, if the wait times out the command is cancelled and the status
+// is TIMEOUT. Returns true on success.
+bool bus_command_run(uint8_t port, busPriority_t priority, ModbusRTUMasterTransaction *request, uint32_t timeoutMs) {
+    request->status = MODBUS_RTU_MASTER_IDLE;
+    busFuture_t future;
+    if (!bus_command_submit(port, priority, request, &future)) return false;
+
+    // On the owner core the scheduler can't run while we wait, so drive the bus from here
+    bool ownerCore = rp2040.cpuid() == BUS_OWNER_CORE;
+    uint32_t start = millis();
+    while (!bus_command_done(&future)) {
+        if (millis() - start >= timeoutMs) {
+            bus_command_cancel(&future);
+            request->status = MODBUS_RTU_MASTER_TIMEOUT;
+            return false;
+        }
+        if (ownerCore) {
+            modbusConfig[port].bus->poll();
+            bus_commands_service(&modbusConfig[port]);
+        } else {
+            delayMicroseconds(100);
+        }
+    }
+    bus_command_finish(&future, request);
+    return request->status == MODBUS_RTU_MASTER_SUCCESS;
+}
+
+// Bus owner -------------------------------------------------------------------->
+// Highest priority queued command, oldest first within a priority
+static int8_t bus_command_next(busCommandQueue_t *queue) {
+    int8_t next = -1;
+    for (int8_t slot = 0; slot < BUS_COMMAND_QUEUE_SIZE; slot++) {
+        busCommand_t *command = &queue->commands[slot];
+        if (command->state != BUS_COMMAND_QUEUED) continue;
+        if (next >= 0) {
+            busCommand_t *best = &queue->commands[next];
+            if (command->priority > best->priority) continue;
+            if (command->priority == best->priority && command->queuedAt >= best->queuedAt) continue;
+        }
+        next = slot;
+    }
+    return next;
+}
+
+// Start or advance the queued commands of a bus. A command is only started between transactions,
+// a poll request already on the wire is left to finish first. Returns true while a command holds
+// the bus, the poll scheduler must not submit until it returns false.
+bool bus_commands_service(modbusConfig_t *busCfg) {
+    busCommandQueue_t *queue = &busCfg->commands;
+    if (queue->active < 0) {
+        if (busCfg->bus->isBusy()) return false;
+        int8_t next = bus_command_next(queue);
+        if (next < 0) return false;
+        busCommand_t *command = &queue->commands[next];
+        if (!coreCompareAndSwap(&command->state, BUS_COMMAND_QUEUED, BUS_COMMAND_ACTIVE)) return false; // Cancelled
+        uint64_t wait = time_us_64() - command->queuedAt;
+        if (wait > queue->maxWaitUs) queue->maxWaitUs = wait > UINT32_MAX ? UINT32_MAX : (uint32_t)wait;
+        queue->active = next;
+    }
+
+    busCommand_t *command = &queue->commands[queue->active];
+    ModbusRTUMasterTransaction *transaction = &command->transaction;
+    if (transaction->status == MODBUS_RTU_MASTER_IDLE) {
+        if (!busCfg->bus->submit(transaction) && transaction->status == MODBUS_RTU_MASTER_IDLE) return true; // Transport busy
+    }
+    busCfg->bus->poll();
+    if (transaction->status == MODBUS_RTU_MASTER_PENDING) return true;
+
+    bool retry = transaction->status == MODBUS_RTU_MASTER_TIMEOUT || transaction->status == MODBUS_RTU_MASTER_FRAME_ERROR;
+    if (retry && ++command->attempts < BUS_COMMAND_ATTEMPTS) {
+        transaction->status = MODBUS_RTU_MASTER_IDLE; // Resubmit on the next call
+        return true;
+    }
+    uint8_t port = busCfg - modbusConfig;
+    if (transaction->status == MODBUS_RTU_MASTER_SUCCESS) {
+        thermocouple_write_complete(port, transaction);
+    } else if (command->detached) {
+        log(LOG_WARNING, true, "Queued request FC%d to slave %d on port %d failed with status %d\n",
+            transaction->functionCode, transaction->id, port + 1, transaction->status);
+    }
+    queue->completed++;
+    queue->active = -1;
+    if (command->detached || !coreCompareAndSwap(&command->state, BUS_COMMAND_ACTIVE, BUS_COMMAND_DONE)) {
+        command->state = BUS_COMMAND_FREE; // Detached, or abandoned by the submitter
+    }
+    return false;
+}
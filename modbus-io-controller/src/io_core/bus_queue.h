@@ -0,0 +1,76 @@
+/* Description: Per-bus command queue for Modbus requests that don't come from the poll scheduler.
+ * Each RS485 port is only driven by core 1 (manage_io_core). Web and Modbus TCP handlers on core 0,
+ * and the terminal on core 1, queue their requests here instead of calling the bus directly, and
+ * the port owner sends them between poll transactions, so they never collide with in-flight frames.
+ * Operator commands are sent before config writes, then Modbus TCP pass-through requests, and all
+ * are sent before the periodic polls, so a queued command waits for at most the one transaction
+ * already on the wire plus any queued ahead of it.
+ * Submitting returns a future that completes when the owner has finished the request, or with no
+ * future the command is detached and its slot is freed when it completes. Writes that succeed are
+ * mirrored into the board's cached registers by the owner. The queue is lock-free: each slot is
+ * claimed and handed over through a compare-and-swap on its state word.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "ModbusRTUMaster.h"
+
+#define BUS_OWNER_CORE 1                // Core running manage_io_core()
+#define BUS_COMMAND_QUEUE_SIZE 8
+#define BUS_COMMAND_MAX_REGISTERS 123   // FC16 limit
+#define BUS_COMMAND_MAX_COILS 256
+#define BUS_COMMAND_ATTEMPTS 3          // Timeouts and frame errors are retried, exceptions are not
+#define BUS_COMMAND_TIMEOUT_MS 1000     // Default wait for bus_command_run()
+
+enum busPriority_t : uint8_t {
+    BUS_PRIORITY_OPERATOR,      // Alarm resets and other operator actions
+    BUS_PRIORITY_CONFIG,        // Address assignment and config writes
+    BUS_PRIORITY_GATEWAY        // Modbus TCP pass-through requests
+};
+
+enum busCommandState_t : uint32_t {
+    BUS_COMMAND_FREE,
+    BUS_COMMAND_CLAIMED,        // Being filled in by the submitter
+    BUS_COMMAND_QUEUED,
+    BUS_COMMAND_ACTIVE,         // On the bus
+    BUS_COMMAND_DONE,           // Result ready for the submitter
+    BUS_COMMAND_ABANDONED       // Submitter gave up while active, the owner frees it when done
+};
+
+struct busCommand_t {
+    volatile uint32_t state = BUS_COMMAND_FREE;
+    busPriority_t priority = BUS_PRIORITY_OPERATOR;
+    uint8_t attempts = 0;
+    bool detached = false;      // No future, freed by the owner when done
+    uint64_t queuedAt = 0;      // time_us_64(), also orders commands of the same priority
+    ModbusRTUMasterTransaction transaction;
+    uint16_t registers[BUS_COMMAND_MAX_REGISTERS];
+    bool coils[BUS_COMMAND_MAX_COILS];
+};
+
+struct busCommandQueue_t {
+    busCommand_t commands[BUS_COMMAND_QUEUE_SIZE];
+    int8_t active = -1;             // Command on the bus, -1 if none (owner only)
+    volatile uint32_t submitted = 0;
+    volatile uint32_t rejected = 0; // Queue full or request too large
+    uint32_t completed = 0;
+    uint32_t maxWaitUs = 0;         // Longest time from submit to the request going out
+};
+
+struct busFuture_t {
+    uint8_t port = 0;
+    int8_t slot = -1;
+};
+
+struct modbusConfig_t;
+
+// Submitter side (any core)
+bool bus_command_submit(uint8_t port, busPriority_t priority, const ModbusRTUMasterTransaction *request, busFuture_t *future);
+bool bus_command_done(const busFuture_t *future);
+bool bus_command_finish(busFuture_t *future, ModbusRTUMasterTransaction *result);
+void bus_command_cancel(busFuture_t *future);
+bool bus_command_run(uint8_t port, busPriority_t priority, ModbusRTUMasterTransaction *request, uint32_t timeoutMs = BUS_COMMAND_TIMEOUT_MS);
+
+// Owner side (core 1, called from the bus scheduler)
+bool bus_commands_service(modbusConfig_t *busCfg);
@@ -1,6 +1,7 @@
 #include "dashboard_config.h"
 #include "board_config.h"
 #include "../utils/logger.h"
+#include "../utils/jsonStream.h"
 #include <WebServer.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
@@ -159,11 +160,11 @@ void setupDashboardAPI() {
 
 // Handle GET request for dashboard items
 void handleGetDashboardItems() {
-    // Create JSON document for response
-    DynamicJsonDocument doc(8192); // Large buffer for 80 dashboard items with full metadata
-    
-    // Create items array
-    JsonArray items = doc.createNestedArray("items");
+    // Streamed an item at a time, 80 items with full metadata are too large for one document
+    JsonStream json(server);
+    json.begin();
+    json.beginObject();
+    json.beginArray("items");
     
     // Keep track of dashboard-enabled channels that aren't in the dashboard config
     bool needsUpdate = false;
@@ -189,19 +190,19 @@ void handleGetDashboardItems() {
         }
         
         if (valid) {
-            // Add to response
-            JsonObject item = items.createNestedObject();
-            
             // Get board for adding details
             BoardConfig* board = getBoard(boardIndex);
             
-            item["board_index"] = boardIndex;
-            item["channel_index"] = channelIndex;
-            item["board_name"] = board->boardName;
-            item["channel_name"] = board->settings.thermocoupleIO.channels[channelIndex].channelName;
-            item["display_order"] = dashboardConfig.items[i].displayOrder;
-            item["show_in_chart"] = dashboardConfig.items[i].showInChart;
-            item["board_type"] = board->type;
+            // Add to response
+            json.beginObject();
+            json.add("board_index", boardIndex);
+            json.add("channel_index", channelIndex);
+            json.add("board_name", board->boardName);
+            json.add("channel_name", board->settings.thermocoupleIO.channels[channelIndex].channelName);
+            json.add("display_order", dashboardConfig.items[i].displayOrder);
+            json.add("show_in_chart", dashboardConfig.items[i].showInChart);
+            json.add("board_type", board->type);
+            json.endObject();
         } else {
             // This item is no longer valid, mark for update
             needsUpdate = true;
@@ -233,13 +234,14 @@ void handleGetDashboardItems() {
                             dashboardConfig.items[dashboardConfig.itemCount].displayOrder = dashboardConfig.itemCount;
                             
                             // Add to response
-                            JsonObject item = items.createNestedObject();
-                            item["board_index"] = boardIndex;
-                            item["board_name"] = board->boardName;
-                            item["channel_index"] = channelIndex;
-                            item["display_order"] = dashboardConfig.itemCount;
-                            item["board_type"] = board->type;
-                            item["channel_name"] = board->settings.thermocoupleIO.channels[channelIndex].channelName;
+                            json.beginObject();
+                            json.add("board_index", boardIndex);
+                            json.add("board_name", board->boardName);
+                            json.add("channel_index", channelIndex);
+                            json.add("display_order", dashboardConfig.itemCount);
+                            json.add("board_type", board->type);
+                            json.add("channel_name", board->settings.thermocoupleIO.channels[channelIndex].channelName);
+                            json.endObject();
                             
                             dashboardConfig.itemCount++;
                             needsUpdate = true;
@@ -251,20 +253,17 @@ void handleGetDashboardItems() {
         // Add more board types as needed
     }
     
+    json.endArray();
+    
+    // Add chart configuration to response
+    json.add("chart_visible", dashboardConfig.chartVisible);
+    json.endObject();
+    json.end();
+    
     // If we made changes to the dashboard config, save it
     if (needsUpdate) {
         saveDashboardConfig();
     }
-    
-    // Add chart configuration to response
-    doc["chart_visible"] = dashboardConfig.chartVisible;
-    
-    // Serialize response
-    String response;
-    serializeJson(doc, response);
-    
-    // Send response
-    server.send(200, "application/json", response);
 }
 
 // Handle POST request for saving dashboard order
@@ -4,27 +4,32 @@
 #include "board_status.h"
 #include "dashboard_config.h"
 #include "../storage/sdManager.h"
+#include <atomic>
 
 
 // Object definitions
-ModbusRTUMaster bus1(Serial1);
-ModbusRTUMaster bus2(Serial2);
+// The RS485 ports drive the UARTs directly (DMA transmit, interrupt receive), Serial1/Serial2 are not used
+ModbusRTUTransportRP2040 rs485Port1(0, PIN_RS485_TX_1, PIN_RS485_RX_1);
+ModbusRTUTransportRP2040 rs485Port2(1, PIN_RS485_TX_2, PIN_RS485_RX_2);
+ModbusRTUMaster bus1(rs485Port1);
+ModbusRTUMaster bus2(rs485Port2);
 
-modbusConfig_t modbusConfig[2] = {
-    {&bus1, {false}},
-    {&bus2, {false}}
-};
+modbusConfig_t modbusConfig[2] = {{&bus1}, {&bus2}};
 
 deviceIndex_t deviceIndex[64];
 thermocoupleIO_index_t thermocoupleIO_index;
 
+// Unit ID routing tables, one is read by Modbus TCP on core 0 while the other is rebuilt
+static tcpUnitRoute_t tcpUnitRoutes[2][256];
+static volatile uint8_t tcpUnitRoutesActive = 0;
+
+// Set when the board configs change on core 0, the scheduler is rebuilt by core 1 between transactions
+static std::atomic<bool> boardConfigsPending(false);
+
+static void schedule_all_devices(void);
+static void rebuild_board_configs(void);
+
 void init_io_core(void) {
-    Serial1.setTX(PIN_RS485_TX_1);
-    Serial1.setRX(PIN_RS485_RX_1);
-    Serial2.setTX(PIN_RS485_TX_2);
-    Serial2.setRX(PIN_RS485_RX_2);
-    Serial1.setFIFOSize(128);
-    Serial2.setFIFOSize(128);
     bus1.begin(500000);
     bus2.begin(500000);
 
@@ -48,13 +53,53 @@ void init_io_core(void) {
     log(LOG_INFO, false, "IO Core initialised\n");
 }
 
-// Apply board configurations from config file
+// Apply board configurations from config file. The device index and poll queues belong to the bus
+// scheduler on core 1, so a call from any other core only requests the rebuild, see manage_io_core()
 void apply_board_configs() {
+    if (rp2040.cpuid() != BUS_OWNER_CORE) {
+        boardConfigsPending = true;
+        return;
+    }
+    rebuild_board_configs();
+}
+
+// Response timing, backoff and poll statistics belong to the slave rather than to its device index
+// slot. They are carried across a rebuild when a board is applied again on the same port with the
+// same slave ID, so editing one board doesn't reset the timeouts and quarantine of all the others.
+static void restore_device_state(const deviceIndex_t *previous, const uint8_t *previousSlaveID) {
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        deviceIndex_t *device = &deviceIndex[slot];
+        if (!device->configured) continue;
+        for (uint8_t old = 0; old < 64; old++) {
+            if (!previous[old].configured || previous[old].type != device->type || previous[old].index != device->index) continue;
+            if (previous[old].port == device->port && previousSlaveID[old] == thermocoupleIO_index.tcIO[device->index].slaveID) {
+                device->nextPoll = previous[old].nextPoll;
+                device->pollStats = previous[old].pollStats;
+                device->link = previous[old].link;
+            }
+            break;
+        }
+    }
+}
+
+static void rebuild_board_configs(void) {
     uint8_t appliedBoards = 0;
     uint8_t count = getBoardCount();
 
-    // Reset device index
-    memset(deviceIndex, 0, sizeof(deviceIndex));
+    // Reset device index, keeping the old entries for restore_device_state()
+    static deviceIndex_t previous[64];
+    uint8_t previousSlaveID[64];
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        previous[slot] = deviceIndex[slot];
+        previousSlaveID[slot] = deviceIndex[slot].index < 16 ? thermocoupleIO_index.tcIO[deviceIndex[slot].index].slaveID : 0;
+        deviceIndex[slot] = deviceIndex_t();
+    }
+
+    // Device index slots are reassigned below, so release bus ownership and clear the poll queues
+    for (uint8_t port = 0; port < 2; port++) {
+        modbusConfig[port].pollOwner = -1;
+        modbusConfig[port].pollQueueSize = 0;
+    }
 
     for (uint8_t i = 0; i < count; i++) {
         BoardConfig* board = getBoard(i);
@@ -81,6 +126,13 @@ void apply_board_configs() {
     }
 
     log(LOG_INFO, false, "Applied %d board configurations\n", appliedBoards);
+    restore_device_state(previous, previousSlaveID);
+
+    // Modbus TCP routes follow the applied boards
+    build_tcp_unit_routes();
+
+    // Schedule all configured devices for an immediate first poll, quarantined boards keep waiting
+    schedule_all_devices();
     
     // Update modbus address tracking after applying configurations
     updateModbusAddressTracking();
@@ -110,6 +162,49 @@ void updateModbusAddressTracking() {
     }
 }
 
+// Modbus TCP unit ID routing ------------------------------------------------>
+// A TCP request is routed by its unit ID through a 256 entry table, so the lookup doesn't depend
+// on the number of boards. A board answers on its configured TCP unit ID, or on its slave ID if
+// none is set. Slave IDs are only unique per RS485 port, so boards on both ports can share one:
+// configured unit IDs are claimed first, then the first board with a given slave ID gets it, and
+// any later board is left unrouted (and logged) until it is given a TCP unit ID of its own.
+
+void build_tcp_unit_routes(void) {
+    tcpUnitRoute_t *routes = tcpUnitRoutes[tcpUnitRoutesActive ^ 1];
+    memset(routes, 0, sizeof(tcpUnitRoutes[0]));
+
+    uint8_t count = getBoardCount();
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t i = 0; i < count; i++) {
+            BoardConfig* board = getBoard(i);
+            if (!board || !board->initialised || board->type != THERMOCOUPLE_IO || board->boardIndex >= 16) continue;
+            bool configured = board->tcpUnitId != 0;
+            if (configured != (pass == 0)) continue;
+
+            uint8_t unitId = configured ? board->tcpUnitId : board->slaveID;
+            if (unitId == 0 || unitId > TCP_UNIT_ID_MAX) continue;
+            if (routes[unitId].routed) {
+                log(LOG_WARNING, true, "Modbus TCP unit ID %d of board '%s' is already in use, set a TCP unit ID to reach the board\n",
+                    unitId, board->boardName);
+                continue;
+            }
+            routes[unitId].routed = true;
+            routes[unitId].board = board->boardIndex;
+            routes[unitId].port = board->modbusPort;
+            routes[unitId].slaveID = board->slaveID;
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    tcpUnitRoutesActive ^= 1;
+}
+
+// Look up the board a Modbus TCP unit ID is routed to, returns false if there is none
+bool tcp_unit_route(uint8_t unitId, tcpUnitRoute_t *route) {
+    *route = tcpUnitRoutes[tcpUnitRoutesActive][unitId];
+    return route->routed;
+}
+
 // Apply thermocouple IO board configuration
 bool apply_thermocouple_config(BoardConfig* config) {
     if (!config || config->type != THERMOCOUPLE_IO || config->boardIndex >= 16) {
@@ -121,6 +216,7 @@ bool apply_thermocouple_config(BoardConfig* config) {
     thermocoupleIO_index.tcIO[config->boardIndex].slaveID = config->slaveID;
     thermocoupleIO_index.tcIO[config->boardIndex].lastUpdate = millis();
     thermocoupleIO_index.tcIO[config->boardIndex].pollTime = config->pollTime;
+    thermocoupleIO_index.tcIO[config->boardIndex].snapshotSupported = true;
     thermocoupleIO_index.tcIO[config->boardIndex].reg.slaveID = config->slaveID;
     strcpy(thermocoupleIO_index.tcIO[config->boardIndex].reg.boardName, config->boardName);
 
@@ -140,7 +236,9 @@ bool apply_thermocouple_config(BoardConfig* config) {
     if (idx < 64) {
         deviceIndex[idx].type = THERMOCOUPLE_IO;
         deviceIndex[idx].index = config->boardIndex;
+        deviceIndex[idx].port = config->modbusPort;
         deviceIndex[idx].configured = true;
+        thermocoupleIO_index.tcIO[config->boardIndex].republish = true;
         log(LOG_INFO, false, "Added thermocouple board '%s' with ID %d at index %d\n", 
             config->boardName, config->slaveID, config->boardIndex);
         return true;
@@ -160,47 +258,265 @@ uint8_t findFreeDeviceIndex() {
     return 255; // Error - no free slot
 }
 
+// Per-bus poll scheduler ---------------------------------------------------->
+// Each RS485 port is scheduled independently so that a board waiting on a response on one bus
+// doesn't hold up the boards on the other. Devices on a port are kept in a min-heap ordered by
+// their next poll deadline (monotonic microseconds). A port is owned by one device until its poll
+// sequence completes, then the device is requeued for its next deadline.
+// Catch-up rule: if the bus is saturated and a device misses whole poll periods, the missed slots
+// are skipped (and counted) rather than polled back to back, so the poll phase is kept.
+
+void poll_queue_push(modbusConfig_t *busCfg, uint8_t slot, uint64_t due) {
+    if (busCfg->pollQueueSize >= 64) return;
+    uint8_t i = busCfg->pollQueueSize++;
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (busCfg->pollQueue[parent].due <= due) break;
+        busCfg->pollQueue[i] = busCfg->pollQueue[parent];
+        i = parent;
+    }
+    busCfg->pollQueue[i].due = due;
+    busCfg->pollQueue[i].slot = slot;
+}
+
+pollEntry_t poll_queue_pop(modbusConfig_t *busCfg) {
+    pollEntry_t top = busCfg->pollQueue[0];
+    pollEntry_t last = busCfg->pollQueue[--busCfg->pollQueueSize];
+    uint8_t size = busCfg->pollQueueSize;
+    uint8_t i = 0;
+    while (true) {
+        uint8_t child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size && busCfg->pollQueue[child + 1].due < busCfg->pollQueue[child].due) child++;
+        if (last.due <= busCfg->pollQueue[child].due) break;
+        busCfg->pollQueue[i] = busCfg->pollQueue[child];
+        i = child;
+    }
+    busCfg->pollQueue[i] = last;
+    return top;
+}
+
+// Deadline after a poll that was due at due and started at now, one period on from due plus any
+// whole periods already missed, which are counted in missed
+uint64_t poll_next_due(uint64_t due, uint64_t now, uint64_t period, uint32_t *missed) {
+    *missed = now > due ? (now - due) / period : 0;
+    return due + (*missed + 1) * period;
+}
+
+static uint64_t poll_period_us(uint8_t slot) {
+    BoardConfig* board = getBoard(deviceIndex[slot].index);
+    uint32_t pollTime = board ? board->pollTime : MIN_POLL_TIME;
+    if (pollTime < MIN_POLL_TIME) pollTime = MIN_POLL_TIME;
+    return (uint64_t)pollTime * 1000;
+}
+
+static void schedule_all_devices(void) {
+    uint64_t now = time_us_64();
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        deviceIndex_t *device = &deviceIndex[slot];
+        if (!device->configured || device->port >= 2) continue;
+        // A quarantined board keeps its probe time
+        device->nextPoll = device->link.backoff ? max(device->nextPoll, now) : now;
+        poll_queue_push(&modbusConfig[device->port], slot, device->nextPoll);
+    }
+}
+
+static void update_poll_stats(pollStats_t *stats, uint64_t lateness, uint32_t missed) {
+    uint32_t late = lateness > UINT32_MAX ? UINT32_MAX : (uint32_t)lateness;
+    stats->polls++;
+    stats->missed += missed;
+    stats->lastLateness = late;
+    if (late > stats->maxLateness) stats->maxLateness = late;
+    stats->avgLateness = stats->avgLateness - (stats->avgLateness / 8) + (late / 8);
+}
+
+// Response timeouts and offline backoff ------------------------------------->
+// Each slave's response time (end of request to start of response) is tracked with the
+// Jacobson/Karels estimator used for TCP retransmit timers: srtt follows the samples with gain 1/8,
+// rttvar follows their deviation from srtt with gain 1/4 and the timeout is srtt + 4 * rttvar.
+// Until the first response the bus maximum is used, and each timeout doubles the slave's timeout
+// until a response gives a new sample, so a slow board is not cut off by a stale estimate.
+// A board marked offline is quarantined: it is probed with a single attempt, and each failed probe
+// doubles the time until the next one (up to OFFLINE_PROBE_MAX_MS), so dead boards cost almost no
+// bus time while still being picked up again soon after they come back.
+
+static uint32_t link_timeout(linkState_t *link) {
+    if (!link->timeout) link->timeout = RESPONSE_TIMEOUT_MAX_US;
+    return link->timeout;
+}
+
+static void link_update(linkState_t *link, const ModbusRTUMasterTransaction *transaction) {
+    if (transaction->status == MODBUS_RTU_MASTER_TIMEOUT) {
+        link->timeouts++;
+        link->timeout = min(link_timeout(link) * 2, (uint32_t)RESPONSE_TIMEOUT_MAX_US);
+        return;
+    }
+    uint32_t sample = transaction->responseTime;
+    if (!sample) return;
+
+    link->lastRtt = sample;
+    if (!link->srtt) {
+        link->srtt = sample;
+        link->rttvar = sample / 2;
+    } else {
+        uint32_t deviation = sample > link->srtt ? sample - link->srtt : link->srtt - sample;
+        link->rttvar = link->rttvar - (link->rttvar / 4) + (deviation / 4);
+        link->srtt = link->srtt - (link->srtt / 8) + (sample / 8);
+    }
+    uint32_t timeout = link->srtt + 4 * link->rttvar;
+    link->timeout = constrain(timeout, (uint32_t)RESPONSE_TIMEOUT_MIN_US, (uint32_t)RESPONSE_TIMEOUT_MAX_US);
+}
+
+// Requeue a device after its poll sequence, offline boards are pushed back by their probe backoff
+static void requeue_device(modbusConfig_t *busCfg, uint8_t slot) {
+    deviceIndex_t *device = &deviceIndex[slot];
+    BoardConfig* board = getBoard(device->index);
+    if (board && !board->connected) {
+        uint64_t interval = poll_period_us(slot) << min(device->link.backoff, (uint8_t)16);
+        if (interval > (uint64_t)OFFLINE_PROBE_MAX_MS * 1000) interval = (uint64_t)OFFLINE_PROBE_MAX_MS * 1000;
+        else device->link.backoff++;
+        device->nextPoll = max(device->nextPoll, time_us_64() + interval);
+    } else {
+        device->link.backoff = 0;
+    }
+    poll_queue_push(busCfg, slot, device->nextPoll);
+}
+
+// Service a device, returns true while the device's poll sequence is using the bus
+static bool manage_device(uint8_t slot) {
+    bool active = false;
+    switch (deviceIndex[slot].type) {
+        case ANALOGUE_DIGITAL_IO:
+            manage_analogue_digital_io(deviceIndex[slot].index);
+            break;
+        case THERMOCOUPLE_IO:
+            active = manage_thermocouple(deviceIndex[slot].index, &deviceIndex[slot].link);
+            leds.setPixelColor(LED_MODBUS_STATUS, status.LEDcolour[LED_MODBUS_STATUS]);
+            break;
+        case RTD_IO:
+            manage_rtd(deviceIndex[slot].index);
+            break;
+        case ENERGY_METER:
+            manage_energy_meter(deviceIndex[slot].index);
+            break;
+    }
+    return active;
+}
+
+static void schedule_bus(uint8_t port) {
+    modbusConfig_t *busCfg = &modbusConfig[port];
+
+    // Queued operator and config commands go out ahead of the next poll transaction
+    if (bus_commands_service(busCfg)) return;
+
+    // Keep servicing the current owner until its sequence is finished, then requeue it
+    if (busCfg->pollOwner >= 0) {
+        if (manage_device(busCfg->pollOwner)) return;
+        requeue_device(busCfg, busCfg->pollOwner);
+        busCfg->pollOwner = -1;
+    }
+
+    // Hold off new polls while a board config rebuild waits for both buses to finish their sequences
+    if (boardConfigsPending) return;
+
+    // Bus is free, start the device with the earliest deadline once it is due
+    uint64_t now = time_us_64();
+    while (busCfg->pollQueueSize > 0 && busCfg->pollQueue[0].due <= now) {
+        pollEntry_t entry = poll_queue_pop(busCfg);
+        uint8_t slot = entry.slot;
+        if (!deviceIndex[slot].configured) continue;
+
+        // Next deadline is one period on, skipping any whole periods already missed
+        uint64_t lateness = now - entry.due;
+        uint32_t missed;
+        deviceIndex[slot].nextPoll = poll_next_due(entry.due, now, poll_period_us(slot), &missed);
+
+        // Skip devices that haven't been properly initialised
+        BoardConfig* board = getBoard(deviceIndex[slot].index);
+        if (!board || !board->initialised) {
+            poll_queue_push(busCfg, slot, deviceIndex[slot].nextPoll);
+            continue;
+        }
+
+        update_poll_stats(&deviceIndex[slot].pollStats, lateness, missed);
+        if (manage_device(slot)) {
+            busCfg->pollOwner = slot;
+            return;
+        }
+        requeue_device(busCfg, slot);
+    }
+}
+
 void manage_io_core(void) {
-    // Check for configured devices
-    for (int i = 0; i < 64; i++) {
-        if (deviceIndex[i].configured) {
-            // Get the board configuration for this device
-            BoardConfig* board = getBoard(deviceIndex[i].index);
-            
-            // Skip devices that haven't been properly initialised
-            if (!board || !board->initialised) {
-                continue;
-            }
-            switch (deviceIndex[i].type) {
-                case ANALOGUE_DIGITAL_IO:
-                    manage_analogue_digital_io(deviceIndex[i].index);
-                    break;
-                case THERMOCOUPLE_IO:
-                    manage_thermocouple(deviceIndex[i].index);
-                    leds.setPixelColor(LED_MODBUS_STATUS, status.LEDcolour[LED_MODBUS_STATUS]);
-                    break;
-                case RTD_IO:
-                    manage_rtd(deviceIndex[i].index);
-                    break;
-                case ENERGY_METER:
-                    manage_energy_meter(deviceIndex[i].index);
-                    break;
-            }
+    // Advance any in-flight RS485 transactions
+    bus1.poll();
+    bus2.poll();
+
+    // Rebuild the device index and poll queues once no device owns either bus
+    if (boardConfigsPending && modbusConfig[0].pollOwner < 0 && modbusConfig[1].pollOwner < 0) {
+        boardConfigsPending = false;
+        rebuild_board_configs();
+    }
+
+    // Each bus keeps its own transaction in flight
+    schedule_bus(0);
+    schedule_bus(1);
+
+    // Publish applied configs and check record intervals for boards between polls
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        if (!deviceIndex[slot].configured || deviceIndex[slot].type != THERMOCOUPLE_IO) continue;
+        thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[deviceIndex[slot].index];
+        if (tc->pollStep != TC_POLL_IDLE) continue;
+        if (tc->republish) {
+            tc->republish = false;
+            thermocouple_publish(deviceIndex[slot].index);
+        }
+        record_thermocouple(deviceIndex[slot].index);
+    }
+}
+
+// Get poll timing statistics for a board, returns nullptr if the board isn't scheduled
+pollStats_t *getPollStats(uint8_t boardIndex) {
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        if (deviceIndex[slot].configured && deviceIndex[slot].index == boardIndex) {
+            return &deviceIndex[slot].pollStats;
         }
     }
+    return nullptr;
 }
 
+// Get the response timing and backoff state for a board, returns nullptr if the board isn't scheduled
+linkState_t *getLinkState(uint8_t boardIndex) {
+    for (uint8_t slot = 0; slot < 64; slot++) {
+        if (deviceIndex[slot].configured && deviceIndex[slot].index == boardIndex) {
+            return &deviceIndex[slot].link;
+        }
+    }
+    return nullptr;
+}
+
+// Called from the web API (core 0) and the terminal (core 1), the requests go through the bus queue
 uint8_t assign_address(modbusConfig_t *busCfg) {
+    uint8_t port = busCfg - modbusConfig;
     uint16_t buf[1];
     // Check for device waiting for address assignment (at address 245)
-    if (!busCfg->bus->readHoldingRegisters(245, 0, buf, 1)) {
+    ModbusRTUMasterTransaction request;
+    request.id = 245;
+    request.functionCode = 3;
+    request.address = 0;
+    request.quantity = 1;
+    request.registers = buf;
+    if (!bus_command_run(port, BUS_PRIORITY_CONFIG, &request)) {
         log(LOG_ERROR, true, "No device waiting for address assignment\n");
         return 0;
     }
     for (uint8_t i = 1; i < 243; i++) {
         if (!busCfg->idAssigned[i]) {
             // Assign address to device
-            if (busCfg->bus->writeSingleHoldingRegister(245, EXP_HOLDING_REG_SLAVE_ID, i)) {
+            request.functionCode = 6;
+            request.address = EXP_HOLDING_REG_SLAVE_ID;
+            request.value = i;
+            if (bus_command_run(port, BUS_PRIORITY_CONFIG, &request)) {
                 busCfg->idAssigned[i] = true;
                 log(LOG_INFO, true, "Assigned address %d to device\n", i);
                 return i;
@@ -230,263 +546,506 @@ void manage_analogue_digital_io(uint8_t index) {
 }
 
 // Thermocouple IO board management functions ------------------------------>
-void manage_thermocouple(uint8_t index) {
-    if (!thermocoupleIO_index.tcIO[index].configInitialised) {
-        if (!setup_thermocouple(index)) {
-            log(LOG_ERROR, true, "Failed to setup thermocouple board configuration registers at index %d\n", index);
-            // Don't mark board as not initialized - it may just be temporarily offline
-            // Only mark as not initialized if this is a brand new board during initial setup
-            log(LOG_WARNING, true, "Board at index %d may be offline - keeping initialization status\n", index);
-            return;
-        }
-        thermocoupleIO_index.tcIO[index].configInitialised = true;
-        
-        if (!statusLocked) {
-            statusLocked = true;
-            status.modbusConnected = true;
-            status.updated = true;
-            statusLocked = false;
-        }
-        return;
-    }
-    // Check if polling time has elapsed - updated to use RTC seconds instead of millis
-    if(rtcSeconds() - thermocoupleIO_index.tcIO[index].lastUpdate < thermocoupleIO_index.tcIO[index].pollTime/1000) {
-        record_thermocouple(index); // Check if record interval has elapsed before returning
-        return;
+// Poll sequence helpers (one Modbus transaction per step, see tcPollStep_t)
+static void thermocouple_begin_step(thermocoupleIO_t *tc, tcPollStep_t step) {
+    ModbusRTUMasterTransaction *transaction = &tc->transaction;
+    transaction->id = tc->slaveID;
+    transaction->coils = nullptr;
+    transaction->registers = nullptr;
+    switch (step) {
+        case TC_POLL_SETUP_HOLDING:
+        case TC_POLL_WRITE_HOLDING:
+            // Holding registers excluding the first 2 (read only)
+            transaction->functionCode = 16;
+            transaction->address = EXP_HOLDING_REG_BOARD_NAME;
+            transaction->quantity = 40;
+            transaction->registers = tc->holdingRegisters;
+            break;
+        case TC_POLL_SETUP_COILS:
+        case TC_POLL_WRITE_COILS:
+            transaction->functionCode = 15;
+            transaction->address = 0x0000;
+            transaction->quantity = 32;
+            transaction->coils = tc->coils;
+            break;
+        case TC_POLL_SNAPSHOT:
+            transaction->functionCode = 4;
+            transaction->address = TCIO_INPUT_REG_SNAPSHOT;
+            transaction->quantity = TCIO_SNAPSHOT_REG_COUNT;
+            transaction->registers = tc->rxRegisters;
+            break;
+        case TC_POLL_BOARD_TYPE:
+            transaction->functionCode = 3;
+            transaction->address = EXP_HOLDING_REG_BOARD_TYPE;
+            transaction->quantity = 1;
+            transaction->registers = tc->rxRegisters;
+            break;
+        case TC_POLL_STATUS:
+            transaction->functionCode = 3;
+            transaction->address = EXP_HOLDING_REG_STATUS;
+            transaction->quantity = 1;
+            transaction->registers = tc->rxRegisters;
+            break;
+        case TC_POLL_DISCRETE_INPUTS:
+            transaction->functionCode = 2;
+            transaction->address = 0x0000;
+            transaction->quantity = 32;
+            transaction->coils = tc->rxDiscreteInputs;
+            break;
+        case TC_POLL_INPUT_REGISTERS:
+            transaction->functionCode = 4;
+            transaction->address = 0x0000;
+            transaction->quantity = 48;
+            transaction->registers = tc->rxRegisters;
+            break;
+        default:
+            break;
     }
-    thermocoupleIO_index.tcIO[index].lastUpdate = rtcSeconds();
-
-    leds.setPixelColor(LED_MODBUS_STATUS, LED_STATUS_BUSY);
-    leds.show();
+    transaction->status = MODBUS_RTU_MASTER_IDLE;
+    tc->pollStep = step;
+    tc->pollRetries = 0;
+}
 
-    // Check board is online
-    uint16_t buf[1];
-    int retries = 0;
-    while (retries < 3) {
-        if (!thermocoupleIO_index.tcIO[index].bus->readHoldingRegisters(thermocoupleIO_index.tcIO[index].slaveID, EXP_HOLDING_REG_BOARD_TYPE, buf, 1)) {
-            retries++;
-            continue;
-        } else break;
+// Copy changed coil config into the write buffer, returns true if a write is needed
+static bool thermocouple_coils_changed(uint8_t index) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    bool coils[32];
+    memcpy(coils, &tc->reg, sizeof(coils));
+    bool changed = false;
+    for (int i = 0; i < sizeof(coils); i++) {
+        if (tc->coils[i] != coils[i]) {
+            tc->coils[i] = coils[i];
+            changed = true;
+            log(LOG_INFO, true, "Thermocouple board at index %d coil %d changed to %d\n", index, i, coils[i]);
+        }
     }
+    return changed;
+}
 
-    if (retries == 3) {
-        if (getBoard(index)->connected == true) {
-            log(LOG_ERROR, true, "Board at index %d is offline\n", index);
-            getBoard(index)->connected = false;
+// Copy changed holding register config into the write buffer, returns true if a write is needed
+static bool thermocouple_holding_changed(uint8_t index) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    uint16_t holdingRegisters[40];
+    memcpy(holdingRegisters, &tc->reg.boardName, sizeof(holdingRegisters));
+    bool changed = false;
+    for (int i = 0; i < 40; i++) {
+        if (i == EXP_HOLDING_REG_BOARD_TYPE) continue; // Skip board type register (read only!)
+        if (tc->holdingRegisters[i] != holdingRegisters[i]) {
+            tc->holdingRegisters[i] = holdingRegisters[i];
+            changed = true;
+            log(LOG_INFO, true, "Thermocouple board at index %d holding register %d changed to %d\n", index, i, holdingRegisters[i]);
         }
-        return;
     }
-    
+    return changed;
+}
+
+// Check the reported board type and update the connection state, returns false if not a thermocouple board
+static bool thermocouple_check_board_type(uint8_t index, uint16_t boardType) {
     // Ensure board is a thermocouple board (type 2)
-    if (deviceType_t(buf[0]) != THERMOCOUPLE_IO) {
-        log(LOG_ERROR, true, "Board at index %d is not a thermocouple board. Type: %d, %s\n", index, buf[0], getDeviceTypeName(deviceType_t(buf[0])));
-        return;
+    if (deviceType_t(boardType) != THERMOCOUPLE_IO) {
+        log(LOG_ERROR, true, "Board at index %d is not a thermocouple board. Type: %d, %s\n", index, boardType, getDeviceTypeName(deviceType_t(boardType)));
+        return false;
     }
     if (!getBoard(index)->connected) {
         getBoard(index)->connected = true;
         log(LOG_INFO, true, "Board at index %d is online\n", index);
     }
+    return true;
+}
 
-    // Get board status
-    retries = 0;
-    while (retries < 3) {
-        if (!thermocoupleIO_index.tcIO[index].bus->readHoldingRegisters(thermocoupleIO_index.tcIO[index].slaveID, EXP_HOLDING_REG_STATUS, buf, 1)) {
-            retries++;
-        } else break;
-    }
-    if (retries == 3) {
-        log(LOG_ERROR, true, "Failed to read board status\n");
-        return;
-    }
-    thermocoupleIO_index.tcIO[index].modbusError = buf[0] & 0x01;
-    thermocoupleIO_index.tcIO[index].I2CError = (buf[0] >> 1) & 0x01;
-    thermocoupleIO_index.tcIO[index].PSUError = (buf[0] >> 2) & 0x01;
-    thermocoupleIO_index.tcIO[index].Vpsu = static_cast<float>(buf[0] >> 4) / 10.0f;
+static void thermocouple_decode_status(thermocoupleIO_t *tc, uint16_t statusReg) {
+    tc->modbusError = statusReg & 0x01;
+    tc->I2CError = (statusReg >> 1) & 0x01;
+    tc->PSUError = (statusReg >> 2) & 0x01;
+    tc->Vpsu = static_cast<float>(statusReg >> 4) / 10.0f;
+}
 
-    // Register buffers
-    bool coils[32];
-    bool discreteInputs[32];
-    uint16_t holdingRegisters[40];
-    uint16_t inputRegisters[48];
+// All data for this cycle has been read, finish the poll sequence
+static void thermocouple_poll_complete(uint8_t index) {
+    thermocoupleIO_index.tcIO[index].pollStep = TC_POLL_IDLE;
 
-    // Load Coil and Holding Register buffers with current config values
-    memcpy(coils, &thermocoupleIO_index.tcIO[index].reg, sizeof(coils));
-    memcpy(holdingRegisters, &thermocoupleIO_index.tcIO[index].reg.boardName, sizeof(holdingRegisters));
-    bool changed = false;
+    // Handle monitored faults and alarms
+    handle_faults_and_alarms();
 
-    // Check for changes to writable registers and write if changed
-    // Coils ----->
-    for (int i = 0; i < sizeof(coils); i++) {
-        if (thermocoupleIO_index.tcIO[index].coils[i] != coils[i]) {
-            thermocoupleIO_index.tcIO[index].coils[i] = coils[i];
-            changed = true;
-            log(LOG_INFO, true, "Thermocouple board at index %d coil %d changed to %d\n", index, i, coils[i]);
-        }
-    }
-    if (changed) {
-        retries = 0;
-        while (retries < 3) {
-            if(thermocoupleIO_index.tcIO[index].bus->writeMultipleCoils(thermocoupleIO_index.tcIO[index].slaveID, 0x0000, coils, 32)) {
-                log(LOG_INFO, true, "Thermocouple board at index %d coils written successfully\n", index);
-                break;
-            } else {
-                log(LOG_ERROR, true, "Thermocouple board at index %d coils write failed\n", index);
+    // Record temperature data if record interval has elapsed
+    record_thermocouple(index);
+}
+
+// Write any changed config, then read inputs (legacy firmware) or finish (snapshot already read)
+static void thermocouple_write_or_read(uint8_t index, bool checkCoils) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    if (checkCoils && thermocouple_coils_changed(index)) thermocouple_begin_step(tc, TC_POLL_WRITE_COILS);
+    else if (thermocouple_holding_changed(index)) thermocouple_begin_step(tc, TC_POLL_WRITE_HOLDING);
+    else if (tc->snapshotSupported) thermocouple_poll_complete(index);
+    else thermocouple_begin_step(tc, TC_POLL_DISCRETE_INPUTS);
+}
+
+// Handle the result of the current step (after retries) and move to the next one
+static void thermocouple_step_complete(uint8_t index, bool success) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+
+    switch (tc->pollStep) {
+        case TC_POLL_SETUP_HOLDING:
+            if (!success) {
+                log(LOG_ERROR, true, "Failed to write holding register config to thermocouple IO board at index %d\n", index);
+                // Don't mark board as not initialized - it may just be temporarily offline
+                log(LOG_WARNING, true, "Board at index %d may be offline - keeping initialization status\n", index);
+                getBoard(index)->connected = false;
+                tc->pollStep = TC_POLL_IDLE;
+                return;
             }
-            retries++;
-            delay(100); // Wait before retrying
-        }
-        if (retries == 3) {
-            log(LOG_ERROR, true, "Thermocouple board at index %d coils write failed after 3 retries\n", index);
-            getBoard(index)->connected = false;
-            thermocoupleIO_index.tcIO[index].configInitialised = false;
+            thermocouple_begin_step(tc, TC_POLL_SETUP_COILS);
             return;
-        }
-        changed = false;
-    }
 
-    // Holding registers ----->
-    for (int i = 0; i < 40; i++) {
-        if (i == EXP_HOLDING_REG_BOARD_TYPE) continue; // Skip board type register (read only!)
-        if (thermocoupleIO_index.tcIO[index].holdingRegisters[i] != holdingRegisters[i]) {
-            thermocoupleIO_index.tcIO[index].holdingRegisters[i] = holdingRegisters[i];
-            changed = true;
-            log(LOG_INFO, true, "Thermocouple board at index %d holding register %d changed to %d\n", index, i, holdingRegisters[i]);
-        }
-    }
-    if (changed) {
-        retries = 0;
-        while (retries < 3) {
-            if(thermocoupleIO_index.tcIO[index].bus->writeMultipleHoldingRegisters(thermocoupleIO_index.tcIO[index].slaveID, EXP_HOLDING_REG_BOARD_NAME, holdingRegisters, 40)) {
-                log(LOG_INFO, true, "Holding registers written successfully\n");
-                break;
-            } else {
-                log(LOG_ERROR, true, "Holding registers write failed, retrying...\n");
-                retries++;
-                delay(100); // Wait before retrying
+        case TC_POLL_SETUP_COILS:
+            if (!success) {
+                log(LOG_ERROR, true, "Failed to write coil register config to thermocouple IO board at index %d\n", index);
+                log(LOG_WARNING, true, "Board at index %d may be offline - keeping initialization status\n", index);
+                getBoard(index)->connected = false;
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            tc->configInitialised = true;
+            if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
+                status.modbusConnected = true;
+                status.updated = true;
+                coreLockRelease(&statusLock);
+            }
+            thermocouple_begin_step(tc, tc->snapshotSupported ? TC_POLL_SNAPSHOT : TC_POLL_BOARD_TYPE);
+            return;
+
+        case TC_POLL_SNAPSHOT:
+            if (!success) {
+                if (tc->transaction.status == MODBUS_RTU_MASTER_EXCEPTION && tc->transaction.exceptionCode == 2) {
+                    // Illegal data address, board firmware predates the snapshot block
+                    log(LOG_WARNING, true, "Board at index %d does not support snapshot reads, using individual reads\n", index);
+                    tc->snapshotSupported = false;
+                    thermocouple_begin_step(tc, TC_POLL_BOARD_TYPE);
+                    return;
+                }
+                if (getBoard(index)->connected == true) {
+                    log(LOG_ERROR, true, "Board at index %d is offline\n", index);
+                    getBoard(index)->connected = false;
+                }
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            if (!thermocouple_check_board_type(index, tc->rxRegisters[1])) {
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            thermocouple_decode_status(tc, tc->rxRegisters[0]);
+
+            // Unpack discrete inputs and copy input registers
+            for (uint8_t i = 0; i < 32; i++) {
+                tc->rxDiscreteInputs[i] = (tc->rxRegisters[TCIO_SNAPSHOT_FLAGS_PTR + (i >> 4)] >> (i & 15)) & 0x01;
             }
-        } if (retries == 3) {
-            log(LOG_ERROR, true, "Thermocouple board at index %d holding registers write failed after 3 retries\n", index);
-            getBoard(index)->connected = false;
-            thermocoupleIO_index.tcIO[index].configInitialised = false;
+            memcpy(&tc->reg.outputState, tc->rxDiscreteInputs, sizeof(tc->rxDiscreteInputs));
+            memcpy(&tc->reg.temperature, &tc->rxRegisters[TCIO_SNAPSHOT_INPUT_PTR], sizeof(tc->reg.temperature) * 3);
+            thermocouple_publish(index);
+
+            // Check for changes to writable registers and write if changed
+            thermocouple_write_or_read(index, true);
             return;
+
+        case TC_POLL_BOARD_TYPE:
+            if (!success) {
+                if (getBoard(index)->connected == true) {
+                    log(LOG_ERROR, true, "Board at index %d is offline\n", index);
+                    getBoard(index)->connected = false;
+                }
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            if (!thermocouple_check_board_type(index, tc->rxRegisters[0])) {
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            thermocouple_begin_step(tc, TC_POLL_STATUS);
+            return;
+
+        case TC_POLL_STATUS:
+            if (!success) {
+                log(LOG_ERROR, true, "Failed to read board status\n");
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            thermocouple_decode_status(tc, tc->rxRegisters[0]);
+
+            // Check for changes to writable registers and write if changed
+            thermocouple_write_or_read(index, true);
+            return;
+
+        case TC_POLL_WRITE_COILS:
+            if (!success) {
+                log(LOG_ERROR, true, "Thermocouple board at index %d coils write failed after 3 retries\n", index);
+                getBoard(index)->connected = false;
+                tc->configInitialised = false;
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            log(LOG_INFO, true, "Thermocouple board at index %d coils written successfully\n", index);
+            thermocouple_write_or_read(index, false);
+            return;
+
+        case TC_POLL_WRITE_HOLDING:
+            if (!success) {
+                log(LOG_ERROR, true, "Thermocouple board at index %d holding registers write failed after 3 retries\n", index);
+                getBoard(index)->connected = false;
+                tc->configInitialised = false;
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            log(LOG_INFO, true, "Holding registers written successfully\n");
+            if (tc->snapshotSupported) thermocouple_poll_complete(index);
+            else thermocouple_begin_step(tc, TC_POLL_DISCRETE_INPUTS);
+            return;
+
+        case TC_POLL_DISCRETE_INPUTS:
+            if (!success) {
+                log(LOG_ERROR, true, "Thermocouple board at index %d discrete inputs read failed after 3 retries\n", index);
+                getBoard(index)->connected = false;
+                tc->pollStep = TC_POLL_IDLE;
+                return;
+            }
+            memcpy(&tc->reg.outputState, tc->rxDiscreteInputs, sizeof(tc->rxDiscreteInputs));
+            thermocouple_begin_step(tc, TC_POLL_INPUT_REGISTERS);
+            return;
+
+        case TC_POLL_INPUT_REGISTERS:
+            tc->pollStep = TC_POLL_IDLE;
+            if (!success) {
+                log(LOG_ERROR, true, "Thermocouple IO board index %d input registers read failed after 3 retries\n", index);
+                getBoard(index)->connected = false;
+                return;
+            }
+            memcpy(&tc->reg.temperature, tc->rxRegisters, sizeof(tc->reg.temperature) * 3);
+            thermocouple_publish(index);
+            thermocouple_poll_complete(index);
+            return;
+
+        default:
+            tc->pollStep = TC_POLL_IDLE;
+            return;
+    }
+}
+
+// Advance the board's poll sequence without waiting on the bus. A transaction that cannot be
+// submitted because the bus is busy is simply tried again on the next call. A new sequence is
+// started when called while idle, the poll scheduler decides when the board is due.
+// Requests use the slave's adaptive response timeout, and an offline board gets a single attempt.
+// Returns true while a poll sequence is in progress.
+bool manage_thermocouple(uint8_t index, linkState_t *link) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+
+    if (tc->pollStep == TC_POLL_IDLE) {
+        tc->lastUpdate = rtcSeconds();
+
+        if (!tc->configInitialised) {
+            // Push the saved configuration to the board before the first poll
+            memcpy(tc->holdingRegisters, &tc->reg.boardName, sizeof(tc->holdingRegisters));
+            memcpy(tc->coils, &tc->reg, sizeof(tc->coils));
+            thermocouple_begin_step(tc, TC_POLL_SETUP_HOLDING);
+        } else {
+            thermocouple_begin_step(tc, tc->snapshotSupported ? TC_POLL_SNAPSHOT : TC_POLL_BOARD_TYPE);
         }
+        leds.setPixelColor(LED_MODBUS_STATUS, LED_STATUS_BUSY);
+        leds.show();
     }
 
-    // Read discrete inputs
-    retries = 0;
-    while (retries < 3) {
-        if(!thermocoupleIO_index.tcIO[index].bus->readDiscreteInputs(thermocoupleIO_index.tcIO[index].slaveID, 0x0000, discreteInputs, 32)) {
-            retries++;
-        } else break;
+    ModbusRTUMasterTransaction *transaction = &tc->transaction;
+    if (transaction->status == MODBUS_RTU_MASTER_IDLE) {
+        transaction->timeout = link_timeout(link);
+        if (!tc->bus->submit(transaction) && transaction->status == MODBUS_RTU_MASTER_IDLE) return true; // Bus busy
     }
-    if (retries == 3) {
-        log(LOG_ERROR, true, "Thermocouple board at index %d discrete inputs read failed after 3 retries\n", index);
-        getBoard(index)->connected = false;
-        return;
+    tc->bus->poll();
+    if (transaction->status == MODBUS_RTU_MASTER_PENDING) return true;
+    link_update(link, transaction);
+
+    bool success = transaction->status == MODBUS_RTU_MASTER_SUCCESS;
+    // Exception responses are deterministic, only retry on timeouts and frame errors
+    uint8_t attempts = getBoard(index)->connected ? 3 : 1;
+    if (!success && transaction->status != MODBUS_RTU_MASTER_EXCEPTION && ++tc->pollRetries < attempts) {
+        transaction->status = MODBUS_RTU_MASTER_IDLE; // Resubmit on the next call
+        return true;
     }
-    memcpy(&thermocoupleIO_index.tcIO[index].reg.outputState, discreteInputs, sizeof(discreteInputs));
+    thermocouple_step_complete(index, success);
+    return tc->pollStep != TC_POLL_IDLE;
+}
 
-    // Read input registers
-    retries = 0;
-    while (retries < 3) {
-        if(!thermocoupleIO_index.tcIO[index].bus->readInputRegisters(thermocoupleIO_index.tcIO[index].slaveID, 0x0000, inputRegisters, 48)) {
-            retries++;
-        } else break;
+// Snapshot publication ------------------------------------------------------>
+// reg is updated in place by the poller on core 1 while Modbus TCP and the web API read it on
+// core 0. A copy is published under a sequence lock so readers never see a half written block
+// (e.g. the two halves of a float from different polls) and the poller never waits for a reader.
+// The sequence number is odd while the copy is being written, a reader retries if it started
+// during a write or the number changed while it was copying. There is one writer per board.
+// The Modbus wire order image is rebuilt here too, so core 0 never converts registers per request.
+
+static void thermocouple_build_image(const thermocoupleModbus_t *reg, thermocoupleImage_t *image) {
+    // Coils and discrete inputs are the first 64 bools of the register map
+    const bool *bits = (const bool *)reg;
+    image->coils = 0;
+    image->discreteInputs = 0;
+    for (uint8_t i = 0; i < 32; i++) {
+        image->coils |= (uint32_t)bits[i] << i;
+        image->discreteInputs |= (uint32_t)bits[32 + i] << i;
     }
-    if (retries == 3) {
-        log(LOG_ERROR, true, "Thermocouple IO board index %d input registers read failed after 3 retries\n", index);
-        getBoard(index)->connected = false;
-        return;
+
+    uint16_t holding[TCIO_HOLDING_REG_COUNT];
+    memcpy(holding, &reg->status, sizeof(holding));
+    for (uint8_t i = 0; i < TCIO_HOLDING_REG_COUNT; i++) {
+        uint8_t *out = &image->holdingRegisters[i * 2];
+        if (i >= EXP_HOLDING_REG_BOARD_NAME && i < EXP_HOLDING_REG_SLAVE_ID) {
+            memcpy(out, &holding[i], 2); // Characters are already in order
+            continue;
+        }
+        uint16_t value = holding[(i >= TCIO_HOLDING_REG_ALERT_SP && i < TCIO_HOLDING_REG_ALARM_HYST) ? i ^ 1 : i];
+        out[0] = value >> 8;
+        out[1] = value & 0xFF;
     }
-    memcpy(&thermocoupleIO_index.tcIO[index].reg.temperature, inputRegisters, sizeof(inputRegisters));
 
-    // Handle monitored faults and alarms
-    handle_faults_and_alarms();
+    // Input registers are all floats
+    uint16_t input[TCIO_INPUT_REG_COUNT];
+    memcpy(input, reg->temperature, sizeof(input));
+    for (uint8_t i = 0; i < TCIO_INPUT_REG_COUNT; i++) {
+        uint16_t value = input[i ^ 1];
+        image->inputRegisters[i * 2] = value >> 8;
+        image->inputRegisters[i * 2 + 1] = value & 0xFF;
+    }
+}
 
-    // Record temperature data if record interval has elapsed
-    record_thermocouple(index);
+// Only the poller on core 1 writes a board's published copy, the seqlock has a single writer
+void thermocouple_publish(uint8_t index) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    uint32_t seq = tc->publishedSeq;
+    tc->publishedSeq = seq + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    memcpy(&tc->published.reg, &tc->reg, sizeof(tc->reg));
+    tc->published.timestamp = time_us_64();
+    thermocouple_build_image(&tc->reg, &tc->publishedImage);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    tc->publishedSeq = seq + 2;
 }
 
-bool setup_thermocouple(uint8_t index) {
-    // Add a small delay before configuring the board to ensure bus is ready
-    // This is particularly important for the second board during startup
-    delay(100);
-    
-    uint16_t holdingRegisters[40];
-    bool coils[32];
-    memcpy(holdingRegisters, &thermocoupleIO_index.tcIO[index].reg.boardName, sizeof(holdingRegisters));
-    memcpy(coils, &thermocoupleIO_index.tcIO[index].reg, sizeof(coils));
-
-    // Retry mechanism for holding registers
-    int retries = 0;
-    bool success = false;
-    while (retries < 3 && !success) {
-        // Attempt to load holding registers (excluding first 2 registers)
-        success = thermocoupleIO_index.tcIO[index].bus->writeMultipleHoldingRegisters(
-            thermocoupleIO_index.tcIO[index].slaveID, 
-            EXP_HOLDING_REG_BOARD_NAME, 
-            holdingRegisters, 
-            40);
-            
-        if (!success) {
-            log(LOG_WARNING, true, "Failed to write holding registers to board %d (attempt %d/3)\n", 
-                index, retries + 1);
-            retries++;
-            delay(200); // Increasing delay between retries
+// Copy the last published data of a board, returns false if the board hasn't been published yet
+bool thermocouple_read_snapshot(uint8_t index, thermocoupleSnapshot_t *snapshot) {
+    if (index >= 16) return false;
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    uint32_t seq;
+    do {
+        while ((seq = tc->publishedSeq) & 1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        memcpy(snapshot, &tc->published, sizeof(*snapshot));
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    } while (tc->publishedSeq != seq);
+    return snapshot->timestamp != 0;
+}
+
+// Copy part of the last published wire order image of a board (offset and length in bytes, see
+// thermocoupleImage_t). Returns false if the board hasn't been published yet.
+bool thermocouple_read_image(uint8_t index, size_t offset, size_t length, void *data) {
+    if (index >= 16 || offset + length > sizeof(thermocoupleImage_t)) return false;
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+    uint32_t seq;
+    do {
+        while ((seq = tc->publishedSeq) & 1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        memcpy(data, (const uint8_t *)&tc->publishedImage + offset, length);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    } while (tc->publishedSeq != seq);
+    return seq != 0;
+}
+
+// Copy the config registers of a board back into its saved config, so the next
+// apply_board_configs() and the web UI have the values written over Modbus TCP. The slave ID isn't
+// copied, the board is still addressed by its configured ID.
+static void thermocouple_store_config(uint8_t index) {
+    const thermocoupleModbus_t *reg = &thermocoupleIO_index.tcIO[index].reg;
+    for (uint8_t i = 0; i < boardCount; i++) {
+        BoardConfig *board = &boardConfigs[i];
+        if (board->type != THERMOCOUPLE_IO || board->boardIndex != index) continue;
+        memcpy(board->boardName, reg->boardName, sizeof(board->boardName));
+        board->boardName[sizeof(board->boardName) - 1] = '\0';
+        for (uint8_t ch = 0; ch < 8; ch++) {
+            auto &channel = board->settings.thermocoupleIO.channels[ch];
+            channel.alertEnable = reg->alertEnable[ch];
+            channel.outputEnable = reg->outputEnable[ch];
+            channel.alertLatch = reg->alertLatch[ch];
+            channel.alertEdge = reg->alertEdge[ch];
+            channel.tcType = (uint8_t)reg->type[ch];
+            channel.alertSetpoint = reg->alertSP[ch];
+            channel.alertHysteresis = (uint8_t)min(reg->alarmHyst[ch], (uint16_t)UINT8_MAX);
         }
+        markBoardConfigChanged();
+        return;
     }
-    
-    if (!success) {
-        log(LOG_ERROR, true, "Failed to write holding register config to thermocouple IO board at index %d\n", index);
-        return false;
-    }
-    
-    // Copy holding registers to local buffer
-    memcpy(thermocoupleIO_index.tcIO[index].holdingRegisters, holdingRegisters, sizeof(holdingRegisters));
+}
 
-    // Reset retry counter for coils
-    retries = 0;
-    success = false;
-    
-    // Retry mechanism for coils
-    while (retries < 3 && !success) {
-        // Attempt to load coils
-        success = thermocoupleIO_index.tcIO[index].bus->writeMultipleCoils(
-            thermocoupleIO_index.tcIO[index].slaveID, 
-            0x0000, 
-            coils, 
-            32);
-            
-        if (!success) {
-            log(LOG_WARNING, true, "Failed to write coils to board %d (attempt %d/3)\n", 
-                index, retries + 1);
-            retries++;
-            delay(200); // Increasing delay between retries
+// A write sent through the bus queue (e.g. from Modbus TCP) has been applied by a board. Mirror it
+// into the board's config and write buffers so the poller doesn't write the old value back and
+// readers see the new value straight away, and into its saved config (written by core 0) so it
+// isn't undone by the next apply_board_configs(). Latch reset coils aren't stored.
+void thermocouple_write_complete(uint8_t port, const ModbusRTUMasterTransaction *transaction) {
+    uint8_t functionCode = transaction->functionCode;
+    if (functionCode != 5 && functionCode != 6 && functionCode != 15 && functionCode != 16) return;
+
+    for (uint8_t index = 0; index < 16; index++) {
+        thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[index];
+        if (tc->bus != modbusConfig[port].bus || tc->slaveID != transaction->id || !tc->configInitialised) continue;
+
+        // Coils map onto the start of reg, holding registers from the board name on (see thermocoupleModbus_t)
+        bool *coils = (bool *)&tc->reg;
+        uint8_t *holding = (uint8_t *)&tc->reg.boardName;
+        uint16_t address = transaction->address;
+        uint16_t quantity = (functionCode == 5 || functionCode == 6) ? 1 : transaction->quantity;
+        bool stored = false;
+        for (uint16_t i = 0; i < quantity; i++) {
+            if (functionCode == 5 || functionCode == 15) {
+                if (address + i >= sizeof(tc->coils)) break;
+                bool value = functionCode == 5 ? transaction->value != 0 : transaction->coils[i];
+                coils[address + i] = value;
+                tc->coils[address + i] = value;
+                stored = true;
+            } else {
+                if (address + i < EXP_HOLDING_REG_BOARD_NAME) continue;
+                uint16_t reg = address + i - EXP_HOLDING_REG_BOARD_NAME;
+                if (reg >= 40) break;
+                uint16_t value = functionCode == 6 ? transaction->value : transaction->registers[i];
+                memcpy(holding + reg * 2, &value, sizeof(value));
+                tc->holdingRegisters[reg] = value;
+                stored = true;
+            }
         }
+        if (stored) thermocouple_store_config(index);
+        thermocouple_publish(index);
+        return;
     }
-    
-    if (!success) {
-        log(LOG_ERROR, true, "Failed to write coil register config to thermocouple IO board at index %d\n", index);
-        return false;
-    }
-    
-    // Copy coils to local buffer
-    memcpy(thermocoupleIO_index.tcIO[index].coils, coils, sizeof(coils));
-    return true;
 }
 
+// Latch resets are queued on the board's bus (they can be called from core 0)
 bool thermocouple_latch_reset(uint8_t index, uint8_t channel) {
     if (index >= boardCount) return false;
     if (channel > 8) return false;
 
-    return thermocoupleIO_index.tcIO[index].bus->writeSingleCoil(thermocoupleIO_index.tcIO[index].slaveID, channel + TCIO_COIL_LATCH_RESET_PTR, true);
+    ModbusRTUMasterTransaction request;
+    request.id = thermocoupleIO_index.tcIO[index].slaveID;
+    request.functionCode = 5;
+    request.address = channel + TCIO_COIL_LATCH_RESET_PTR;
+    request.value = true;
+    return bus_command_run(getBoard(index)->modbusPort, BUS_PRIORITY_OPERATOR, &request);
 }    
 
 bool thermocouple_latch_reset_all(uint8_t index) {
     if (index >= boardCount) return false;
 
     bool buf[8] = {true, true, true, true, true, true, true, true};
-    return thermocoupleIO_index.tcIO[index].bus->writeMultipleCoils(thermocoupleIO_index.tcIO[index].slaveID, TCIO_COIL_LATCH_RESET_PTR, buf, 8);
+    ModbusRTUMasterTransaction request;
+    request.id = thermocoupleIO_index.tcIO[index].slaveID;
+    request.functionCode = 15;
+    request.address = TCIO_COIL_LATCH_RESET_PTR;
+    request.quantity = 8;
+    request.coils = buf;
+    return bus_command_run(getBoard(index)->modbusPort, BUS_PRIORITY_OPERATOR, &request);
 }
 
 bool record_thermocouple(uint8_t index) {
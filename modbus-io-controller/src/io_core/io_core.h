@@ -2,17 +2,44 @@
 
 #include "sys_init.h"
 #include "io_objects.h"
+#include "bus_queue.h"
 
 // Forward declarations to avoid circular dependencies
 struct BoardConfig;
 
+// Response timeouts are derived from each slave's measured response time within these limits
+#define RESPONSE_TIMEOUT_MIN_US 2000
+#define RESPONSE_TIMEOUT_MAX_US 100000
+
+// Offline boards are probed every poll period doubled per failed probe, up to this interval
+#define OFFLINE_PROBE_MAX_MS 10000
+
 // Top level structs
+struct pollEntry_t {
+    uint64_t due;           // Poll deadline (us, monotonic)
+    uint8_t slot;           // Device index slot
+};
+
+// Modbus TCP unit ID route to a board, see build_tcp_unit_routes()
+struct tcpUnitRoute_t {
+    bool routed;
+    uint8_t board;          // thermocoupleIO_index slot
+    uint8_t port;           // RS485 port
+    uint8_t slaveID;        // Slave ID on that port
+};
+
 struct modbusConfig_t {
-    ModbusRTUMaster *bus;
-    bool idAssigned[243];
+    ModbusRTUMaster *bus = nullptr;
+    bool idAssigned[243] = {};
+    int8_t pollOwner = -1;              // Device index slot currently polling this bus, -1 if free
+    pollEntry_t pollQueue[64] = {};     // Min-heap of devices on this bus ordered by next poll deadline
+    uint8_t pollQueueSize = 0;
+    busCommandQueue_t commands = {};    // Requests from outside the poll scheduler, see bus_queue.h
 };
 
 // Object definitions
+extern ModbusRTUTransportRP2040 rs485Port1;
+extern ModbusRTUTransportRP2040 rs485Port2;
 extern ModbusRTUMaster bus1;
 extern ModbusRTUMaster bus2;
 
@@ -29,17 +56,27 @@ void apply_board_configs(void);
 bool apply_thermocouple_config(BoardConfig* config);
 uint8_t findFreeDeviceIndex(void);
 void updateModbusAddressTracking(void);
+pollStats_t *getPollStats(uint8_t boardIndex);
+void poll_queue_push(modbusConfig_t *busCfg, uint8_t slot, uint64_t due);
+pollEntry_t poll_queue_pop(modbusConfig_t *busCfg);
+uint64_t poll_next_due(uint64_t due, uint64_t now, uint64_t period, uint32_t *missed);
+linkState_t *getLinkState(uint8_t boardIndex);
+void build_tcp_unit_routes(void);
+bool tcp_unit_route(uint8_t unitId, tcpUnitRoute_t *route);
 
 // Board specific handlers
 // Analogue digital IO board management functions ------------>
 void manage_analogue_digital_io(uint8_t index);
 
 // Thermocouple board management functions ------------------->
-void manage_thermocouple(uint8_t index);
-bool setup_thermocouple(uint8_t index);
+bool manage_thermocouple(uint8_t index, linkState_t *link);
 bool thermocouple_latch_reset(uint8_t index, uint8_t channel);
 bool thermocouple_latch_reset_all(uint8_t index);
 bool record_thermocouple(uint8_t index);
+void thermocouple_publish(uint8_t index);
+bool thermocouple_read_snapshot(uint8_t index, thermocoupleSnapshot_t *snapshot);
+bool thermocouple_read_image(uint8_t index, size_t offset, size_t length, void *data);
+void thermocouple_write_complete(uint8_t port, const ModbusRTUMasterTransaction *transaction);
 
 // RTD board management functions ---------------------------->
 void manage_rtd(uint8_t index);
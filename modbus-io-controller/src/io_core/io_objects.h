@@ -8,11 +8,34 @@ enum deviceType_t {
     ENERGY_METER
 };
 
+// Poll timing statistics, lateness is measured from the scheduled deadline to the start of the poll
+struct pollStats_t {
+    uint32_t polls = 0;
+    uint32_t missed = 0;        // Poll slots skipped because the bus was saturated
+    uint32_t lastLateness = 0;  // us
+    uint32_t maxLateness = 0;   // us
+    uint32_t avgLateness = 0;   // us, moving average over ~8 polls
+};
+
+// Response timing and offline backoff of one slave (see io_core.cpp)
+struct linkState_t {
+    uint32_t srtt = 0;          // us, smoothed response time, 0 until the first response
+    uint32_t rttvar = 0;        // us, smoothed mean deviation of the response time
+    uint32_t lastRtt = 0;       // us
+    uint32_t timeout = 0;       // us, response timeout for the next request
+    uint32_t timeouts = 0;      // Requests that timed out
+    uint8_t backoff = 0;        // Failed probes while offline, the probe interval doubles with each
+};
+
 // Index object
 struct deviceIndex_t {
     deviceType_t type = THERMOCOUPLE_IO;
     uint8_t index = 0;
+    uint8_t port = 0;       // RS485 port the device is polled on
     bool configured = false;
+    uint64_t nextPoll = 0;  // Next poll deadline (us, monotonic)
+    pollStats_t pollStats;
+    linkState_t link;
 };
 
 // Key standard holding register addresses
@@ -73,6 +96,47 @@ struct thermocoupleModbus_t { // Thermocouple interface board modbus registers (
 #define TCIO_HOLDING_REG_ALARM_HYST     34
 
 #define TCIO_COIL_LATCH_RESET_PTR 32
+#define TCIO_COIL_COUNT                 40  // 32 config coils followed by 8 latch reset coils (write only)
+#define TCIO_HOLDING_REG_COUNT          42
+#define TCIO_DISCRETE_INPUT_COUNT       32
+#define TCIO_INPUT_REG_COUNT            48
+#define TCIO_TC_TYPE_MAX                7
+
+// TCIO snapshot input register block (status, type, packed discrete inputs, FC04 registers 0-47)
+#define TCIO_INPUT_REG_SNAPSHOT         48
+#define TCIO_SNAPSHOT_REG_COUNT         52
+#define TCIO_SNAPSHOT_FLAGS_PTR         2
+#define TCIO_SNAPSHOT_INPUT_PTR         4
+
+// Thermocouple poll sequence, one Modbus transaction per step
+enum tcPollStep_t {
+    TC_POLL_IDLE,
+    TC_POLL_SETUP_HOLDING,      // Initial configuration push
+    TC_POLL_SETUP_COILS,
+    TC_POLL_SNAPSHOT,           // Periodic poll (single read)
+    TC_POLL_BOARD_TYPE,         // Periodic poll (legacy firmware without the snapshot block)
+    TC_POLL_STATUS,
+    TC_POLL_WRITE_COILS,
+    TC_POLL_WRITE_HOLDING,
+    TC_POLL_DISCRETE_INPUTS,
+    TC_POLL_INPUT_REGISTERS
+};
+
+// Copy of a board's registers published for readers on core 0 (Modbus TCP, web API)
+struct thermocoupleSnapshot_t {
+    thermocoupleModbus_t reg;
+    uint64_t timestamp = 0;     // time_us_64() when the data was read from the board, 0 if never
+};
+
+// The same registers in Modbus wire order, built when they are published so Modbus TCP reads are
+// served with a bounds check and a copy. Registers are big-endian with floats high word first and
+// the board name in character order. Bit n of coils/discreteInputs is coil/input n.
+struct thermocoupleImage_t {
+    uint32_t coils;                                         // FC01, the 32 config coils
+    uint32_t discreteInputs;                                // FC02
+    uint8_t holdingRegisters[TCIO_HOLDING_REG_COUNT * 2];   // FC03
+    uint8_t inputRegisters[TCIO_INPUT_REG_COUNT * 2];       // FC04
+};
 
 struct thermocoupleIO_t {
     ModbusRTUMaster *bus;
@@ -94,6 +158,18 @@ struct thermocoupleIO_t {
     bool I2CError = false;
     bool PSUError = false;
     float Vpsu = 0;
+    // Non-blocking poll sequence state
+    tcPollStep_t pollStep = TC_POLL_IDLE;
+    uint8_t pollRetries = 0;
+    ModbusRTUMasterTransaction transaction;
+    uint16_t rxRegisters[TCIO_SNAPSHOT_REG_COUNT];
+    bool rxDiscreteInputs[32];
+    bool snapshotSupported = true;  // Cleared if the board firmware rejects the snapshot read
+    // Seqlock protected copy of reg, see thermocouple_publish() and thermocouple_read_snapshot()
+    thermocoupleSnapshot_t published;
+    thermocoupleImage_t publishedImage;
+    volatile uint32_t publishedSeq = 0;
+    volatile bool republish = false;    // Config applied, published again by the poller (the only writer)
 };
   
 struct thermocoupleIO_index_t {
@@ -27,7 +27,7 @@ void setup1()
   core1setupComplete = true;
   while (!core0setupComplete) delay(100);
   if (!sdInfo.inserted) return;
-  while (!sdInfo.ready || sdLocked) delay(100);
+  while (!sdInfo.ready || coreLockHeld(&sdLock)) delay(100);
   log(LOG_INFO, true, "---------> System started successfully <---------\n");
 }
 
@@ -7,17 +7,17 @@
 ModbusTCPServer modbusServer;
 ModbusTCPConfig modbusTCPConfig;
 
-ModbusTCPServer::ModbusTCPServer() : _server(nullptr), _running(false) {
-    // Initialize client connections
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        _clients[i].active = false;
-        _clients[i].lastActivity = 0;
-        _clients[i].clientIP = "";
-    }
-    
+ModbusTCPServer::ModbusTCPServer() : _server(nullptr), _clients(nullptr), _poolSize(0), _nextClient(0), _running(false),
+                                     _passThroughCount(0), _cacheHits(0) {
     // Default configuration
     _config.port = MODBUS_TCP_DEFAULT_PORT;
     _config.enabled = true;
+    _config.ackBeforeApply = false;
+    _config.maxClients = MODBUS_TCP_DEFAULT_CLIENTS;
+    _config.rateLimit = 0;
+    _config.passThrough = false;
+    _config.cacheRangeCount = defaultModbusCacheRanges(_config.cacheRanges);
+    memset(_cache, 0, sizeof(_cache));
 }
 
 ModbusTCPServer::~ModbusTCPServer() {
@@ -39,6 +39,22 @@ bool ModbusTCPServer::begin(uint16_t port) {
         log(LOG_ERROR, true, "Failed to create Modbus TCP server\n");
         return false;
     }
+
+    // Connection pool, sized once per start so polling never allocates
+    _poolSize = constrain(_config.maxClients, 1, MODBUS_TCP_MAX_CLIENTS);
+    _clients = new ModbusClientConnection[_poolSize];
+    if (!_clients) {
+        log(LOG_ERROR, true, "Failed to allocate Modbus TCP connection pool\n");
+        delete _server;
+        _server = nullptr;
+        _poolSize = 0;
+        return false;
+    }
+    for (int i = 0; i < _poolSize; i++) {
+        _clients[i].active = false;
+        _clients[i].clientIP[0] = '\0';
+    }
+    _nextClient = 0;
     
     _server->begin();
     _running = true;
@@ -54,6 +70,9 @@ void ModbusTCPServer::stop() {
         delete _server;
         _server = nullptr;
     }
+    delete[] _clients;
+    _clients = nullptr;
+    _poolSize = 0;
     _running = false;
     log(LOG_INFO, true, "Modbus TCP server stopped\n");
 }
@@ -74,15 +93,25 @@ void ModbusTCPServer::acceptNewClients() {
     WiFiClient newClient = _server->accept();
     if (newClient) {
         int slot = findFreeClientSlot();
+        if (slot < 0) slot = evictIdleClient();
         if (slot >= 0) {
-            _clients[slot].client = newClient;
-            _clients[slot].active = true;
-            _clients[slot].lastActivity = millis();
-            _clients[slot].connectionTime = millis();
-            _clients[slot].clientIP = newClient.remoteIP().toString();
+            ModbusClientConnection& client = _clients[slot];
+            client.client = newClient;
+            client.active = true;
+            client.lastActivity = millis();
+            client.connectionTime = millis();
+            strlcpy(client.clientIP, newClient.remoteIP().toString().c_str(), sizeof(client.clientIP));
+            client.rxHead = 0;
+            client.rxCount = 0;
+            client.requests = 0;
+            client.throttled = 0;
+            client.tokens = (uint32_t)_config.rateLimit * 1000;
+            client.lastRefill = micros();
+            client.pendingPassThrough = false;
+            client.client.setNoDelay(true); // Responses are small, send each one immediately
             
             log(LOG_INFO, true, "Modbus TCP client connected from %s (slot %d)\n", 
-                _clients[slot].clientIP.c_str(), slot);
+                client.clientIP, slot);
         } else {
             // No free slots, reject the connection
             newClient.stop();
@@ -91,46 +120,121 @@ void ModbusTCPServer::acceptNewClients() {
     }
 }
 
+// Clients are serviced round robin, starting one further along each poll, and each gets at most
+// MODBUS_TCP_REQUESTS_PER_TURN requests answered per turn. A client that pipelines many requests
+// keeps the rest buffered for its next turn instead of holding up the others.
 void ModbusTCPServer::processClientRequests() {
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        if (_clients[i].active && _clients[i].client.connected()) {
-            if (_clients[i].client.available()) {
-                _clients[i].lastActivity = millis();
-                processModbusRequest(_clients[i]);
-            }
+    if (_poolSize == 0) return;
+    for (int n = 0; n < _poolSize; n++) {
+        serviceClient((_nextClient + n) % _poolSize);
+    }
+    _nextClient = (_nextClient + 1) % _poolSize;
+}
+
+void ModbusTCPServer::serviceClient(int slot) {
+    ModbusClientConnection& client = _clients[slot];
+    if (!client.active || !client.client.connected()) return;
+
+    if (receiveClientData(client)) client.lastActivity = millis();
+
+    // Answer the complete requests received so far, in order
+    uint8_t adu[MODBUS_TCP_MAX_ADU_SIZE];
+    for (int answered = 0; answered < MODBUS_TCP_REQUESTS_PER_TURN; ) {
+        // A pending RTU write holds the client's next request until it is answered
+        if (client.pendingRequest.slot >= 0) {
+            completePendingRequest(client);
+            if (client.pendingRequest.slot >= 0) return;
         }
+        if (client.rxCount < MODBUS_TCP_MBAP_SIZE) return;
+        if (!takeRateToken(client)) {
+            client.throttled++;
+            return;
+        }
+        int aduLength = takeRequest(client, adu);
+        if (aduLength == 0) return;
+        if (aduLength < 0) {
+            // The length field is the only framing, once it is invalid the stream can't be resynchronised
+            log(LOG_WARNING, true, "Modbus TCP client %s sent an invalid frame, closing connection (slot %d)\n",
+                client.clientIP, slot);
+            client.client.stop();   // Slot is released by cleanupInactiveClients()
+            return;
+        }
+        processModbusRequest(client, adu, aduLength);
+        client.tokens -= client.tokens >= 1000 ? 1000 : client.tokens;
+        client.requests++;
+        answered++;
+    }
+}
+
+// Refill the client's token bucket and check it holds a request, always true without a rate limit
+bool ModbusTCPServer::takeRateToken(ModbusClientConnection& client) {
+    if (_config.rateLimit == 0) return true;
+    uint32_t now = micros();
+    uint32_t capacity = (uint32_t)_config.rateLimit * 1000;
+    uint64_t refill = (uint64_t)(now - client.lastRefill) * _config.rateLimit / 1000;
+    client.lastRefill = now;
+    client.tokens = (uint32_t)min((uint64_t)capacity, client.tokens + refill);
+    return client.tokens >= 1000;
+}
+
+// Move the bytes the client has sent into its receive buffer, as many as fit. Returns the number read.
+uint16_t ModbusTCPServer::receiveClientData(ModbusClientConnection& client) {
+    uint16_t received = 0;
+    while (client.rxCount < MODBUS_TCP_RX_BUFFER_SIZE && client.client.available() > 0) {
+        uint16_t tail = (client.rxHead + client.rxCount) & (MODBUS_TCP_RX_BUFFER_SIZE - 1);
+        uint16_t space = min(MODBUS_TCP_RX_BUFFER_SIZE - client.rxCount, MODBUS_TCP_RX_BUFFER_SIZE - tail);
+        int count = client.client.read(&client.rxBuffer[tail], space);
+        if (count <= 0) break;
+        client.rxCount += count;
+        received += count;
     }
+    return received;
+}
+
+// Take the next complete ADU out of the client's receive buffer. Returns its length, 0 if it
+// hasn't been received in full yet, or -1 if the MBAP length field is invalid.
+int ModbusTCPServer::takeRequest(ModbusClientConnection& client, uint8_t* adu) {
+    const uint16_t mask = MODBUS_TCP_RX_BUFFER_SIZE - 1;
+    if (client.rxCount < MODBUS_TCP_MBAP_SIZE) return 0;
+
+    // Length covers the unit ID and the PDU, which holds at least a function code
+    uint16_t length = (client.rxBuffer[(client.rxHead + 4) & mask] << 8) | client.rxBuffer[(client.rxHead + 5) & mask];
+    if (length < 2 || length > MODBUS_TCP_MAX_PDU_SIZE + 1) return -1;
+    uint16_t aduLength = MODBUS_TCP_MBAP_SIZE - 1 + length;
+    if (client.rxCount < aduLength) return 0;
+
+    uint16_t first = min(aduLength, (uint16_t)(MODBUS_TCP_RX_BUFFER_SIZE - client.rxHead));
+    memcpy(adu, &client.rxBuffer[client.rxHead], first);
+    memcpy(&adu[first], client.rxBuffer, aduLength - first);
+    client.rxHead = (client.rxHead + aduLength) & mask;
+    client.rxCount -= aduLength;
+    if (client.rxCount == 0) client.rxHead = 0;
+    return aduLength;
 }
 
 void ModbusTCPServer::cleanupInactiveClients() {
     uint32_t currentTime = millis();
     
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+    for (int i = 0; i < _poolSize; i++) {
         if (_clients[i].active) {
             // Check if client is still connected (primary disconnect detection)
             if (!_clients[i].client.connected()) {
                 log(LOG_INFO, true, "Modbus TCP client %s disconnected (slot %d, connected for %lu ms)\n", 
-                    _clients[i].clientIP.c_str(), i, currentTime - _clients[i].connectionTime);
-                _clients[i].client.stop();
-                _clients[i].active = false;
-                _clients[i].clientIP = "";
-                _clients[i].connectionTime = 0;
+                    _clients[i].clientIP, i, currentTime - _clients[i].connectionTime);
+                releaseClient(i);
             }
             // Check for timeout (only if no activity for extended period)
             else if (currentTime - _clients[i].lastActivity > MODBUS_TCP_TIMEOUT) {
                 log(LOG_WARNING, true, "Modbus TCP client %s timed out after %lu ms of inactivity (slot %d)\n", 
-                    _clients[i].clientIP.c_str(), MODBUS_TCP_TIMEOUT, i);
-                _clients[i].client.stop();
-                _clients[i].active = false;
-                _clients[i].clientIP = "";
-                _clients[i].connectionTime = 0;
+                    _clients[i].clientIP, MODBUS_TCP_TIMEOUT, i);
+                releaseClient(i);
             }
         }
     }
 }
 
 int ModbusTCPServer::findFreeClientSlot() {
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+    for (int i = 0; i < _poolSize; i++) {
         if (!_clients[i].active) {
             return i;
         }
@@ -138,20 +242,42 @@ int ModbusTCPServer::findFreeClientSlot() {
     return -1;
 }
 
-bool ModbusTCPServer::processModbusRequest(ModbusClientConnection& client) {
-    if (client.client.available() < 7) {
-        return false; // Need at least MBAP header
+// Make room in a full pool by closing the least recently active client, if it has been idle for at
+// least MODBUS_TCP_EVICT_IDLE_MS and has no write in progress. Returns the freed slot or -1.
+int ModbusTCPServer::evictIdleClient() {
+    uint32_t currentTime = millis();
+    int oldest = -1;
+    for (int i = 0; i < _poolSize; i++) {
+        if (!_clients[i].active || _clients[i].pendingRequest.slot >= 0) continue;
+        if (currentTime - _clients[i].lastActivity < MODBUS_TCP_EVICT_IDLE_MS) continue;
+        if (oldest < 0 || currentTime - _clients[i].lastActivity > currentTime - _clients[oldest].lastActivity) {
+            oldest = i;
+        }
     }
-    
+    if (oldest >= 0) {
+        log(LOG_INFO, true, "Modbus TCP client %s evicted for a new connection, idle for %lu ms (slot %d)\n",
+            _clients[oldest].clientIP, currentTime - _clients[oldest].lastActivity, oldest);
+        releaseClient(oldest);
+    }
+    return oldest;
+}
+
+void ModbusTCPServer::releaseClient(int slot) {
+    bus_command_cancel(&_clients[slot].pendingRequest);
+    _clients[slot].client.stop();
+    _clients[slot].active = false;
+    _clients[slot].clientIP[0] = '\0';
+    _clients[slot].connectionTime = 0;
+}
+
+// Answer one complete ADU, the MBAP length has already been checked by takeRequest()
+bool ModbusTCPServer::processModbusRequest(ModbusClientConnection& client, const uint8_t* adu, uint16_t aduLength) {
     // Read MBAP header
     ModbusMBAPHeader header;
-    uint8_t headerBytes[7];
-    client.client.readBytes(headerBytes, 7);
-    
-    header.transactionId = (headerBytes[0] << 8) | headerBytes[1];
-    header.protocolId = (headerBytes[2] << 8) | headerBytes[3];
-    header.length = (headerBytes[4] << 8) | headerBytes[5];
-    header.unitId = headerBytes[6];
+    header.transactionId = (adu[0] << 8) | adu[1];
+    header.protocolId = (adu[2] << 8) | adu[3];
+    header.length = (adu[4] << 8) | adu[5];
+    header.unitId = adu[6];
     
     // Validate protocol ID
     if (header.protocolId != 0) {
@@ -159,43 +285,48 @@ bool ModbusTCPServer::processModbusRequest(ModbusClientConnection& client) {
         return false;
     }
     
-    // Read PDU (Protocol Data Unit)
-    uint16_t pduLength = header.length - 1; // Subtract unit ID
-    if (pduLength > 253) { // Maximum PDU length
-        sendModbusException(client, header.transactionId, header.unitId, 0, MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE);
-        return false;
-    }
-    
-    uint8_t pdu[253];
-    if (client.client.readBytes(pdu, pduLength) != pduLength) {
-        return false;
-    }
+    // PDU (Protocol Data Unit)
+    const uint8_t* pdu = &adu[MODBUS_TCP_MBAP_SIZE];
+    uint16_t pduLength = aduLength - MODBUS_TCP_MBAP_SIZE;
     
     // Forward to RTU if unit ID is not 0xFF (TCP broadcast)
     if (header.unitId != 0xFF && header.unitId != 0) {
-        uint8_t rtuResponse[256];
-        uint16_t rtuResponseLength;
+        uint8_t functionCode = pdu[0];
+
+        // Anything outside the thermocouple register map goes to the board as it is
+        if (_config.passThrough && !isMappedRequest(header.unitId, pdu, pduLength)) {
+            uint8_t exceptionCode = passThroughRequest(client, header, pdu, pduLength);
+            if (exceptionCode) {
+                sendModbusException(client, header.transactionId, header.unitId, functionCode, exceptionCode);
+                return false;
+            }
+            return true;
+        }
+
+        // Writes go to the board through its bus queue and are answered when applied
+        if (functionCode == MODBUS_FC_WRITE_SINGLE_COIL || functionCode == MODBUS_FC_WRITE_SINGLE_REGISTER ||
+            functionCode == MODBUS_FC_WRITE_MULTIPLE_COILS || functionCode == MODBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+            uint8_t exceptionCode = queueWriteRequest(client, header, pdu, pduLength);
+            if (exceptionCode) {
+                sendModbusException(client, header.transactionId, header.unitId, functionCode, exceptionCode);
+                return false;
+            }
+            return true;
+        }
+
+        // Reads carry an address and quantity
+        if (pduLength < 5) {
+            sendModbusException(client, header.transactionId, header.unitId, functionCode, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+            return false;
+        }
+
         uint8_t pduResponse[256];
         uint16_t pduResponseLength;
         
         // Handle read request using cached data
         if (handleReadRequest(header.unitId, pdu[0], (pdu[1] << 8) | pdu[2], (pdu[3] << 8) | pdu[4], pduResponse, pduResponseLength)) {
             // Send successful response back to TCP client
-            uint8_t tcpResponse[260]; // MBAP + PDU response
-            
-            // Build MBAP header for response
-            tcpResponse[0] = (header.transactionId >> 8) & 0xFF;
-            tcpResponse[1] = header.transactionId & 0xFF;
-            tcpResponse[2] = 0; // Protocol ID high byte
-            tcpResponse[3] = 0; // Protocol ID low byte
-            tcpResponse[4] = ((pduResponseLength + 1) >> 8) & 0xFF; // Length high byte
-            tcpResponse[5] = (pduResponseLength + 1) & 0xFF; // Length low byte
-            tcpResponse[6] = header.unitId; // Unit ID
-            
-            // Copy PDU response
-            memcpy(&tcpResponse[7], pduResponse, pduResponseLength);
-            
-            sendModbusResponse(client, tcpResponse, 7 + pduResponseLength);
+            sendModbusPdu(client, header.transactionId, header.unitId, pduResponse, pduResponseLength);
             return true;
         } else {
             // RTU communication failed
@@ -209,9 +340,25 @@ bool ModbusTCPServer::processModbusRequest(ModbusClientConnection& client) {
     return false;
 }
 
+// No flush(), it waits for the client to ACK, which would limit pipelined requests to one per round trip
 void ModbusTCPServer::sendModbusResponse(ModbusClientConnection& client, uint8_t* response, uint16_t length) {
     client.client.write(response, length);
-    client.client.flush();
+}
+
+void ModbusTCPServer::sendModbusPdu(ModbusClientConnection& client, uint16_t transactionId, uint8_t unitId, const uint8_t* pdu, uint16_t pduLength) {
+    uint8_t response[MODBUS_TCP_MAX_ADU_SIZE];
+    
+    // MBAP header
+    response[0] = (transactionId >> 8) & 0xFF;
+    response[1] = transactionId & 0xFF;
+    response[2] = 0; // Protocol ID high byte
+    response[3] = 0; // Protocol ID low byte
+    response[4] = ((pduLength + 1) >> 8) & 0xFF; // Length high byte
+    response[5] = (pduLength + 1) & 0xFF; // Length low byte
+    response[6] = unitId;
+    
+    memcpy(&response[MODBUS_TCP_MBAP_SIZE], pdu, pduLength);
+    sendModbusResponse(client, response, MODBUS_TCP_MBAP_SIZE + pduLength);
 }
 
 void ModbusTCPServer::sendModbusException(ModbusClientConnection& client, uint16_t transactionId, uint8_t unitId, uint8_t functionCode, uint8_t exceptionCode) {
@@ -228,168 +375,64 @@ void ModbusTCPServer::sendModbusException(ModbusClientConnection& client, uint16
     
     // Exception response
     response[7] = functionCode | 0x80; // Set exception bit
+    response[8] = exceptionCode;
+
+    sendModbusResponse(client, response, sizeof(response));
 }
 
-bool ModbusTCPServer::handleReadRequest(uint8_t slaveId, uint8_t functionCode, uint16_t startAddress, 
-                                       uint16_t quantity, uint8_t* response, uint16_t& responseLength) {
-    // Find the board with matching slave ID
-    int boardIndex = -1;
-    for (int i = 0; i < 16; i++) {
-        if (thermocoupleIO_index.tcIO[i].slaveID == slaveId && thermocoupleIO_index.tcIO[i].configInitialised) {
-            boardIndex = i;
-            break;
-        }
+// Find the board a unit ID is routed to (see build_tcp_unit_routes()), returns -1 if there is none
+// or the board hasn't been configured yet
+int ModbusTCPServer::findBoard(uint8_t unitId, tcpUnitRoute_t& route) {
+    if (!tcp_unit_route(unitId, &route) || !thermocoupleIO_index.tcIO[route.board].configInitialised) {
+        return -1;
     }
+    return route.board;
+}
+
+bool ModbusTCPServer::handleReadRequest(uint8_t unitId, uint8_t functionCode, uint16_t startAddress, 
+                                       uint16_t quantity, uint8_t* response, uint16_t& responseLength) {
+    // Find the board the unit ID is routed to
+    tcpUnitRoute_t route;
+    int boardIndex = findBoard(unitId, route);
     
     if (boardIndex == -1) {
         // Slave not found
         return false;
     }
     
-    thermocoupleIO_t* board = &thermocoupleIO_index.tcIO[boardIndex];
-    
-    // Build response based on function code
+    // Responses are copied from the board's published wire order image (see thermocouple_publish()),
+    // which is consistent with a single poll so multi-register values are never torn
     response[0] = functionCode;
     
     switch (functionCode) {
         case 0x01: // Read Coils
-            if (startAddress + quantity > 32) return false;
+        case 0x02: { // Read Discrete Inputs
+            if (quantity == 0 || startAddress + quantity > 32) return false;
+            uint32_t bits;
+            size_t offset = functionCode == 0x01 ? offsetof(thermocoupleImage_t, coils) : offsetof(thermocoupleImage_t, discreteInputs);
+            if (!thermocouple_read_image(boardIndex, offset, sizeof(bits), &bits)) return false;
+            bits >>= startAddress;
+            if (quantity < 32) bits &= (1UL << quantity) - 1;
             response[1] = (quantity + 7) / 8; // Byte count
             responseLength = 2 + response[1];
-            
-            // Pack coil data into bytes
-            for (uint16_t i = 0; i < quantity; i++) {
-                uint16_t byteIndex = 2 + (i / 8);
-                uint16_t bitIndex = i % 8;
-                if (byteIndex >= responseLength) response[byteIndex] = 0;
-                
-                bool coilValue = false;
-                if (startAddress + i < 8) {
-                    coilValue = board->reg.alertEnable[startAddress + i];
-                } else if (startAddress + i < 16) {
-                    coilValue = board->reg.outputEnable[startAddress + i - 8];
-                } else if (startAddress + i < 24) {
-                    coilValue = board->reg.alertLatch[startAddress + i - 16];
-                } else if (startAddress + i < 32) {
-                    coilValue = board->reg.alertEdge[startAddress + i - 24];
-                }
-                
-                if (coilValue) {
-                    response[byteIndex] |= (1 << bitIndex);
-                }
-            }
-            break;
-            
-        case 0x02: // Read Discrete Inputs
-            if (startAddress + quantity > 32) return false;
-            response[1] = (quantity + 7) / 8; // Byte count
-            responseLength = 2 + response[1];
-            
-            // Pack discrete input data into bytes
-            for (uint16_t i = 0; i < quantity; i++) {
-                uint16_t byteIndex = 2 + (i / 8);
-                uint16_t bitIndex = i % 8;
-                if (byteIndex >= responseLength) response[byteIndex] = 0;
-                
-                bool inputValue = false;
-                if (startAddress + i < 8) {
-                    inputValue = board->reg.outputState[startAddress + i];
-                } else if (startAddress + i < 16) {
-                    inputValue = board->reg.alarmState[startAddress + i - 8];
-                } else if (startAddress + i < 24) {
-                    inputValue = board->reg.openCircuit[startAddress + i - 16];
-                } else if (startAddress + i < 32) {
-                    inputValue = board->reg.shortCircuit[startAddress + i - 24];
-                }
-                
-                if (inputValue) {
-                    response[byteIndex] |= (1 << bitIndex);
-                }
+            for (uint8_t i = 0; i < response[1]; i++) {
+                response[2 + i] = (bits >> (i * 8)) & 0xFF;
             }
             break;
+        }
             
         case 0x03: // Read Holding Registers
-            if (startAddress + quantity > 42) return false;
+            if (quantity == 0 || startAddress + quantity > TCIO_HOLDING_REG_COUNT) return false;
+            if (!thermocouple_read_image(boardIndex, offsetof(thermocoupleImage_t, holdingRegisters) + startAddress * 2, quantity * 2, &response[2])) return false;
             response[1] = quantity * 2; // Byte count
             responseLength = 2 + response[1];
-            
-            for (uint16_t i = 0; i < quantity; i++) {
-                uint16_t regAddress = startAddress + i;
-                uint16_t value = 0;
-                
-                if (regAddress == 0) {
-                    value = board->reg.status;
-                } else if (regAddress == 1) {
-                    value = board->reg.boardType;
-                } else if (regAddress >= 2 && regAddress <= 8) {
-                    // Board name (7 registers)
-                    uint16_t nameIndex = (regAddress - 2) * 2;
-                    if (nameIndex < 14) {
-                        value = (board->reg.boardName[nameIndex] << 8) | board->reg.boardName[nameIndex + 1];
-                    }
-                } else if (regAddress == 9) {
-                    value = board->reg.slaveID;
-                } else if (regAddress >= 10 && regAddress <= 17) {
-                    // Thermocouple types
-                    value = board->reg.type[regAddress - 10];
-                } else if (regAddress >= 18 && regAddress <= 33) {
-                    // Alert setpoints (float values, 2 registers each)
-                    uint16_t channelIndex = (regAddress - 18) / 2;
-                    uint16_t registerPart = (regAddress - 18) % 2;
-                    if (channelIndex < 8) {
-                        uint32_t floatBits = *(uint32_t*)&board->reg.alertSP[channelIndex];
-                        value = (registerPart == 0) ? (floatBits >> 16) : (floatBits & 0xFFFF);
-                    }
-                } else if (regAddress >= 34 && regAddress <= 41) {
-                    // Alarm hysteresis
-                    value = board->reg.alarmHyst[regAddress - 34];
-                }
-                
-                // Pack as big-endian
-                response[2 + i * 2] = (value >> 8) & 0xFF;
-                response[2 + i * 2 + 1] = value & 0xFF;
-            }
             break;
             
         case 0x04: // Read Input Registers
-            if (startAddress + quantity > 48) return false;
+            if (quantity == 0 || startAddress + quantity > TCIO_INPUT_REG_COUNT) return false;
+            if (!thermocouple_read_image(boardIndex, offsetof(thermocoupleImage_t, inputRegisters) + startAddress * 2, quantity * 2, &response[2])) return false;
             response[1] = quantity * 2; // Byte count
             responseLength = 2 + response[1];
-            
-            for (uint16_t i = 0; i < quantity; i++) {
-                uint16_t regAddress = startAddress + i;
-                uint16_t value = 0;
-                
-                if (regAddress >= 0 && regAddress <= 15) {
-                    // Temperature values (float, 2 registers each)
-                    uint16_t channelIndex = regAddress / 2;
-                    uint16_t registerPart = regAddress % 2;
-                    if (channelIndex < 8) {
-                        uint32_t floatBits = *(uint32_t*)&board->reg.temperature[channelIndex];
-                        value = (registerPart == 0) ? (floatBits >> 16) : (floatBits & 0xFFFF);
-                    }
-                } else if (regAddress >= 16 && regAddress <= 31) {
-                    // Cold junction values
-                    uint16_t channelIndex = (regAddress - 16) / 2;
-                    uint16_t registerPart = (regAddress - 16) % 2;
-                    if (channelIndex < 8) {
-                        uint32_t floatBits = *(uint32_t*)&board->reg.coldJunction[channelIndex];
-                        value = (registerPart == 0) ? (floatBits >> 16) : (floatBits & 0xFFFF);
-                    }
-                } else if (regAddress >= 32 && regAddress <= 47) {
-                    // Delta junction values
-                    uint16_t channelIndex = (regAddress - 32) / 2;
-                    uint16_t registerPart = (regAddress - 32) % 2;
-                    if (channelIndex < 8) {
-                        uint32_t floatBits = *(uint32_t*)&board->reg.deltaJunction[channelIndex];
-                        value = (registerPart == 0) ? (floatBits >> 16) : (floatBits & 0xFFFF);
-                    }
-                }
-                
-                // Pack as big-endian
-                response[2 + i * 2] = (value >> 8) & 0xFF;
-                response[2 + i * 2 + 1] = value & 0xFF;
-            }
             break;
             
         default:
@@ -399,26 +442,401 @@ bool ModbusTCPServer::handleReadRequest(uint8_t slaveId, uint8_t functionCode, u
     return true;
 }
 
-uint16_t ModbusTCPServer::calculateCRC16(uint8_t* data, uint16_t length) {
-    uint16_t crc = 0xFFFF;
-    
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
+// Holding registers are served in Modbus order (floats high word first, name characters high byte
+// first) while the boards store them in memory order, so writes are translated register by register.
+static uint16_t boardHoldingAddress(uint16_t address) {
+    if (address >= TCIO_HOLDING_REG_ALERT_SP && address < TCIO_HOLDING_REG_ALARM_HYST) return address ^ 1;
+    return address;
+}
+
+static uint16_t boardHoldingValue(uint16_t address, uint16_t value) {
+    if (address >= EXP_HOLDING_REG_BOARD_NAME && address < EXP_HOLDING_REG_SLAVE_ID) return (value << 8) | (value >> 8);
+    return value;
+}
+
+// Check a write against the thermocouple board register map, queue it on the board's bus and prepare
+// the response. Returns 0 if queued, otherwise the exception code to answer with.
+uint8_t ModbusTCPServer::queueWriteRequest(ModbusClientConnection& client, const ModbusMBAPHeader& header,
+                                           const uint8_t* pdu, uint16_t pduLength) {
+    tcpUnitRoute_t route;
+    int boardIndex = findBoard(header.unitId, route);
+    if (boardIndex == -1) return MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE;
+    if (pduLength < 5) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+
+    uint8_t functionCode = pdu[0];
+    uint16_t address = (pdu[1] << 8) | pdu[2];
+    uint16_t value = (pdu[3] << 8) | pdu[4]; // Quantity for FC15/16
+    uint16_t quantity = 1;
+    bool coils[TCIO_COIL_COUNT];
+    uint16_t registers[TCIO_HOLDING_REG_COUNT];
+
+    ModbusRTUMasterTransaction request;
+    request.id = route.slaveID;
+
+    switch (functionCode) {
+        case MODBUS_FC_WRITE_SINGLE_COIL:
+            if (pduLength != 5 || (value != 0x0000 && value != 0xFF00)) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            if (address >= TCIO_COIL_COUNT) return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+            request.functionCode = 5;
+            request.address = address;
+            request.value = value == 0xFF00;
+            break;
+
+        case MODBUS_FC_WRITE_MULTIPLE_COILS:
+            quantity = value;
+            if (pduLength < 6 || quantity == 0 || quantity > 1968 || pdu[5] != (quantity + 7) / 8 || pduLength != 6 + pdu[5]) {
+                return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            }
+            if (address + quantity > TCIO_COIL_COUNT) return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+            for (uint16_t i = 0; i < quantity; i++) {
+                coils[i] = (pdu[6 + i / 8] >> (i % 8)) & 0x01;
+            }
+            request.functionCode = 15;
+            request.address = address;
+            request.quantity = quantity;
+            request.coils = coils;
+            break;
+
+        case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        case MODBUS_FC_WRITE_MULTIPLE_REGISTERS: {
+            uint16_t values[TCIO_HOLDING_REG_COUNT];
+            if (functionCode == MODBUS_FC_WRITE_SINGLE_REGISTER) {
+                if (pduLength != 5) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+                values[0] = value;
+            } else {
+                quantity = value;
+                if (pduLength < 6 || quantity == 0 || quantity > 123 || pdu[5] != quantity * 2 || pduLength != 6 + pdu[5]) {
+                    return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+                }
+            }
+            // Status and board type are read only
+            if (address < EXP_HOLDING_REG_BOARD_NAME || address + quantity > TCIO_HOLDING_REG_COUNT) {
+                return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+            }
+            if (functionCode == MODBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+                for (uint16_t i = 0; i < quantity; i++) {
+                    values[i] = (pdu[6 + i * 2] << 8) | pdu[7 + i * 2];
+                }
+            }
+
+            // Start from the board's current config so a write covering half a float keeps the other half
+            thermocoupleSnapshot_t snapshot;
+            thermocouple_read_snapshot(boardIndex, &snapshot);
+            memcpy(&registers[EXP_HOLDING_REG_BOARD_NAME], &snapshot.reg.boardName, (TCIO_HOLDING_REG_COUNT - EXP_HOLDING_REG_BOARD_NAME) * sizeof(uint16_t));
+
+            uint16_t first = TCIO_HOLDING_REG_COUNT;
+            uint16_t last = 0;
+            for (uint16_t i = 0; i < quantity; i++) {
+                uint16_t reg = address + i;
+                // The slave ID is assigned by the controller, it may only be written with its current value
+                if (reg == EXP_HOLDING_REG_SLAVE_ID && values[i] != snapshot.reg.slaveID) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+                if (reg >= TCIO_HOLDING_REG_TYPE && reg < TCIO_HOLDING_REG_ALERT_SP && values[i] > TCIO_TC_TYPE_MAX) {
+                    return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+                }
+                uint16_t boardReg = boardHoldingAddress(reg);
+                registers[boardReg] = boardHoldingValue(reg, values[i]);
+                first = min(first, boardReg);
+                last = max(last, boardReg);
+            }
+            if (first == last) {
+                request.functionCode = 6;
+                request.address = first;
+                request.value = registers[first];
             } else {
-                crc >>= 1;
+                request.functionCode = 16;
+                request.address = first;
+                request.quantity = last - first + 1;
+                request.registers = &registers[first];
             }
+            break;
         }
+
+        default:
+            return MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+    }
+
+    // FC05/06 echo the request, FC15/16 echo the address and quantity
+    uint8_t* response = client.pendingResponse;
+    response[0] = (header.transactionId >> 8) & 0xFF;
+    response[1] = header.transactionId & 0xFF;
+    response[2] = 0;
+    response[3] = 0;
+    response[4] = 0;
+    response[5] = 6; // Unit ID + 5 byte PDU
+    response[6] = header.unitId;
+    memcpy(&response[7], pdu, 5);
+
+    uint8_t port = route.port;
+    client.pendingPassThrough = false;
+    if (_config.ackBeforeApply) {
+        if (!bus_command_submit(port, BUS_PRIORITY_OPERATOR, &request, nullptr)) return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+        sendModbusResponse(client, response, MODBUS_TCP_WRITE_RESPONSE_SIZE);
+        return 0;
+    }
+    if (!bus_command_submit(port, BUS_PRIORITY_OPERATOR, &request, &client.pendingRequest)) return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+    return 0;
+}
+
+// Answer a client's queued request once the board has answered it (or failed to)
+void ModbusTCPServer::completePendingRequest(ModbusClientConnection& client) {
+    bool coils[BUS_COMMAND_MAX_COILS];
+    uint16_t registers[BUS_COMMAND_MAX_REGISTERS];
+    ModbusRTUMasterTransaction result;
+    result.coils = coils;
+    result.registers = registers;
+    uint8_t port = client.pendingRequest.port;
+    if (!bus_command_finish(&client.pendingRequest, &result)) return;
+
+    uint8_t* response = client.pendingResponse;
+    uint16_t transactionId = (response[0] << 8) | response[1];
+    uint8_t functionCode = response[7];
+    if (result.status == MODBUS_RTU_MASTER_SUCCESS && client.pendingPassThrough && functionCode <= MODBUS_FC_READ_INPUT_REGISTERS) {
+        // Pass-through read, rebuild the response PDU from the values the master decoded
+        uint16_t address = (response[8] << 8) | response[9];
+        uint16_t quantity = (response[10] << 8) | response[11];
+        uint8_t pdu[MODBUS_TCP_MAX_PDU_SIZE];
+        pdu[0] = functionCode;
+        if (functionCode == MODBUS_FC_READ_COILS || functionCode == MODBUS_FC_READ_DISCRETE_INPUTS) {
+            pdu[1] = (quantity + 7) / 8;
+            memset(&pdu[2], 0, pdu[1]);
+            for (uint16_t i = 0; i < quantity; i++) {
+                if (coils[i]) pdu[2 + i / 8] |= 1 << (i % 8);
+            }
+        } else {
+            pdu[1] = quantity * 2;
+            for (uint16_t i = 0; i < quantity; i++) {
+                pdu[2 + i * 2] = registers[i] >> 8;
+                pdu[3 + i * 2] = registers[i] & 0xFF;
+            }
+        }
+        cacheResponse(port, client.pendingSlaveID, pdu, 2 + pdu[1], address, quantity);
+        sendModbusPdu(client, transactionId, response[6], pdu, 2 + pdu[1]);
+    } else if (result.status == MODBUS_RTU_MASTER_SUCCESS) {
+        // Reads cached before a pass-through write may no longer match the board
+        if (client.pendingPassThrough) invalidateCache(port, client.pendingSlaveID);
+        sendModbusResponse(client, response, MODBUS_TCP_WRITE_RESPONSE_SIZE);
+    } else if (result.status == MODBUS_RTU_MASTER_EXCEPTION) {
+        sendModbusException(client, transactionId, response[6], response[7], result.exceptionCode);
+    } else {
+        sendModbusException(client, transactionId, response[6], response[7], MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED);
+    }
+}
+
+// Pass-through ------------------------------------------------------------->
+// With pass-through enabled, requests the thermocouple register map doesn't cover (other addresses,
+// boards that haven't been read yet) are sent to the board on its bus queue with the address and
+// values unchanged, below operator and config commands. The client is answered when the board
+// replies, core 0 never waits on the bus. Read responses are kept for the TTL of the first cache
+// range they fall in, so SCADA clients polling the same registers don't each cost a bus transaction.
+
+// Registers or coils of a function code the thermocouple register map covers
+static uint16_t mappedCount(uint8_t functionCode) {
+    switch (functionCode) {
+        case MODBUS_FC_READ_COILS:
+        case MODBUS_FC_READ_DISCRETE_INPUTS:
+            return 32;
+        case MODBUS_FC_READ_HOLDING_REGISTERS:
+        case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+            return TCIO_HOLDING_REG_COUNT;
+        case MODBUS_FC_READ_INPUT_REGISTERS:
+            return TCIO_INPUT_REG_COUNT;
+        case MODBUS_FC_WRITE_SINGLE_COIL:
+        case MODBUS_FC_WRITE_MULTIPLE_COILS:
+            return TCIO_COIL_COUNT;
+        default:
+            return 0;
+    }
+}
+
+// True if the request is answered from (or written through) the thermocouple register map
+bool ModbusTCPServer::isMappedRequest(uint8_t unitId, const uint8_t* pdu, uint16_t pduLength) {
+    tcpUnitRoute_t route;
+    if (findBoard(unitId, route) == -1) return false;
+    if (pduLength < 5) return true;  // Malformed, answered with the usual exception
+    uint8_t functionCode = pdu[0];
+    uint16_t address = (pdu[1] << 8) | pdu[2];
+    uint16_t quantity = (functionCode == MODBUS_FC_WRITE_SINGLE_COIL || functionCode == MODBUS_FC_WRITE_SINGLE_REGISTER) ? 1 : (pdu[3] << 8) | pdu[4];
+    return (uint32_t)address + quantity <= mappedCount(functionCode);
+}
+
+// Queue a request on the bus of the board the unit ID is routed to, or answer a read from the cache.
+// Returns 0 if queued or answered, otherwise the exception code to answer with.
+uint8_t ModbusTCPServer::passThroughRequest(ModbusClientConnection& client, const ModbusMBAPHeader& header,
+                                            const uint8_t* pdu, uint16_t pduLength) {
+    tcpUnitRoute_t route;
+    if (!tcp_unit_route(header.unitId, &route)) return MODBUS_EXCEPTION_GATEWAY_PATH_UNAVAILABLE;
+    if (pduLength < 5) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+
+    uint8_t functionCode = pdu[0];
+    uint16_t address = (pdu[1] << 8) | pdu[2];
+    uint16_t value = (pdu[3] << 8) | pdu[4]; // Quantity for everything but FC05/06
+    bool coils[BUS_COMMAND_MAX_COILS];
+    uint16_t registers[BUS_COMMAND_MAX_REGISTERS];
+
+    ModbusRTUMasterTransaction request;
+    request.id = route.slaveID;
+    request.functionCode = functionCode;
+    request.address = address;
+
+    // Quantities are limited to what a bus command can carry
+    switch (functionCode) {
+        case MODBUS_FC_READ_COILS:
+        case MODBUS_FC_READ_DISCRETE_INPUTS:
+            if (pduLength != 5 || value == 0 || value > BUS_COMMAND_MAX_COILS) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            request.quantity = value;
+            break;
+
+        case MODBUS_FC_READ_HOLDING_REGISTERS:
+        case MODBUS_FC_READ_INPUT_REGISTERS:
+            if (pduLength != 5 || value == 0 || value > BUS_COMMAND_MAX_REGISTERS) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            request.quantity = value;
+            break;
+
+        case MODBUS_FC_WRITE_SINGLE_COIL:
+            if (pduLength != 5 || (value != 0x0000 && value != 0xFF00)) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            request.value = value == 0xFF00;
+            break;
+
+        case MODBUS_FC_WRITE_SINGLE_REGISTER:
+            if (pduLength != 5) return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            request.value = value;
+            break;
+
+        case MODBUS_FC_WRITE_MULTIPLE_COILS:
+            if (pduLength < 6 || value == 0 || value > BUS_COMMAND_MAX_COILS || pdu[5] != (value + 7) / 8 || pduLength != 6 + pdu[5]) {
+                return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            }
+            for (uint16_t i = 0; i < value; i++) {
+                coils[i] = (pdu[6 + i / 8] >> (i % 8)) & 0x01;
+            }
+            request.quantity = value;
+            request.coils = coils;
+            break;
+
+        case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+            if (pduLength < 6 || value == 0 || value > BUS_COMMAND_MAX_REGISTERS || pdu[5] != value * 2 || pduLength != 6 + pdu[5]) {
+                return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            }
+            for (uint16_t i = 0; i < value; i++) {
+                registers[i] = (pdu[6 + i * 2] << 8) | pdu[7 + i * 2];
+            }
+            request.quantity = value;
+            request.registers = registers;
+            break;
+
+        default:
+            return MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+    }
+
+    bool read = functionCode <= MODBUS_FC_READ_INPUT_REGISTERS;
+    if (read) {
+        ModbusCacheEntry* cached = findCachedResponse(route.port, route.slaveID, functionCode, address, value);
+        if (cached) {
+            _cacheHits++;
+            sendModbusPdu(client, header.transactionId, header.unitId, cached->pdu, cached->length);
+            return 0;
+        }
+    } else {
+        invalidateCache(route.port, route.slaveID);
+    }
+
+    // Leave room in the bus queue for operator and config commands
+    uint8_t queued = 0;
+    for (int i = 0; i < _poolSize; i++) {
+        if (_clients[i].pendingPassThrough && _clients[i].pendingRequest.slot >= 0 && _clients[i].pendingRequest.port == route.port) queued++;
+    }
+    if (queued >= MODBUS_TCP_PASSTHROUGH_PER_BUS) return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+    if (!bus_command_submit(route.port, BUS_PRIORITY_GATEWAY, &request, &client.pendingRequest)) return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+
+    // Writes are answered with an echo of the request, reads are rebuilt from the master's result
+    uint8_t* response = client.pendingResponse;
+    response[0] = (header.transactionId >> 8) & 0xFF;
+    response[1] = header.transactionId & 0xFF;
+    response[2] = 0;
+    response[3] = 0;
+    response[4] = 0;
+    response[5] = 6; // Unit ID + 5 byte PDU
+    response[6] = header.unitId;
+    memcpy(&response[7], pdu, 5);
+    client.pendingPassThrough = true;
+    client.pendingSlaveID = route.slaveID;
+    _passThroughCount++;
+    return 0;
+}
+
+// TTL of the first cache range a read falls in, 0 (not cached) if none
+uint16_t ModbusTCPServer::cacheTtl(uint8_t functionCode, uint16_t address, uint16_t quantity) {
+    uint32_t last = (uint32_t)address + quantity - 1;
+    for (uint8_t i = 0; i < _config.cacheRangeCount; i++) {
+        const ModbusCacheRange& range = _config.cacheRanges[i];
+        if (range.functionCode != 0 && range.functionCode != functionCode) continue;
+        if (address >= range.start && last <= range.end) return range.ttlMs;
+    }
+    return 0;
+}
+
+ModbusCacheEntry* ModbusTCPServer::findCachedResponse(uint8_t port, uint8_t slaveID, uint8_t functionCode, uint16_t address, uint16_t quantity) {
+    uint32_t now = millis();
+    for (int i = 0; i < MODBUS_TCP_CACHE_ENTRIES; i++) {
+        ModbusCacheEntry& entry = _cache[i];
+        if (!entry.valid || entry.port != port || entry.slaveID != slaveID || entry.functionCode != functionCode ||
+            entry.address != address || entry.quantity != quantity) continue;
+        if (now - entry.storedAt >= entry.ttlMs) {
+            entry.valid = false;
+            return nullptr;
+        }
+        return &entry;
+    }
+    return nullptr;
+}
+
+// Keep a read response for its range's TTL, replacing the same read or else the oldest entry
+void ModbusTCPServer::cacheResponse(uint8_t port, uint8_t slaveID, const uint8_t* pdu, uint16_t length, uint16_t address, uint16_t quantity) {
+    uint8_t functionCode = pdu[0];
+    uint16_t ttl = cacheTtl(functionCode, address, quantity);
+    if (ttl == 0 || length > MODBUS_TCP_MAX_PDU_SIZE) return;
+
+    uint32_t now = millis();
+    int slot = -1;
+    for (int i = 0; i < MODBUS_TCP_CACHE_ENTRIES && slot < 0; i++) {
+        const ModbusCacheEntry& entry = _cache[i];
+        if (entry.valid && entry.port == port && entry.slaveID == slaveID && entry.functionCode == functionCode &&
+            entry.address == address && entry.quantity == quantity) slot = i;
+    }
+    if (slot < 0) {
+        slot = 0;
+        for (int i = 0; i < MODBUS_TCP_CACHE_ENTRIES; i++) {
+            if (!_cache[i].valid) {
+                slot = i;
+                break;
+            }
+            if (now - _cache[i].storedAt > now - _cache[slot].storedAt) slot = i;
+        }
+    }
+
+    ModbusCacheEntry& entry = _cache[slot];
+    entry.valid = true;
+    entry.port = port;
+    entry.slaveID = slaveID;
+    entry.functionCode = functionCode;
+    entry.address = address;
+    entry.quantity = quantity;
+    entry.ttlMs = ttl;
+    entry.storedAt = now;
+    entry.length = length;
+    memcpy(entry.pdu, pdu, length);
+}
+
+void ModbusTCPServer::invalidateCache(uint8_t port, uint8_t slaveID) {
+    for (int i = 0; i < MODBUS_TCP_CACHE_ENTRIES; i++) {
+        if (_cache[i].port == port && _cache[i].slaveID == slaveID) _cache[i].valid = false;
     }
-    
-    return crc;
 }
 
 int ModbusTCPServer::getConnectedClientCount() {
     int count = 0;
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+    for (int i = 0; i < _poolSize; i++) {
         if (_clients[i].active) {
             count++;
         }
@@ -427,13 +845,15 @@ int ModbusTCPServer::getConnectedClientCount() {
 }
 
 String ModbusTCPServer::getClientInfo(int index) {
-    if (index >= 0 && index < MAX_MODBUS_CLIENTS && _clients[index].active) {
+    if (index >= 0 && index < _poolSize && _clients[index].active) {
         uint32_t connectionDuration = millis() - _clients[index].connectionTime;
         uint32_t lastActivityTime = millis() - _clients[index].lastActivity;
         
-        String info = "IP: " + _clients[index].clientIP;
+        String info = "IP: " + String(_clients[index].clientIP);
         info += ", Connected: " + String(connectionDuration / 1000) + "s";
         info += ", Last Activity: " + String(lastActivityTime / 1000) + "s ago";
+        info += ", Requests: " + String(_clients[index].requests);
+        if (_config.rateLimit) info += ", Throttled: " + String(_clients[index].throttled);
         return info;
     }
     return "";
@@ -444,11 +864,9 @@ uint16_t ModbusTCPServer::swapBytes(uint16_t value) {
 }
 
 void ModbusTCPServer::disconnectAllClients() {
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+    for (int i = 0; i < _poolSize; i++) {
         if (_clients[i].active) {
-            _clients[i].client.stop();
-            _clients[i].active = false;
-            _clients[i].clientIP = "";
+            releaseClient(i);
         }
     }
 }
@@ -494,6 +912,111 @@ uint16_t ModbusTCPServer::getPort() const {
     return _config.port;
 }
 
+void ModbusTCPServer::setAckBeforeApply(bool ackBeforeApply) {
+    _config.ackBeforeApply = ackBeforeApply;
+}
+
+bool ModbusTCPServer::isAckBeforeApply() const {
+    return _config.ackBeforeApply;
+}
+
+void ModbusTCPServer::setMaxClients(uint8_t maxClients) {
+    maxClients = constrain(maxClients, 1, MODBUS_TCP_MAX_CLIENTS);
+    if (maxClients == _config.maxClients) return;
+    log(LOG_INFO, true, "Modbus TCP connection pool changing from %d to %d clients\n", _config.maxClients, maxClients);
+    _config.maxClients = maxClients;
+    if (_running) {
+        // The pool is allocated by begin(), so connected clients are dropped
+        stop();
+        begin(_config.port);
+    }
+}
+
+uint8_t ModbusTCPServer::getMaxClients() const {
+    return _config.maxClients;
+}
+
+void ModbusTCPServer::setRateLimit(uint16_t rateLimit) {
+    _config.rateLimit = rateLimit;
+    // Start every client with a full bucket at the new rate
+    for (int i = 0; i < _poolSize; i++) {
+        _clients[i].tokens = (uint32_t)rateLimit * 1000;
+        _clients[i].lastRefill = micros();
+    }
+}
+
+uint16_t ModbusTCPServer::getRateLimit() const {
+    return _config.rateLimit;
+}
+
+void ModbusTCPServer::setPassThrough(bool passThrough) {
+    _config.passThrough = passThrough;
+    memset(_cache, 0, sizeof(_cache));
+}
+
+bool ModbusTCPServer::isPassThrough() const {
+    return _config.passThrough;
+}
+
+void ModbusTCPServer::setCacheRanges(const ModbusCacheRange* ranges, uint8_t count) {
+    _config.cacheRangeCount = min(count, (uint8_t)MODBUS_TCP_CACHE_RANGES);
+    memcpy(_config.cacheRanges, ranges, _config.cacheRangeCount * sizeof(ModbusCacheRange));
+    memset(_cache, 0, sizeof(_cache));
+}
+
+uint8_t ModbusTCPServer::getCacheRanges(const ModbusCacheRange** ranges) const {
+    *ranges = _config.cacheRanges;
+    return _config.cacheRangeCount;
+}
+
+uint32_t ModbusTCPServer::getPassThroughCount() const {
+    return _passThroughCount;
+}
+
+uint32_t ModbusTCPServer::getCacheHitCount() const {
+    return _cacheHits;
+}
+
+// Pass-through cache ranges ------------------------------------------------->
+// Stored in the network config as [{"functionCode":3,"start":100,"end":199,"ttl":1000}, ...]
+
+uint8_t defaultModbusCacheRanges(ModbusCacheRange* ranges) {
+    ranges[0].functionCode = 0;
+    ranges[0].start = 0;
+    ranges[0].end = 0xFFFF;
+    ranges[0].ttlMs = MODBUS_TCP_DEFAULT_CACHE_TTL;
+    return 1;
+}
+
+// Returns the number of ranges, or -1 if a range is invalid or there are too many
+int parseModbusCacheRanges(JsonArray array, ModbusCacheRange* ranges) {
+    if (array.size() > MODBUS_TCP_CACHE_RANGES) return -1;
+    int count = 0;
+    for (JsonObject item : array) {
+        uint8_t functionCode = item["functionCode"] | 0;
+        uint32_t start = item["start"] | 0;
+        uint32_t end = item["end"] | 0xFFFF;
+        uint32_t ttl = item["ttl"] | 0;
+        if (functionCode > MODBUS_FC_READ_INPUT_REGISTERS || start > end || end > 0xFFFF || ttl > 60000) return -1;
+        ranges[count].functionCode = functionCode;
+        ranges[count].start = start;
+        ranges[count].end = end;
+        ranges[count].ttlMs = ttl;
+        count++;
+    }
+    return count;
+}
+
+void writeModbusCacheRanges(JsonArray array, const ModbusCacheRange* ranges, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject item = array.createNestedObject();
+        item["functionCode"] = ranges[i].functionCode;
+        item["start"] = ranges[i].start;
+        item["end"] = ranges[i].end;
+        item["ttl"] = ranges[i].ttlMs;
+    }
+}
+
 // Global functions implementation
 void init_modbus_tcp() {
     log(LOG_INFO, true, "Initializing Modbus TCP...\n");
@@ -501,6 +1024,15 @@ void init_modbus_tcp() {
     // Use network configuration instead of separate Modbus TCP config
     modbusTCPConfig.port = networkConfig.modbusTcpPort;
     modbusTCPConfig.enabled = true; // Always enabled, controlled by network config
+    modbusTCPConfig.ackBeforeApply = networkConfig.modbusTcpAckBeforeApply;
+    modbusTCPConfig.maxClients = networkConfig.modbusTcpMaxClients;
+    modbusTCPConfig.rateLimit = networkConfig.modbusTcpRateLimit;
+    modbusServer.setAckBeforeApply(modbusTCPConfig.ackBeforeApply);
+    modbusServer.setMaxClients(modbusTCPConfig.maxClients);
+    modbusServer.setRateLimit(modbusTCPConfig.rateLimit);
+    modbusTCPConfig.passThrough = networkConfig.modbusTcpPassThrough;
+    modbusServer.setPassThrough(modbusTCPConfig.passThrough);
+    modbusServer.setCacheRanges(networkConfig.modbusTcpCacheRanges, networkConfig.modbusTcpCacheRangeCount);
     
     log(LOG_INFO, true, "Using network config: port=%d, enabled=%s\n", 
         modbusTCPConfig.port, modbusTCPConfig.enabled ? "true" : "false");
@@ -604,20 +1136,40 @@ void saveModbusTCPConfig() {
 void setupModbusTCPAPI() {
     // Get Modbus TCP status
     server.on("/api/modbus-tcp/status", HTTP_GET, []() {
-        StaticJsonDocument<512> doc;
+        DynamicJsonDocument doc(1536 + MODBUS_TCP_MAX_CLIENTS * 128); // Client info strings are copied into the document
         
         doc["enabled"] = modbusTCPConfig.enabled;
         doc["port"] = networkConfig.modbusTcpPort; // Use network config port
         doc["running"] = modbusServer.isEnabled();
         doc["connectedClients"] = modbusServer.getConnectedClientCount();
+        doc["ackBeforeApply"] = modbusServer.isAckBeforeApply();
+        doc["maxClients"] = modbusServer.getMaxClients();
+        doc["rateLimit"] = modbusServer.getRateLimit();
+        doc["passThrough"] = modbusServer.isPassThrough();
+        doc["passThroughRequests"] = modbusServer.getPassThroughCount();
+        doc["cacheHits"] = modbusServer.getCacheHitCount();
+        const ModbusCacheRange* cacheRanges;
+        uint8_t cacheRangeCount = modbusServer.getCacheRanges(&cacheRanges);
+        writeModbusCacheRanges(doc.createNestedArray("cacheTtl"), cacheRanges, cacheRangeCount);
         
         JsonArray clients = doc.createNestedArray("clients");
-        for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+        for (int i = 0; i < modbusServer.getMaxClients(); i++) {
             String clientInfo = modbusServer.getClientInfo(i);
             if (clientInfo.length() > 0) {
                 clients.add(clientInfo);
             }
         }
+
+        // Unit ID routes to the boards
+        JsonArray units = doc.createNestedArray("units");
+        for (uint16_t unitId = 1; unitId <= TCP_UNIT_ID_MAX; unitId++) {
+            tcpUnitRoute_t route;
+            if (!tcp_unit_route(unitId, &route)) continue;
+            JsonObject unit = units.createNestedObject();
+            unit["unitId"] = unitId;
+            unit["port"] = route.port + 1;
+            unit["slaveId"] = route.slaveID;
+        }
         
         String response;
         serializeJson(doc, response);
@@ -631,7 +1183,7 @@ void setupModbusTCPAPI() {
             return;
         }
         
-        StaticJsonDocument<256> doc;
+        StaticJsonDocument<512> doc;
         DeserializationError error = deserializeJson(doc, server.arg("plain"));
         
         if (error) {
@@ -663,6 +1215,59 @@ void setupModbusTCPAPI() {
             modbusTCPConfig.enabled = newEnabled;
             modbusServer.setEnabled(modbusTCPConfig.enabled);
         }
+
+        if (doc.containsKey("ackBeforeApply")) {
+            bool ackBeforeApply = doc["ackBeforeApply"];
+            log(LOG_INFO, true, "Modbus TCP config update: write acknowledge %s\n", ackBeforeApply ? "when queued" : "when applied");
+            networkConfig.modbusTcpAckBeforeApply = ackBeforeApply;
+            modbusTCPConfig.ackBeforeApply = ackBeforeApply;
+            modbusServer.setAckBeforeApply(ackBeforeApply);
+            saveNetworkConfig();
+        }
+
+        if (doc.containsKey("maxClients")) {
+            int maxClients = doc["maxClients"];
+            if (maxClients < 1 || maxClients > MODBUS_TCP_MAX_CLIENTS) {
+                server.send(400, "application/json", "{\"error\":\"maxClients must be 1 to " + String(MODBUS_TCP_MAX_CLIENTS) + "\"}");
+                return;
+            }
+            networkConfig.modbusTcpMaxClients = maxClients;
+            modbusTCPConfig.maxClients = maxClients;
+            modbusServer.setMaxClients(maxClients);
+            saveNetworkConfig();
+        }
+
+        if (doc.containsKey("rateLimit")) {
+            uint16_t rateLimit = doc["rateLimit"];
+            log(LOG_INFO, true, "Modbus TCP config update: rate limit %d requests/s per client\n", rateLimit);
+            networkConfig.modbusTcpRateLimit = rateLimit;
+            modbusTCPConfig.rateLimit = rateLimit;
+            modbusServer.setRateLimit(rateLimit);
+            saveNetworkConfig();
+        }
+
+        if (doc.containsKey("cacheTtl")) {
+            ModbusCacheRange ranges[MODBUS_TCP_CACHE_RANGES];
+            int count = parseModbusCacheRanges(doc["cacheTtl"], ranges);
+            if (count < 0) {
+                server.send(400, "application/json", "{\"error\":\"cacheTtl must be up to " + String(MODBUS_TCP_CACHE_RANGES) +
+                            " ranges of functionCode 0-4, start <= end and ttl up to 60000 ms\"}");
+                return;
+            }
+            memcpy(networkConfig.modbusTcpCacheRanges, ranges, sizeof(ranges));
+            networkConfig.modbusTcpCacheRangeCount = count;
+            modbusServer.setCacheRanges(ranges, count);
+            saveNetworkConfig();
+        }
+
+        if (doc.containsKey("passThrough")) {
+            bool passThrough = doc["passThrough"];
+            log(LOG_INFO, true, "Modbus TCP config update: pass-through %s\n", passThrough ? "enabled" : "disabled");
+            networkConfig.modbusTcpPassThrough = passThrough;
+            modbusTCPConfig.passThrough = passThrough;
+            modbusServer.setPassThrough(passThrough);
+            saveNetworkConfig();
+        }
         
         server.send(200, "application/json", "{\"status\":\"success\",\"message\":\"Modbus TCP configuration updated\"}");
     });
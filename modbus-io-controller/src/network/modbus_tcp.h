@@ -3,11 +3,21 @@
 #include "../sys_init.h"
 #include <WiFiServer.h>
 #include <WiFiClient.h>
+#include "../io_core/bus_queue.h"
 
 // Modbus TCP configuration
 #define MODBUS_TCP_DEFAULT_PORT 502
-#define MAX_MODBUS_CLIENTS 4
+#define MODBUS_TCP_MAX_CLIENTS 16           // Largest connection pool that can be configured
+#define MODBUS_TCP_DEFAULT_CLIENTS 4
 #define MODBUS_TCP_TIMEOUT 300000 // 5 minutes (like reference implementation)
+#define MODBUS_TCP_EVICT_IDLE_MS 10000      // When the pool is full, the least recently active client idle this long makes room
+#define MODBUS_TCP_REQUESTS_PER_TURN 8      // Requests answered for one client before the next client is serviced
+#define MODBUS_TCP_MBAP_SIZE 7
+#define MODBUS_TCP_MAX_PDU_SIZE 253
+#define MODBUS_TCP_MAX_ADU_SIZE (MODBUS_TCP_MBAP_SIZE + MODBUS_TCP_MAX_PDU_SIZE)
+#define MODBUS_TCP_RX_BUFFER_SIZE 512   // Power of 2, a full ADU plus the start of the next
+#define MODBUS_TCP_CACHE_ENTRIES 16         // Pass-through read responses kept for their range's TTL
+#define MODBUS_TCP_PASSTHROUGH_PER_BUS 2    // Pass-through requests queued on one bus at a time
 
 // Modbus function codes
 #define MODBUS_FC_READ_COILS 0x01
@@ -24,6 +34,12 @@
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS 0x02
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE 0x03
 #define MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE 0x04
+#define MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY 0x06
+#define MODBUS_EXCEPTION_GATEWAY_PATH_UNAVAILABLE 0x0A
+#define MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED 0x0B
+
+// Write response: MBAP header + function code, address and value/quantity
+#define MODBUS_TCP_WRITE_RESPONSE_SIZE 12
 
 // MBAP Header structure
 struct ModbusMBAPHeader {
@@ -39,13 +55,49 @@ struct ModbusClientConnection {
     uint32_t lastActivity;
     uint32_t connectionTime;
     bool active;
-    String clientIP;
+    char clientIP[16];
+    uint32_t requests;      // Requests answered
+    uint32_t throttled;     // Turns the client was held back by the rate limit
+    // Rate limit token bucket, in thousandths of a request
+    uint32_t tokens;
+    uint32_t lastRefill;    // micros()
+    // RTU request in progress (a write, or a pass-through request), the client's next request is
+    // held until it is answered. pendingResponse holds the MBAP header and the first 5 PDU bytes.
+    busFuture_t pendingRequest;
+    uint8_t pendingResponse[MODBUS_TCP_WRITE_RESPONSE_SIZE];
+    bool pendingPassThrough;
+    uint8_t pendingSlaveID;
+    // Received bytes not parsed yet. Clients may pipeline requests and an ADU can be split
+    // across TCP segments, so bytes are collected here and each complete ADU is taken out.
+    uint8_t rxBuffer[MODBUS_TCP_RX_BUFFER_SIZE];
+    uint16_t rxHead;    // Oldest unparsed byte
+    uint16_t rxCount;
+};
+
+// Pass-through read response, answered from the cache until its TTL has passed
+struct ModbusCacheEntry {
+    bool valid;
+    uint8_t port;
+    uint8_t slaveID;
+    uint8_t functionCode;
+    uint16_t address;
+    uint16_t quantity;
+    uint16_t ttlMs;
+    uint32_t storedAt;      // millis()
+    uint8_t length;         // Response PDU length
+    uint8_t pdu[MODBUS_TCP_MAX_PDU_SIZE];
 };
 
 // Modbus TCP configuration structure
 struct ModbusTCPConfig {
     uint16_t port;
     bool enabled;
+    bool ackBeforeApply;    // Answer writes once queued instead of once the board has applied them
+    uint8_t maxClients;     // Connection pool size, 1 to MODBUS_TCP_MAX_CLIENTS
+    uint16_t rateLimit;     // Requests per second per client (bursts up to one second's worth), 0 for no limit
+    bool passThrough;       // Forward requests outside the thermocouple register map to the board
+    ModbusCacheRange cacheRanges[MODBUS_TCP_CACHE_RANGES];
+    uint8_t cacheRangeCount;
 };
 
 // Modbus TCP server class
@@ -68,30 +120,70 @@ public:
     bool isEnabled() const;
     void setPort(uint16_t port);
     uint16_t getPort() const;
+    void setAckBeforeApply(bool ackBeforeApply);
+    bool isAckBeforeApply() const;
+    void setMaxClients(uint8_t maxClients);
+    uint8_t getMaxClients() const;
+    void setRateLimit(uint16_t rateLimit);
+    uint16_t getRateLimit() const;
+    void setPassThrough(bool passThrough);
+    bool isPassThrough() const;
+    void setCacheRanges(const ModbusCacheRange* ranges, uint8_t count);
+    uint8_t getCacheRanges(const ModbusCacheRange** ranges) const;
+    uint32_t getPassThroughCount() const;
+    uint32_t getCacheHitCount() const;
+
+    // Answer a read (FC01-04) for a board from its published register image, builds the response PDU
+    bool handleReadRequest(uint8_t unitId, uint8_t functionCode, uint16_t startAddress, 
+                          uint16_t quantity, uint8_t* response, uint16_t& responseLength);
+
+    // Take the next complete ADU out of a client's receive buffer
+    static int takeRequest(ModbusClientConnection& client, uint8_t* adu);
     
 private:
     WiFiServer* _server;
-    ModbusClientConnection _clients[MAX_MODBUS_CLIENTS];
+    ModbusClientConnection* _clients;   // Pool of _config.maxClients connections, allocated by begin()
+    uint8_t _poolSize;
+    uint8_t _nextClient;                // First client serviced on the next poll (round robin)
     ModbusTCPConfig _config;
     bool _running;
+    ModbusCacheEntry _cache[MODBUS_TCP_CACHE_ENTRIES];
+    uint32_t _passThroughCount;     // Requests forwarded to a board
+    uint32_t _cacheHits;            // Pass-through reads answered from the cache
     
     // Client management
     void acceptNewClients();
     void processClientRequests();
+    void serviceClient(int slot);
+    bool takeRateToken(ModbusClientConnection& client);
     void cleanupInactiveClients();
     int findFreeClientSlot();
+    int evictIdleClient();
+    void releaseClient(int slot);
     
     // Modbus protocol handling
-    bool processModbusRequest(ModbusClientConnection& client);
+    uint16_t receiveClientData(ModbusClientConnection& client);
+    bool processModbusRequest(ModbusClientConnection& client, const uint8_t* adu, uint16_t aduLength);
     void sendModbusResponse(ModbusClientConnection& client, uint8_t* response, uint16_t length);
+    void sendModbusPdu(ModbusClientConnection& client, uint16_t transactionId, uint8_t unitId, const uint8_t* pdu, uint16_t pduLength);
     void sendModbusException(ModbusClientConnection& client, uint16_t transactionId, uint8_t unitId, uint8_t functionCode, uint8_t exceptionCode);
     
     // RTU gateway functions
-    bool handleReadRequest(uint8_t slaveId, uint8_t functionCode, uint16_t startAddress, 
-                          uint16_t quantity, uint8_t* response, uint16_t& responseLength);
+    int findBoard(uint8_t unitId, tcpUnitRoute_t& route);
+    uint8_t queueWriteRequest(ModbusClientConnection& client, const ModbusMBAPHeader& header,
+                              const uint8_t* pdu, uint16_t pduLength);
+    void completePendingRequest(ModbusClientConnection& client);
+
+    // Pass-through to the boards
+    bool isMappedRequest(uint8_t unitId, const uint8_t* pdu, uint16_t pduLength);
+    uint8_t passThroughRequest(ModbusClientConnection& client, const ModbusMBAPHeader& header,
+                               const uint8_t* pdu, uint16_t pduLength);
+    uint16_t cacheTtl(uint8_t functionCode, uint16_t address, uint16_t quantity);
+    ModbusCacheEntry* findCachedResponse(uint8_t port, uint8_t slaveID, uint8_t functionCode, uint16_t address, uint16_t quantity);
+    void cacheResponse(uint8_t port, uint8_t slaveID, const uint8_t* pdu, uint16_t length, uint16_t address, uint16_t quantity);
+    void invalidateCache(uint8_t port, uint8_t slaveID);
     
     // Utility functions
-    uint16_t calculateCRC16(uint8_t* data, uint16_t length);
     uint16_t swapBytes(uint16_t value);
 };
 
@@ -101,6 +193,9 @@ void manage_modbus_tcp();
 bool loadModbusTCPConfig();
 void saveModbusTCPConfig();
 void setupModbusTCPAPI();
+uint8_t defaultModbusCacheRanges(ModbusCacheRange* ranges);
+int parseModbusCacheRanges(JsonArray array, ModbusCacheRange* ranges);
+void writeModbusCacheRanges(JsonArray array, const ModbusCacheRange* ranges, uint8_t count);
 
 // Global variables
 extern ModbusTCPServer modbusServer;
@@ -1,5 +1,7 @@
 #include "network.h"
 #include "modbus_tcp.h"
+#include "../io_core/board_status.h"
+#include "../utils/jsonStream.h"
 
 // Global variables
 NetworkConfig networkConfig;
@@ -20,6 +22,10 @@ bool setStaticIPcmd = false;
 bool setDHCPcmd = false;
 unsigned long lastNetworkCheckTime = 0;
 
+// Static web assets with a content hash, from WEB_ASSET_MANIFEST
+WebAsset webAssets[MAX_WEB_ASSETS];
+uint8_t webAssetCount = 0;
+
 // Network component initialisation functions ------------------------------>
 void init_network() {
     setupEthernet();
@@ -60,6 +66,12 @@ void setupEthernet()
     strcpy(networkConfig.ntpServer, "pool.ntp.org");
     networkConfig.dstEnabled = false;
     networkConfig.modbusTcpPort = 502;
+    networkConfig.modbusTcpAckBeforeApply = false;
+    networkConfig.modbusTcpMaxClients = MODBUS_TCP_DEFAULT_CLIENTS;
+    networkConfig.modbusTcpRateLimit = 0;
+    networkConfig.modbusTcpPassThrough = false;
+    networkConfig.modbusTcpCacheRangeCount = defaultModbusCacheRanges(networkConfig.modbusTcpCacheRanges);
+    networkConfig.livePushInterval = LIVE_PUSH_INTERVAL_DEFAULT;
     saveNetworkConfig();
   }
 
@@ -134,7 +146,7 @@ bool loadNetworkConfig()
   }
 
   // Allocate a buffer to store contents of the file
-  StaticJsonDocument<512> doc;
+  StaticJsonDocument<1024> doc;
   DeserializationError error = deserializeJson(doc, configFile);
   configFile.close();
 
@@ -174,6 +186,13 @@ bool loadNetworkConfig()
   
   // Parse Modbus TCP port
   networkConfig.modbusTcpPort = doc["modbus_tcp_port"] | 502;
+  networkConfig.modbusTcpAckBeforeApply = doc["modbus_tcp_ack_before_apply"] | false;
+  networkConfig.modbusTcpMaxClients = constrain(doc["modbus_tcp_max_clients"] | MODBUS_TCP_DEFAULT_CLIENTS, 1, MODBUS_TCP_MAX_CLIENTS);
+  networkConfig.modbusTcpRateLimit = doc["modbus_tcp_rate_limit"] | 0;
+  networkConfig.modbusTcpPassThrough = doc["modbus_tcp_pass_through"] | false;
+  int cacheRanges = doc.containsKey("modbus_tcp_cache_ttl") ? parseModbusCacheRanges(doc["modbus_tcp_cache_ttl"], networkConfig.modbusTcpCacheRanges) : -1;
+  networkConfig.modbusTcpCacheRangeCount = cacheRanges >= 0 ? cacheRanges : defaultModbusCacheRanges(networkConfig.modbusTcpCacheRanges);
+  networkConfig.livePushInterval = constrain(doc["live_push_interval"] | LIVE_PUSH_INTERVAL_DEFAULT, LIVE_PUSH_INTERVAL_MIN, LIVE_PUSH_INTERVAL_MAX);
 
   LittleFS.end();
   //debugPrintNetConfig(networkConfig);
@@ -192,7 +211,7 @@ void saveNetworkConfig()
   }
 
   // Create JSON document
-  StaticJsonDocument<512> doc;
+  StaticJsonDocument<1024> doc;
   
   // Store magic number
   doc["magic_number"] = CONFIG_MAGIC_NUMBER;
@@ -217,6 +236,12 @@ void saveNetworkConfig()
   
   // Store Modbus TCP port
   doc["modbus_tcp_port"] = networkConfig.modbusTcpPort;
+  doc["modbus_tcp_ack_before_apply"] = networkConfig.modbusTcpAckBeforeApply;
+  doc["modbus_tcp_max_clients"] = networkConfig.modbusTcpMaxClients;
+  doc["modbus_tcp_rate_limit"] = networkConfig.modbusTcpRateLimit;
+  doc["modbus_tcp_pass_through"] = networkConfig.modbusTcpPassThrough;
+  writeModbusCacheRanges(doc.createNestedArray("modbus_tcp_cache_ttl"), networkConfig.modbusTcpCacheRanges, networkConfig.modbusTcpCacheRangeCount);
+  doc["live_push_interval"] = networkConfig.livePushInterval;
     
   // Open file for writing
   File configFile = LittleFS.open(CONFIG_FILENAME, "w");
@@ -316,6 +341,7 @@ void setupNetworkAPI()
         doc["ntp"] = networkConfig.ntpServer;
         doc["dst"] = networkConfig.dstEnabled;
         doc["modbusTcpPort"] = networkConfig.modbusTcpPort;
+        doc["livePushInterval"] = networkConfig.livePushInterval;
         
         String response;
         serializeJson(doc, response);
@@ -385,6 +411,12 @@ void setupNetworkAPI()
                 }
               }
 
+              // Update the live event rate if provided
+              if (doc.containsKey("livePushInterval")) {
+                uint16_t interval = doc["livePushInterval"];
+                networkConfig.livePushInterval = constrain(interval, LIVE_PUSH_INTERVAL_MIN, LIVE_PUSH_INTERVAL_MAX);
+              }
+
               // Save configuration to storage
               saveNetworkConfig();
 
@@ -405,6 +437,11 @@ void setupWebServer()
     log(LOG_ERROR, true, "LittleFS Mount Failed\n");
     return;
   }
+  loadWebAssets();
+
+  // Request headers used by handleFile(), the server only keeps the headers collected here
+  static const char *fileHeaders[] = {"Accept-Encoding", "If-None-Match"};
+  server.collectHeaders(fileHeaders, 2);
 
   // Route handlers
   server.on("/", HTTP_GET, handleRoot);
@@ -417,79 +454,110 @@ void setupWebServer()
 
   // Comprehensive system status endpoint
   server.on("/api/system/status", HTTP_GET, []() {
-    StaticJsonDocument<768> doc;
-    
-    if (!statusLocked) {
-      statusLocked = true;
-      
-      // Power supplies
-      JsonObject power = doc.createNestedObject("power");
-      power["mainVoltage"] = status.Vpsu;
-      power["mainVoltageOK"] = status.psuOK;
+    // Copy the shared state out so the locks are only held for the copy, not while writing JSON
+    if (!coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
+      server.send(500, "application/json", "{\"error\":\"Status locked\"}");
+      return;
+    }
+    StatusVariables current = status;
+    coreLockRelease(&statusLock);
+
+    JsonStream json(server);
+    json.begin();
+    json.beginObject();
       
-      // RTC status
-      JsonObject rtc = doc.createNestedObject("rtc");
-      rtc["ok"] = status.rtcOK;
+    // Power supplies
+    json.beginObject("power");
+    json.add("mainVoltage", current.Vpsu);
+    json.add("mainVoltageOK", current.psuOK);
+    json.endObject();
+    
+    // RTC status
+    json.beginObject("rtc");
+    json.add("ok", current.rtcOK);
+    
+    // Get current time
+    DateTime now;
+    if (getGlobalDateTime(now, 10)) {
+      char timeStr[32];
+      snprintf(timeStr, sizeof(timeStr), "%04d-%02d-%02d %02d:%02d:%02d", 
+               now.year, now.month, now.day,
+               now.hour, now.minute, now.second);
+      json.add("time", timeStr);
+    } else {
+      json.add("time", "Unknown");
+    }
+    json.endObject();
+          
+    // SD card info
+    json.beginObject("sd");
+    if (coreLockTry(&sdLock)) {
+      sdInfo_t card = sdInfo;
+      coreLockRelease(&sdLock);
+      json.add("inserted", card.inserted);
+      json.add("ready", card.ready);
       
-      // Get current time
-      DateTime now;
-      if (getGlobalDateTime(now, 10)) {
-        char timeStr[32];
-        snprintf(timeStr, sizeof(timeStr), "%04d-%02d-%02d %02d:%02d:%02d", 
-                 now.year, now.month, now.day,
-                 now.hour, now.minute, now.second);
-        rtc["time"] = timeStr;
-      } else {
-        rtc["time"] = "Unknown";
+      // Only include these if SD card is ready
+      if (card.ready) {
+        json.add("capacityGB", card.cardSizeBytes / 1000000000.0);
+        json.add("freeSpaceGB", card.cardFreeBytes / 1000000000.0);
+        json.add("logFileSizeKB", card.logSizeBytes / 1000.0);
+        json.add("sensorFileSizeKB", card.sensorSizeBytes / 1000.0);
       }
-            
-      // SD card info
-      JsonObject sd = doc.createNestedObject("sd");
-      if (!sdLocked) {
-        sdLocked = true;
-        sd["inserted"] = sdInfo.inserted;
-        sd["ready"] = sdInfo.ready;
-        
-        // Only include these if SD card is ready
-        if (sdInfo.ready) {
-          sd["capacityGB"] = sdInfo.cardSizeBytes / 1000000000.0;
-          sd["freeSpaceGB"] = sdInfo.cardFreeBytes / 1000000000.0;
-          sd["logFileSizeKB"] = sdInfo.logSizeBytes / 1000.0;
-          sd["sensorFileSizeKB"] = sdInfo.sensorSizeBytes / 1000.0;
-        }
-        sdLocked = false;
-      }
-      
-      // Enhanced Modbus status
-      JsonObject modbus = doc.createNestedObject("modbus");
-      modbus["connected"] = status.modbusConnected;
-      modbus["busy"] = status.modbusBusy;
-      modbus["hasOfflineBoards"] = hasOfflineBoards();
-      
-      // Modbus TCP status
-      JsonObject modbusTcp = doc.createNestedObject("modbusTcp");
-      modbusTcp["enabled"] = modbusTCPConfig.enabled;
-      modbusTcp["port"] = modbusTCPConfig.port > 0 ? modbusTCPConfig.port : MODBUS_TCP_DEFAULT_PORT;
-      modbusTcp["connectedClients"] = modbusServer.getConnectedClientCount();
-      
-      // Detailed client information
-      JsonArray clients = modbusTcp.createNestedArray("clients");
-      for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        String clientInfo = modbusServer.getClientInfo(i);
-        if (clientInfo.length() > 0) {
-          clients.add(clientInfo);
-        }
+    }
+    json.endObject();
+    
+    // Enhanced Modbus status
+    json.beginObject("modbus");
+    json.add("connected", current.modbusConnected);
+    json.add("busy", current.modbusBusy);
+    json.add("hasOfflineBoards", hasOfflineBoards());
+    json.beginArray("commandQueues");
+    for (uint8_t port = 0; port < 2; port++) {
+      busCommandQueue_t *queue = &modbusConfig[port].commands;
+      json.beginObject();
+      json.add("submitted", queue->submitted);
+      json.add("rejected", queue->rejected);
+      json.add("completed", queue->completed);
+      json.add("maxWaitUs", queue->maxWaitUs);
+      json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    
+    // Modbus TCP status
+    json.beginObject("modbusTcp");
+    json.add("enabled", modbusTCPConfig.enabled);
+    json.add("port", modbusTCPConfig.port > 0 ? modbusTCPConfig.port : MODBUS_TCP_DEFAULT_PORT);
+    json.add("connectedClients", modbusServer.getConnectedClientCount());
+    json.add("maxClients", modbusServer.getMaxClients());
+    
+    // Detailed client information
+    json.beginArray("clients");
+    for (int i = 0; i < modbusServer.getMaxClients(); i++) {
+      String clientInfo = modbusServer.getClientInfo(i);
+      if (clientInfo.length() > 0) {
+        json.add(nullptr, clientInfo);
       }
-      
-      statusLocked = false;
-      
-      String response;
-      serializeJson(doc, response);
-      server.send(200, "application/json", response);
     }
-    else {
-      server.send(500, "application/json", "{\"error\":\"Status locked\"}");
+    json.endArray();
+    json.endObject();
+
+    // Cross-core lock contention counters
+    json.beginObject("locks");
+    const coreLock_t *lockList[] = {&statusLock, &sdLock, &serialLock, &dateTimeLock, &rtcLock};
+    for (const coreLock_t *lock : lockList) {
+      json.beginObject(lock->name);
+      json.add("acquired", lock->acquired);
+      json.add("contended", lock->contended);
+      json.add("failed", lock->failed);
+      json.add("maxWaitUs", lock->maxWaitUs);
+      json.endObject();
     }
+    json.endObject();
+    
+    json.endObject();
+    json.end();
   });
 
   // System version endpoint
@@ -536,12 +604,11 @@ void startWebServer() {
   log(LOG_INFO, true, "HTTP server started\n");
   
   // Set Webserver Status
-  if (!statusLocked) {
-    statusLocked = true;
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
     status.webserverUp = true;
     status.webserverBusy = false;
     status.updated = true;
-    statusLocked = false;
+    coreLockRelease(&statusLock);
   }
 }
 
@@ -710,12 +777,11 @@ void manageEthernet(void)
     if (eth.linkStatus() == LinkOFF) {
       ethernetConnected = false;
       // Set Webserver Status
-      if (!statusLocked) {
-        statusLocked = true;
+      if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
         status.webserverUp = false;
         status.webserverBusy = false;
         status.updated = true;
-        statusLocked = false;
+        coreLockRelease(&statusLock);
       }
       log(LOG_INFO, true, "Ethernet disconnected, waiting for reconnect\n");
     } else {
@@ -747,12 +813,12 @@ void handleWebServer() {
     return;
   }
   server.handleClient();
-  if (!statusLocked) {
-    statusLocked = true;
+  manage_live_events();
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
     status.webserverBusy = false;
     status.webserverUp = true;
     status.updated = true;
-    statusLocked = false;
+    coreLockRelease(&statusLock);
   }
 }
 
@@ -778,73 +844,157 @@ void handleFileManagerPage(void) {
   handleRoot();
 }
 
-// Handle file requests - retrieve from LittleFS and send to client
-void handleFile(const char *path)
+// Static files ------------------------------------------------------------>
+struct ContentType
 {
-  if(eth.status() != WL_CONNECTED) {
-    if (!statusLocked) {
-      statusLocked = true;
-      status.webserverBusy = false;
-      status.webserverUp = false;
-      status.updated = true;
-      statusLocked = false;
+  const char *extension;
+  const char *type;
+};
+
+static const ContentType contentTypes[] = {
+  {".html", "text/html"},
+  {".css", "text/css"},
+  {".js", "application/javascript"},
+  {".json", "application/json"},
+  {".ico", "image/x-icon"},
+  {".png", "image/png"},
+  {".svg", "image/svg+xml"},
+  {".woff2", "font/woff2"},
+  {".woff", "font/woff"},
+};
+
+static const char *contentTypeFor(const String &path)
+{
+  for (const ContentType &entry : contentTypes) {
+    if (path.endsWith(entry.extension)) return entry.type;
+  }
+  return "text/plain";
+}
+
+static const WebAsset *findWebAsset(const String &path)
+{
+  for (uint8_t i = 0; i < webAssetCount; i++) {
+    if (path == webAssets[i].path) return &webAssets[i];
+  }
+  return nullptr;
+}
+
+// Load the content hashes of the web assets, files missing from the manifest are served without caching
+bool loadWebAssets(void)
+{
+  webAssetCount = 0;
+  File manifest = LittleFS.open(WEB_ASSET_MANIFEST, "r");
+  if (!manifest) {
+    log(LOG_WARNING, true, "Web asset manifest not found, static files will not be cached\n");
+    return false;
+  }
+
+  DynamicJsonDocument doc(2048);
+  DeserializationError error = deserializeJson(doc, manifest);
+  manifest.close();
+  if (error) {
+    log(LOG_WARNING, true, "Failed to parse web asset manifest: %s\n", error.c_str());
+    return false;
+  }
+
+  for (JsonPair asset : doc.as<JsonObject>()) {
+    const char *path = asset.key().c_str();
+    const char *hash = asset.value()["hash"] | "";
+    if (webAssetCount >= MAX_WEB_ASSETS || strlen(path) >= WEB_ASSET_PATH_LENGTH || strlen(hash) != WEB_ASSET_HASH_LENGTH) {
+      log(LOG_WARNING, true, "Web asset %s skipped, it will not be cached\n", path);
+      continue;
     }
-    return;
+    WebAsset &entry = webAssets[webAssetCount++];
+    strcpy(entry.path, path);
+    strcpy(entry.hash, hash);
+    entry.gzip = asset.value()["gzip"] | false;
   }
-  if (!statusLocked) {
-    statusLocked = true;
-    status.webserverBusy = true;
-    statusLocked = false;
-  }
-  String contentType;
-  if (strstr(path, ".html"))
-    contentType = "text/html";
-  else if (strstr(path, ".css"))
-    contentType = "text/css";
-  else if (strstr(path, ".js"))
-    contentType = "application/javascript";
-  else if (strstr(path, ".json"))
-    contentType = "application/json";
-  else if (strstr(path, ".ico"))
-    contentType = "image/x-icon";
-  else if (strstr(path, ".woff2"))
-    contentType = "font/woff2";
-  else if (strstr(path, ".woff"))
-    contentType = "font/woff";
-  else
-    contentType = "text/plain";
+  log(LOG_INFO, true, "Loaded %d web asset hashes\n", webAssetCount);
+  return true;
+}
 
+// Send a file from LittleFS. Files in the manifest get a strong ETag and are answered with 304 when the
+// browser's copy is current, their .gz variant is sent to browsers accepting gzip. Requests carrying the
+// current hash (?v=<hash>, as written into references by minify_web.py) may be cached for good.
+static void serveFile(const char *path)
+{
   String filePath = path;
   if (filePath.endsWith("/"))
     filePath += "index.html";
   if (!filePath.startsWith("/"))
     filePath = "/" + filePath;
+  const char *contentType = contentTypeFor(filePath);
 
-  if (LittleFS.exists(filePath))
-  {
+  const WebAsset *asset = findWebAsset(filePath);
+  if (!asset) {
     File file = LittleFS.open(filePath, "r");
+    if (!file) {
+      server.send(404, "text/plain", "File not found");
+      return;
+    }
     server.streamFile(file, contentType);
     file.close();
+    return;
+  }
+
+  bool gzip = asset->gzip && server.header("Accept-Encoding").indexOf("gzip") >= 0;
+  File file;
+  if (gzip) {
+    file = LittleFS.open(filePath + ".gz", "r");  // streamFile() adds Content-Encoding: gzip for a .gz file
+    gzip = (bool)file;
   }
+
+  // Each encoding is a separate representation with its own strong ETag
+  String etag = String("\"") + asset->hash + (gzip ? "-gz\"" : "\"");
+  server.sendHeader("ETag", etag);
+  if (server.arg("v") == asset->hash)
+    server.sendHeader("Cache-Control", "public, max-age=" + String(WEB_ASSET_MAX_AGE) + ", immutable");
   else
-  {
+    server.sendHeader("Cache-Control", "no-cache");  // Revalidated with If-None-Match on every use
+  if (asset->gzip)
+    server.sendHeader("Vary", "Accept-Encoding");
+
+  if (server.header("If-None-Match").indexOf(etag) >= 0) {
+    if (file) file.close();
+    server.send(304);
+    return;
+  }
+
+  if (!file) file = LittleFS.open(filePath, "r");
+  if (!file) {
     server.send(404, "text/plain", "File not found");
+    return;
   }
-  if (!statusLocked) {
-    statusLocked = true;
+  server.streamFile(file, contentType);
+  file.close();
+}
+
+// Handle file requests - retrieve from LittleFS and send to client
+void handleFile(const char *path)
+{
+  if(eth.status() != WL_CONNECTED) {
+    if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
+      status.webserverBusy = false;
+      status.webserverUp = false;
+      status.updated = true;
+      coreLockRelease(&statusLock);
+    }
+    return;
+  }
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
+    status.webserverBusy = true;
+    coreLockRelease(&statusLock);
+  }
+  serveFile(path);
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
     status.webserverBusy = false;
     status.webserverUp = true;
     status.updated = true;
-    statusLocked = false;
+    coreLockRelease(&statusLock);
   }
 }
 
 void handleSDDownloadFile(void) {
-  if (sdLocked) {
-    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
-    return;
-  }
-  
   if (!sdInfo.ready) {
     server.send(503, "application/json", "{\"error\":\"SD card not available\"}");
     return;
@@ -863,11 +1013,14 @@ void handleSDDownloadFile(void) {
     path = "/" + path;
   }
   
-  sdLocked = true;
+  if (!coreLockTry(&sdLock)) {
+    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
+    return;
+  }
   
   // Check if the file exists
   if (!sd.exists(path.c_str())) {
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(404, "application/json", "{\"error\":\"File not found\"}");
     return;
   }
@@ -876,14 +1029,14 @@ void handleSDDownloadFile(void) {
   FsFile file = sd.open(path.c_str(), O_RDONLY);
   
   if (!file) {
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(500, "application/json", "{\"error\":\"Failed to open file\"}");
     return;
   }
   
   if (file.isDirectory()) {
     file.close();
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(400, "application/json", "{\"error\":\"Path is a directory, not a file\"}");
     return;
   }
@@ -894,7 +1047,7 @@ void handleSDDownloadFile(void) {
   // Check file size limit
   if (fileSize > MAX_DOWNLOAD_SIZE) {
     file.close();
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     char errorMsg[128];
     snprintf(errorMsg, sizeof(errorMsg), 
              "{\"error\":\"File is too large for download (%u bytes). Maximum size is %u bytes.\"}",
@@ -935,11 +1088,11 @@ void handleSDDownloadFile(void) {
   server.setContentLength(fileSize);
   server.send(200, "application/octet-stream", ""); // Send headers only
   
-  // Stream file with careful progress monitoring
+  // Stream file with careful progress monitoring. sdLock is held, so nothing is logged to the SD card
   while (totalBytesRead < fileSize) {
     // Check for timeout
     if (millis() - lastProgressTime > timeout) {
-      log(LOG_WARNING, true, "Timeout occurred during file download\n");
+      log(LOG_WARNING, false, "Timeout occurred during file download\n");
       timeoutOccurred = true;
       break;
     }
@@ -955,7 +1108,7 @@ void handleSDDownloadFile(void) {
     // Write chunk to client
     if (client.write(buffer, bytesRead) != bytesRead) {
       // Client disconnected or write error
-      log(LOG_WARNING, true, "Client write error during file download\n");
+      log(LOG_WARNING, false, "Client write error during file download\n");
       break;
     }
     
@@ -968,7 +1121,7 @@ void handleSDDownloadFile(void) {
   
   // Clean up
   file.close();
-  sdLocked = false;
+  coreLockRelease(&sdLock);
   
   if (timeoutOccurred) {
     log(LOG_ERROR, true, "File download timed out after %u bytes\n", totalBytesRead);
@@ -982,11 +1135,6 @@ void handleSDDownloadFile(void) {
 }
 
 void handleSDViewFile(void) {
-  if (sdLocked) {
-    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
-    return;
-  }
-  
   if (!sdInfo.ready) {
     server.send(503, "application/json", "{\"error\":\"SD card not available\"}");
     return;
@@ -1005,11 +1153,14 @@ void handleSDViewFile(void) {
     path = "/" + path;
   }
   
-  sdLocked = true;
+  if (!coreLockTry(&sdLock)) {
+    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
+    return;
+  }
   
   // Check if the file exists
   if (!sd.exists(path.c_str())) {
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(404, "application/json", "{\"error\":\"File not found\"}");
     return;
   }
@@ -1018,14 +1169,14 @@ void handleSDViewFile(void) {
   FsFile file = sd.open(path.c_str(), O_RDONLY);
   
   if (!file) {
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(500, "application/json", "{\"error\":\"Failed to open file\"}");
     return;
   }
   
   if (file.isDirectory()) {
     file.close();
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(400, "application/json", "{\"error\":\"Path is a directory, not a file\"}");
     return;
   }
@@ -1061,7 +1212,7 @@ void handleSDViewFile(void) {
   } while (bytesRead == bufferSize);
   
   file.close();
-  sdLocked = false;
+  coreLockRelease(&sdLock);
 }
 
 // NTP management functions ------------------------------------------------>
@@ -1137,11 +1288,6 @@ void handleNTPUpdates(bool forceUpdate) {
 
 // SD Card File Manager API functions -------------------------------------->
 void handleSDListDirectory(void) {
-  if (sdLocked) {
-    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
-    return;
-  }
-  
   if (!sdInfo.ready) {
     server.send(503, "application/json", "{\"error\":\"SD card not available\"}");
     return;
@@ -1155,11 +1301,14 @@ void handleSDListDirectory(void) {
     path = "/" + path;
   }
   
-  sdLocked = true;
+  if (!coreLockTry(&sdLock)) {
+    server.send(423, "application/json", "{\"error\":\"SD card is locked\"}");
+    return;
+  }
   
   // Check if the path exists and is a directory
   if (!sd.exists(path.c_str())) {
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(404, "application/json", "{\"error\":\"Directory not found\"}");
     return;
   }
@@ -1168,80 +1317,73 @@ void handleSDListDirectory(void) {
   
   if (!dir.isDirectory()) {
     dir.close();
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     server.send(400, "application/json", "{\"error\":\"Not a directory\"}");
     return;
   }
   
-  // Create a JSON document for the response
-  DynamicJsonDocument doc(16384); // Adjust size based on expected directory size
+  // Stream the listing, a directory can hold more entries than a document would fit. The SD lock
+  // is held throughout, as for downloads. Files and directories are listed in separate passes.
+  JsonStream json(server);
+  json.begin();
+  json.beginObject();
+  json.add("path", path);
   
-  doc["path"] = path;
-  JsonArray files = doc.createNestedArray("files");
-  JsonArray directories = doc.createNestedArray("directories");
-  
-  // Read all files and directories in the requested path
-  dir.rewindDirectory();
+  // Entry paths are written as the directory followed by the name
+  String dirPath = path;
+  if (!dirPath.endsWith("/")) dirPath += "/";
   
   FsFile file;
   char filename[256];
-  while (file.openNext(&dir)) {
-    file.getName(filename, sizeof(filename));
-    
-    // Skip hidden files and . and ..
-    if (filename[0] == '.') {
-      file.close();
-      continue;
-    }
-    
-    // Create a JSON object for the file or directory
-    if (file.isDirectory()) {
-      JsonObject dirObj = directories.createNestedObject();
-      dirObj["name"] = filename;
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    bool listDirectories = pass == 1;
+    json.beginArray(listDirectories ? "directories" : "files");
+    dir.rewindDirectory();
+    while (file.openNext(&dir)) {
+      file.getName(filename, sizeof(filename));
       
-      // Calculate full path for this directory
-      String fullPath = path;
-      if (!path.endsWith("/")) fullPath += "/";
-      fullPath += filename;
-      dirObj["path"] = fullPath;
-    } else {
-      JsonObject fileObj = files.createNestedObject();
-      fileObj["name"] = filename;
-      fileObj["size"] = file.size();
-      
-      // Calculate full path for this file
-      String fullPath = path;
-      if (!path.endsWith("/")) fullPath += "/";
-      fullPath += filename;
-      fileObj["path"] = fullPath;
-      
-      // Add last modified date
-      uint16_t fileDate, fileTime;
-      file.getModifyDateTime(&fileDate, &fileTime);
+      // Skip hidden files and . and .., and entries listed in the other pass
+      if (filename[0] == '.' || file.isDirectory() != listDirectories) {
+        file.close();
+        continue;
+      }
       
-      int year = FS_YEAR(fileDate);
-      int month = FS_MONTH(fileDate);
-      int day = FS_DAY(fileDate);
-      int hour = FS_HOUR(fileTime);
-      int minute = FS_MINUTE(fileTime);
-      int second = FS_SECOND(fileTime);
+      json.beginObject();
+      json.add("name", filename);
+      if (listDirectories) {
+        json.add("path", dirPath.c_str(), filename);
+      } else {
+        json.add("size", file.size());
+        json.add("path", dirPath.c_str(), filename);
+        
+        // Add last modified date
+        uint16_t fileDate, fileTime;
+        file.getModifyDateTime(&fileDate, &fileTime);
+        
+        int year = FS_YEAR(fileDate);
+        int month = FS_MONTH(fileDate);
+        int day = FS_DAY(fileDate);
+        int hour = FS_HOUR(fileTime);
+        int minute = FS_MINUTE(fileTime);
+        int second = FS_SECOND(fileTime);
+        
+        char dateTimeStr[32];
+        snprintf(dateTimeStr, sizeof(dateTimeStr), "%04d-%02d-%02d %02d:%02d:%02d", 
+                 year, month, day, hour, minute, second);
+        json.add("modified", dateTimeStr);
+      }
+      json.endObject();
       
-      char dateTimeStr[32];
-      snprintf(dateTimeStr, sizeof(dateTimeStr), "%04d-%02d-%02d %02d:%02d:%02d", 
-               year, month, day, hour, minute, second);
-      fileObj["modified"] = dateTimeStr;
+      file.close();
     }
-    
-    file.close();
+    json.endArray();
   }
   
   dir.close();
-  sdLocked = false;
+  coreLockRelease(&sdLock);
   
-  // Send the JSON response
-  String response;
-  serializeJson(doc, response);
-  server.send(200, "application/json", response);
+  json.endObject();
+  json.end();
 }
 
 // Debug functions --------------------------------------------------------->
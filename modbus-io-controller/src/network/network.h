@@ -19,6 +19,25 @@
 // Maximum file size for downloads (5MB to be safe)
 #define MAX_DOWNLOAD_SIZE 5242880
 
+// Shortest time between live events pushed to the web UI (/api/events)
+#define LIVE_PUSH_INTERVAL_DEFAULT 500
+#define LIVE_PUSH_INTERVAL_MIN 100
+#define LIVE_PUSH_INTERVAL_MAX 10000
+
+// Static web assets, /assets.json is written by scripts/minify_web.py with a content hash per file
+#define WEB_ASSET_MANIFEST "/assets.json"
+#define MAX_WEB_ASSETS 16
+#define WEB_ASSET_PATH_LENGTH 40
+#define WEB_ASSET_HASH_LENGTH 16
+#define WEB_ASSET_MAX_AGE 31536000     // s, for requests carrying the current hash (?v=<hash>)
+
+struct WebAsset
+{
+    char path[WEB_ASSET_PATH_LENGTH];
+    char hash[WEB_ASSET_HASH_LENGTH + 1];
+    bool gzip;                  // A .gz variant is stored next to the file
+};
+
 void init_network(void);
 void manageNetwork(void);
 
@@ -47,6 +66,7 @@ void handleNetworkManager(void);
 void handleWebServer(void);
 void handleRoot(void);
 void handleFile(const char *path);
+bool loadWebAssets(void);
 void handleNTPUpdates(bool forceUpdate);
 void ntpUpdate(void);
 
@@ -57,6 +77,18 @@ void handleSDDownloadFile(void);
 void handleSDViewFile(void);
 void handleFileManagerPage(void);
 
+// Modbus TCP pass-through response cache lifetime for a read address range
+#define MODBUS_TCP_CACHE_RANGES 4
+#define MODBUS_TCP_DEFAULT_CACHE_TTL 500    // ms, default range covering every read
+
+struct ModbusCacheRange
+{
+    uint8_t functionCode;   // 1-4, 0 for any read
+    uint16_t start;
+    uint16_t end;           // Inclusive
+    uint16_t ttlMs;         // 0 to always read from the board
+};
+
 // Network configuration structure
 struct NetworkConfig
 {
@@ -71,6 +103,13 @@ struct NetworkConfig
     char timezone[8]; // Format: "+13:00"
     bool dstEnabled;  // Daylight Saving Time enabled
     uint16_t modbusTcpPort; // Modbus TCP port
+    bool modbusTcpAckBeforeApply; // Answer Modbus TCP writes once queued rather than once applied
+    uint8_t modbusTcpMaxClients;  // Modbus TCP connection pool size
+    uint16_t modbusTcpRateLimit;  // Modbus TCP requests per second per client, 0 for no limit
+    bool modbusTcpPassThrough;    // Forward Modbus TCP requests outside the register map to the boards
+    ModbusCacheRange modbusTcpCacheRanges[MODBUS_TCP_CACHE_RANGES]; // First matching range sets the TTL
+    uint8_t modbusTcpCacheRangeCount;
+    uint16_t livePushInterval;    // ms between live events pushed to the web UI
 };
 
 void printNetConfig(NetworkConfig config);
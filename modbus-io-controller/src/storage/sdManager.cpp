@@ -5,7 +5,7 @@ FsFile file;
 
 sdInfo_t sdInfo;
 uint32_t sdTS;
-volatile bool sdLocked = false;
+coreLock_t sdLock = CORE_LOCK_INIT("sd");
 
 void init_sdManager(void) {
     SPI1.setMISO(PIN_SD_MISO);
@@ -40,24 +40,21 @@ void mountSD(void) {
     // Check if SD card is inserted
     if (digitalRead(PIN_SD_CD)) {
         log(LOG_WARNING, false,"SD card not inserted\n");
-        if (sdLocked) return;
-        sdLocked = true;
+        if (!coreLockTry(&sdLock)) return;
         sdInfo.inserted = false;
         sdInfo.ready = false;
-        if (!statusLocked) {
-            statusLocked = true;
+        if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
             status.sdCardOK = false;
             status.updated = true;
-            statusLocked = false;
+            coreLockRelease(&statusLock);
         }
-        sdLocked = false;
+        coreLockRelease(&sdLock);
         return;
     }
     // Mount SD card
     bool sdSPIinitialised = false;
     bool sdSDIOinitialised = false;
-    if (sdLocked) return;
-    sdLocked = true;
+    if (!coreLockTry(&sdLock)) return;
     sdInfo.inserted = true;
     log(LOG_INFO, false, "SD card inserted, mounting FS\n");
     if (!sd.begin(SDIO_CONFIG)) {
@@ -86,65 +83,64 @@ void mountSD(void) {
         sdInfo.ready = true;
     }
     if (sdInfo.ready) log(LOG_INFO, false, "SD card mounted OK\n");
-    if (!statusLocked) {
-        statusLocked = true;
+    if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
         status.sdCardOK = true;
         status.updated = true;
-        statusLocked = false;
+        coreLockRelease(&statusLock);
     }
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     printSDInfo();
 }
 
 void maintainSD(void) {
     // Just check if the SD card is still inserted
-    if (sdLocked) return;
-    sdLocked = true;
+    if (!coreLockTry(&sdLock)) return;
     if (digitalRead(PIN_SD_CD) && sdInfo.inserted) {
         log(LOG_WARNING, false, "SD card removed\n");
         sdInfo.inserted = false;
         sdInfo.ready = false;
-        if (!statusLocked) {
-            statusLocked = true;
+        if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
             status.sdCardOK = false;
             status.updated = true;
-            statusLocked = false;
+            coreLockRelease(&statusLock);
         }
     }
-    sdLocked = false;
+    coreLockRelease(&sdLock);
 }
 
-uint64_t getFileSize(const char* path) {
+// Caller must hold sdLock
+static uint64_t fileSizeLocked(const char* path) {
     FsFile file;
     uint64_t size = 0;
-    if (sdLocked) return 0;
-    sdLocked = true;
     if (sd.exists(path)) {
         if (file.open(path, O_RDONLY)) {
             size = file.fileSize();
             file.close();
         }
     }
-    sdLocked = false;
+    return size;
+}
+
+uint64_t getFileSize(const char* path) {
+    if (!coreLockAcquire(&sdLock, SD_LOCK_TIMEOUT_US)) return 0;
+    uint64_t size = fileSizeLocked(path);
+    coreLockRelease(&sdLock);
     return size;
 }
 
 void printSDInfo(void) {
-    if (sdLocked) return;
-    sdLocked = true;
+    if (!coreLockTry(&sdLock)) return;
     if (!sdInfo.ready) {
         if (digitalRead(PIN_SD_CD)) log(LOG_INFO, false, "SD card not inserted\n");
         else log(LOG_INFO, false, "SD card not ready\n");
-        sdLocked = false;
+        coreLockRelease(&sdLock);
         return;
     }
 
     sdInfo.cardSizeBytes = (uint64_t)sd.card()->sectorCount() * 512;
     sdInfo.cardFreeBytes = (uint64_t)sd.vol()->bytesPerCluster() * (uint64_t)sd.freeClusterCount();
-    sdLocked = false;
-    uint64_t logFileSize = getFileSize("/logs/system.txt");
-    uint64_t sensorFileSize = getFileSize("/sensors/sensors.csv");
-    sdLocked = true;
+    uint64_t logFileSize = fileSizeLocked("/logs/system.txt");
+    uint64_t sensorFileSize = fileSizeLocked("/sensors/sensors.csv");
     sdInfo.logSizeBytes = logFileSize;
     sdInfo.sensorSizeBytes = sensorFileSize;
     
@@ -153,7 +149,7 @@ void printSDInfo(void) {
     log(LOG_INFO, false, "Volume is FAT%d\n", sd.vol()->fatType());
     log(LOG_INFO, false, "Log file size: %0.1f kbytes\n", 0.001 * (float)logFileSize);
     
-    sdLocked = false;
+    coreLockRelease(&sdLock);
 }
 
 void dateTimeCallback(uint16_t* date, uint16_t* time) {
@@ -168,13 +164,7 @@ void dateTimeCallback(uint16_t* date, uint16_t* time) {
 }
 
 bool writeLog(const char *message) {
-    if (sdLocked) return false;
-    sdLocked = true;
-    if (!sdInfo.ready) {
-        sdLocked = false;
-        return false;
-    }
-    sdLocked = false;
+    if (!sdInfo.ready) return false;
     DateTime now;
     if (!getGlobalDateTime(now, 10)) return false;
     char dateTimeStr[20];
@@ -183,9 +173,13 @@ bool writeLog(const char *message) {
     char buf[strlen(dateTimeStr) + strlen(message) + 10];
     snprintf(buf, sizeof(buf), "[%s]\t\t%s", dateTimeStr, message);
 
+    if (!coreLockAcquireShared(&sdLock, SD_LOCK_TIMEOUT_US)) return false;
+    if (!sdInfo.ready) {
+        coreLockRelease(&sdLock);
+        return false;
+    }
     // Log file size check
-    uint64_t logFileSize = getFileSize("/logs/system.txt");
-    sdLocked = true;
+    uint64_t logFileSize = fileSizeLocked("/logs/system.txt");
     sdInfo.logSizeBytes = logFileSize;
     if (logFileSize > SD_LOG_MAX_SIZE) {
         // Rename the existing log file and create a new one
@@ -210,7 +204,7 @@ bool writeLog(const char *message) {
                 file.print(buf);
                 file.close();
             }
-        sdLocked = false;
+        coreLockRelease(&sdLock);
         return true;
     }
     // Otherwise just write to the existing log file
@@ -219,18 +213,12 @@ bool writeLog(const char *message) {
         file.print(buf);
         file.close();
     }
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     return true;
 }
 
 bool writeSensorData(const char* data, const char* fileName, bool isHeader) {
-    if (sdLocked) return false;
-    sdLocked = true;
-    if (!sdInfo.ready) {
-        sdLocked = false;
-        return false;
-    }
-    sdLocked = false;
+    if (!sdInfo.ready) return false;
 
     DateTime now;
     if (!getGlobalDateTime(now, 10)) return false;
@@ -246,9 +234,13 @@ bool writeSensorData(const char* data, const char* fileName, bool isHeader) {
     char fileNameBuf[100];
     snprintf(fileNameBuf, sizeof(fileNameBuf), "/sensors/%s.csv", fileName);
 
+    if (!coreLockAcquireShared(&sdLock, SD_LOCK_TIMEOUT_US)) return false;
+    if (!sdInfo.ready) {
+        coreLockRelease(&sdLock);
+        return false;
+    }
     // Log file size check
-    uint64_t fileSize = getFileSize(fileNameBuf);
-    sdLocked = true;
+    uint64_t fileSize = fileSizeLocked(fileNameBuf);
     sdInfo.logSizeBytes = fileSize;
     if (fileSize > SD_LOG_MAX_SIZE) {
         // Rename the existing sensor file and create a new one
@@ -273,7 +265,7 @@ bool writeSensorData(const char* data, const char* fileName, bool isHeader) {
                 file.print(buf);
                 file.close();
             }
-        sdLocked = false;
+        coreLockRelease(&sdLock);
         return true;
     }
     // Otherwise just write to the existing log file
@@ -282,6 +274,6 @@ bool writeSensorData(const char* data, const char* fileName, bool isHeader) {
         file.print(buf);
         file.close();
     }
-    sdLocked = false;
+    coreLockRelease(&sdLock);
     return true;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #define SD_SENSOR_MAX_SIZE 1000000     //1MB max size
 
 #define SD_MANAGE_INTERVAL 1000
+#define SD_LOCK_TIMEOUT_US 20000       // Longest wait for a log or sensor write on core 0, core 1 skips it
 
 void init_sdManager(void);
 void manageSD(void);
@@ -34,6 +35,6 @@ struct sdInfo_t {
 };
 
 extern SdFs sd;
-extern volatile bool sdLocked;
+extern coreLock_t sdLock;
 extern sdInfo_t sdInfo;
 extern uint32_t sdTS;
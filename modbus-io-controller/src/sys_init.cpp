@@ -1,4 +1,5 @@
 #include "sys_init.h"
+#include "io_core/board_config.h"
 
 // Object definitions
 
@@ -33,6 +34,7 @@ void init_core1(void) {
 
 void manage_core0(void) {
     manageNetwork();
+    manageBoardConfig();
 }
 
 void manage_core1(void) {
@@ -32,12 +32,14 @@
 #include "Adafruit_Neopixel.h"
 #include "MCP79410.h"
 #include "ModbusRTUMaster.h"
+#include "ModbusRTUTransportRP2040.h"
 
 // Include program files
 #include "hardware/pins.h"
 
 #include "network/network.h"
 
+#include "utils/coreLock.h"
 #include "utils/logger.h"
 #include "utils/statusManager.h"
 #include "utils/timeManager.h"
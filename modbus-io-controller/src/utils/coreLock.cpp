@@ -0,0 +1,110 @@
+#include "coreLock.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/sync.h>
+// Striped spinlocks are shared by design, this one is only held for the few instructions below
+#define CORE_LOCK_SPINLOCK PICO_SPINLOCK_ID_STRIPED_FIRST
+#else
+#include <thread>
+#endif
+
+// Take the lock if it is free, counting contention if requested
+static bool lock_test_and_set(coreLock_t *lock, bool countContention) {
+#if defined(ARDUINO_ARCH_RP2040)
+    spin_lock_t *spin = spin_lock_instance(CORE_LOCK_SPINLOCK);
+    uint32_t irq = spin_lock_blocking(spin);
+    bool taken = !lock->held;
+    if (taken) lock->held = true;
+    else if (countContention) lock->contended++;
+    spin_unlock(spin, irq);
+    return taken;
+#else
+    bool expected = false;
+    if (__atomic_compare_exchange_n(&lock->held, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return true;
+    if (countContention) __atomic_fetch_add(&lock->contended, 1, __ATOMIC_RELAXED);
+    return false;
+#endif
+}
+
+static void lock_count_failure(coreLock_t *lock) {
+#if defined(ARDUINO_ARCH_RP2040)
+    spin_lock_t *spin = spin_lock_instance(CORE_LOCK_SPINLOCK);
+    uint32_t irq = spin_lock_blocking(spin);
+    lock->failed++;
+    spin_unlock(spin, irq);
+#else
+    __atomic_fetch_add(&lock->failed, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void lock_pause(void) {
+#if defined(ARDUINO_ARCH_RP2040)
+    tight_loop_contents();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+bool coreLockTry(coreLock_t *lock) {
+    if (!lock_test_and_set(lock, true)) {
+        lock_count_failure(lock);
+        return false;
+    }
+    lock->acquired++;
+    return true;
+}
+
+bool coreLockAcquire(coreLock_t *lock, uint32_t timeoutUs) {
+    if (lock_test_and_set(lock, true)) {
+        lock->acquired++;
+        return true;
+    }
+    uint32_t start = micros();
+    while (true) {
+        lock_pause();
+        uint32_t waited = micros() - start;
+        if (lock_test_and_set(lock, false)) {
+            lock->acquired++;
+            if (waited > lock->maxWaitUs) lock->maxWaitUs = waited;
+            return true;
+        }
+        if (waited >= timeoutUs) break;
+    }
+    lock_count_failure(lock);
+    return false;
+}
+
+bool coreLockAcquireShared(coreLock_t *lock, uint32_t timeoutUs) {
+    if (rp2040.cpuid() == CORE_LOCK_NO_WAIT_CORE) return coreLockTry(lock);
+    return coreLockAcquire(lock, timeoutUs);
+}
+
+void coreLockRelease(coreLock_t *lock) {
+#if defined(ARDUINO_ARCH_RP2040)
+    __dmb();
+    lock->held = false;
+#else
+    __atomic_store_n(&lock->held, false, __ATOMIC_RELEASE);
+#endif
+}
+
+bool coreLockHeld(const coreLock_t *lock) {
+    return lock->held;
+}
+
+bool coreCompareAndSwap(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+#if defined(ARDUINO_ARCH_RP2040)
+    // Cortex-M0+ has no exclusive load/store, the hardware spinlock makes the compare and write atomic
+    spin_lock_t *spin = spin_lock_instance(CORE_LOCK_SPINLOCK);
+    uint32_t irq = spin_lock_blocking(spin);
+    bool swapped = *word == expected;
+    if (swapped) {
+        __dmb();
+        *word = desired;
+    }
+    spin_unlock(spin, irq);
+    return swapped;
+#else
+    return __atomic_compare_exchange_n(word, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
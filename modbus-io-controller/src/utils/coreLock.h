@@ -0,0 +1,38 @@
+/*
+ * Cross-core locks for data shared between core 0 (network) and core 1 (IO, SD, status).
+ * The lock word is test-and-set inside an RP2040 hardware spinlock, so taking a lock is atomic
+ * across both cores (on the host build GCC atomics are used instead).
+ * - coreLockTry() for work that can simply be skipped and retried later (e.g. LED refresh)
+ * - coreLockAcquire() waits up to a timeout, for updates that must not be lost
+ * - coreLockAcquireShared() for code called from both cores (logging, SD writes): it waits on core 0
+ *   but only tries on core 1, where a busy-wait would stall the RS485 bus scheduler
+ * The locks are not recursive, and every successful try/acquire must be paired with a release.
+ * Each lock counts acquisitions, contention, failures and its longest wait for the status API.
+ * coreCompareAndSwap() uses the same primitive for lock-free state words (e.g. the bus command queue).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+struct coreLock_t {
+    const char *name;
+    volatile bool held;
+    volatile uint32_t acquired;     // Successful acquisitions
+    volatile uint32_t contended;    // Attempts that found the lock held
+    volatile uint32_t failed;       // Try/timed attempts that gave up
+    volatile uint32_t maxWaitUs;    // Longest wait of a successful timed acquisition
+};
+
+#define CORE_LOCK_NO_WAIT_CORE 1        // Core running the RS485 bus scheduler, never waits for a lock
+
+#define CORE_LOCK_INIT(lockName) {lockName, false, 0, 0, 0, 0}
+
+bool coreLockTry(coreLock_t *lock);
+bool coreLockAcquire(coreLock_t *lock, uint32_t timeoutUs);
+bool coreLockAcquireShared(coreLock_t *lock, uint32_t timeoutUs);
+void coreLockRelease(coreLock_t *lock);
+bool coreLockHeld(const coreLock_t *lock);
+
+// Atomically replace *word with desired if it equals expected, returns true if it was replaced
+bool coreCompareAndSwap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
@@ -0,0 +1,192 @@
+#include "jsonStream.h"
+#include <math.h>
+
+static_assert(JSON_STREAM_MAX_DEPTH <= 32, "_hasMembers has one bit per depth");
+
+JsonStream::JsonStream(WebServer &server, bool pretty) : _server(server), _pretty(pretty) {}
+
+// Send the status and headers, the body follows in chunks
+void JsonStream::begin(int code, const char *contentType) {
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(code, contentType, "");
+}
+
+// Send what is left and the last chunk, returns the body size
+size_t JsonStream::end(void) {
+    sendBuffer();
+    _server.sendContent("");
+    return _total;
+}
+
+// Buffer ------------------------------------------------------------------->
+void JsonStream::sendBuffer(void) {
+    if (_length == 0) return;
+    _server.sendContent(_buffer, _length);
+    _total += _length;
+    _length = 0;
+}
+
+size_t JsonStream::write(uint8_t c) {
+    if (_overflow) return 1;
+    if (_length == sizeof(_buffer)) sendBuffer();
+    _buffer[_length++] = c;
+    return 1;
+}
+
+size_t JsonStream::write(const uint8_t *buffer, size_t size) {
+    if (_overflow) return size;
+    size_t written = 0;
+    while (written < size) {
+        if (_length == sizeof(_buffer)) sendBuffer();
+        size_t count = min(size - written, sizeof(_buffer) - _length);
+        memcpy(&_buffer[_length], &buffer[written], count);
+        _length += count;
+        written += count;
+    }
+    return written;
+}
+
+// Structure ---------------------------------------------------------------->
+void JsonStream::newline(void) {
+    if (!_pretty) return;
+    print("\r\n");
+    for (uint8_t i = 0; i < _depth; i++) print("  ");
+}
+
+// Comma before every value but the first of its container, then the key if there is one
+void JsonStream::separator(const char *key) {
+    if (_depth > 0) {
+        uint32_t bit = 1UL << (_depth - 1);
+        if (_hasMembers & bit) write(',');
+        _hasMembers |= bit;
+        newline();
+    }
+    if (key) {
+        writeString(key);
+        print(_pretty ? ": " : ":");
+    }
+}
+
+// Past the depth limit the container is replaced by null and nothing is written until it is closed
+void JsonStream::open(const char *key, char bracket) {
+    separator(key);
+    if (_depth == JSON_STREAM_MAX_DEPTH) {
+        print("null");
+        _overflow++;
+        return;
+    }
+    write(bracket);
+    _depth++;
+    _hasMembers &= ~(1UL << (_depth - 1));
+}
+
+void JsonStream::close(char bracket) {
+    if (_overflow) {
+        _overflow--;
+        return;
+    }
+    if (_depth == 0) return;
+    bool empty = !(_hasMembers & (1UL << (_depth - 1)));
+    _depth--;
+    if (!empty) newline();
+    write(bracket);
+}
+
+void JsonStream::beginObject(const char *key) { open(key, '{'); }
+void JsonStream::endObject(void) { close('}'); }
+void JsonStream::beginArray(const char *key) { open(key, '['); }
+void JsonStream::endArray(void) { close(']'); }
+void JsonStream::key(const char *key) { separator(key); }
+
+// Values ------------------------------------------------------------------->
+void JsonStream::writeString(const char *value) {
+    write('"');
+    writeEscaped(value);
+    write('"');
+}
+
+void JsonStream::writeEscaped(const char *value) {
+    for (const char *c = value; *c; c++) {
+        switch (*c) {
+            case '"':  print("\\\""); break;
+            case '\\': print("\\\\"); break;
+            case '\b': print("\\b"); break;
+            case '\f': print("\\f"); break;
+            case '\n': print("\\n"); break;
+            case '\r': print("\\r"); break;
+            case '\t': print("\\t"); break;
+            default:
+                if ((uint8_t)*c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)*c);
+                    print(escaped);
+                } else {
+                    write((uint8_t)*c);
+                }
+        }
+    }
+}
+
+void JsonStream::add(const char *key, const char *value) {
+    separator(key);
+    if (value) writeString(value);
+    else print("null");
+}
+
+// E.g. a directory and a file name, without building the path first
+void JsonStream::add(const char *key, const char *prefix, const char *value) {
+    separator(key);
+    write('"');
+    writeEscaped(prefix);
+    writeEscaped(value);
+    write('"');
+}
+
+void JsonStream::add(const char *key, bool value) {
+    separator(key);
+    print(value ? "true" : "false");
+}
+
+// 64 bit values are formatted here, printf's %llu isn't available in every C library build
+void JsonStream::writeUnsigned(unsigned long long value) {
+    char text[21];
+    uint8_t pos = sizeof(text);
+    do {
+        text[--pos] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    write((const uint8_t *)&text[pos], sizeof(text) - pos);
+}
+
+void JsonStream::add(const char *key, long value) {
+    add(key, (long long)value);
+}
+
+void JsonStream::add(const char *key, unsigned long value) {
+    add(key, (unsigned long long)value);
+}
+
+void JsonStream::add(const char *key, long long value) {
+    separator(key);
+    if (value < 0) write('-');
+    writeUnsigned(value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value);
+}
+
+void JsonStream::add(const char *key, unsigned long long value) {
+    separator(key);
+    writeUnsigned(value);
+}
+
+void JsonStream::add(const char *key, float value) {
+    char text[24];
+    separator(key);
+    if (isfinite(value)) write((const uint8_t *)text, snprintf(text, sizeof(text), "%.7g", value));
+    else print("null");
+}
+
+void JsonStream::add(const char *key, double value) {
+    char text[32];
+    separator(key);
+    if (isfinite(value)) write((const uint8_t *)text, snprintf(text, sizeof(text), "%.10g", value));
+    else print("null");
+}
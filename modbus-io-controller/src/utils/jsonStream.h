@@ -0,0 +1,89 @@
+/*
+ * Streaming JSON writer for web API responses.
+ * Values are written as they are produced into a fixed buffer that is sent to the current web
+ * client as a chunk (Transfer-Encoding: chunked) whenever it fills, so a response of any size
+ * needs neither a JsonDocument sized for all of it nor a String copy of it on the heap.
+ * Commas and (for pretty output) indentation are inserted automatically.
+ *
+ *   JsonStream json(server);
+ *   json.begin();                   // Status and headers, CORS headers are added before as usual
+ *   json.beginObject();
+ *   json.beginArray("boards");
+ *   json.beginObject();
+ *   json.add("id", 1);
+ *   json.add("name", "Board 1");    // Strings are escaped
+ *   json.endObject();
+ *   json.endArray();
+ *   json.endObject();
+ *   json.end();                     // Last chunk, returns the body size
+ *
+ * A small JsonDocument can still be built for a part of the response and written with
+ * serializeJson(doc, json) after key(), the stream is a Print.
+ *
+ * A container nested deeper than JSON_STREAM_MAX_DEPTH is written as null and its content is
+ * dropped, so the output stays valid JSON.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#define JSON_STREAM_BUFFER_SIZE 512     // Chunk size, on the stack of the handler
+#define JSON_STREAM_MAX_DEPTH 8         // Nested objects/arrays
+
+class JsonStream : public Print {
+public:
+    explicit JsonStream(WebServer &server, bool pretty = false);
+
+    void begin(int code = 200, const char *contentType = "application/json");
+    size_t end(void);
+
+    // Containers, with a key inside an object
+    void beginObject(const char *key = nullptr);
+    void endObject(void);
+    void beginArray(const char *key = nullptr);
+    void endArray(void);
+
+    // Start a member (or an array element with nullptr), for a value written with print()
+    void key(const char *key);
+
+    // Values, with a key inside an object and nullptr inside an array
+    void add(const char *key, const char *value);
+    void add(const char *key, const String &value) { add(key, value.c_str()); }
+    void add(const char *key, const char *prefix, const char *value); // One string from two parts
+    void add(const char *key, bool value);
+    void add(const char *key, int value) { add(key, (long)value); }
+    void add(const char *key, unsigned int value) { add(key, (unsigned long)value); }
+    void add(const char *key, long value);
+    void add(const char *key, unsigned long value);
+    void add(const char *key, long long value);
+    void add(const char *key, unsigned long long value);
+    void add(const char *key, float value);        // Not a number is written as null
+    void add(const char *key, double value);
+
+    size_t size(void) const { return _total + _length; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+private:
+    void separator(const char *key);
+    void open(const char *key, char bracket);
+    void close(char bracket);
+    void newline(void);
+    void writeString(const char *value);
+    void writeEscaped(const char *value);
+    void writeUnsigned(unsigned long long value);
+    void sendBuffer(void);
+
+    WebServer &_server;
+    bool _pretty;
+    char _buffer[JSON_STREAM_BUFFER_SIZE];
+    size_t _length = 0;
+    size_t _total = 0;              // Bytes already sent
+    uint8_t _depth = 0;
+    uint8_t _overflow = 0;          // Containers open past JSON_STREAM_MAX_DEPTH, their content is dropped
+    uint32_t _hasMembers = 0;       // Bit per depth, set once the container has a value
+};
@@ -3,7 +3,7 @@
 // Critical section for controlling access to Serial
 bool serialBusy = false;
 bool serialReady = false;
-bool serialLocked = false;
+coreLock_t serialLock = CORE_LOCK_INIT("serial");
 
 // Log entry types
 const char *logType[] = {"INFO", "WARNING", "ERROR", "DEBUG"};
@@ -22,8 +22,9 @@ void init_logger(void) {
 }
 
 void log(uint8_t logLevel, bool logToSD, const char* format, ...) {
-    // Create a buffer to store the output
-    static char buffer[DEBUG_PRINTF_BUFFER_SIZE];
+    // One buffer per core, both cores log and only the serial write is under serialLock
+    static char buffers[2][DEBUG_PRINTF_BUFFER_SIZE];
+    char *buffer = buffers[rp2040.cpuid()];
       
     // Prepare the log level string.
     const char* logLevelStr = (logLevel < sizeof(logType) / sizeof(logType[0])) ? logType[logLevel] : "UNKNOWN";
@@ -43,10 +44,9 @@ void log(uint8_t logLevel, bool logToSD, const char* format, ...) {
     
     if(len > 0) {
         if (logToSD) writeLog(buffer);
-        if (!serialLocked) {
-            serialLocked = true;
+        if (coreLockAcquireShared(&serialLock, SERIAL_LOCK_TIMEOUT_US)) {
             Serial.print(buffer);
-            serialLocked = false;
+            coreLockRelease(&serialLock);
         }
     }
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ void init_logger(void);
 void log(uint8_t logLevel, bool logToSD,const char* format, ...);
 
 // Serial port mutex
+#define SERIAL_LOCK_TIMEOUT_US 5000    // Core 0 only, core 1 drops the line while the port is busy
 
 extern bool serialReady;
-extern bool serialLocked;
+extern coreLock_t serialLock;
@@ -33,12 +33,11 @@ void managePower(void) {
   }
 
   // Update global status
-  if (statusLocked) return;
-  statusLocked = true;
+  if (!coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) return;
   status.Vpsu = Vpsu;
   if (statusChanged) {
     status.psuOK = psuOK;
   }
   status.updated = true;
-  statusLocked = false;
+  coreLockRelease(&statusLock);
 }
\ No newline at end of file
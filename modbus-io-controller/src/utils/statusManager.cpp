@@ -6,7 +6,7 @@ Adafruit_NeoPixel leds(4, PIN_LED_DAT, NEO_GRB + NEO_KHZ800);
 
 // Status variables
 StatusVariables status;
-bool statusLocked = false;
+coreLock_t statusLock = CORE_LOCK_INIT("status");
 static bool blinkState = false;
 static uint32_t ledTS = 0;
 
@@ -24,8 +24,7 @@ void init_statusManager() {
 void manageStatus(void)
 {
   if (millis() - ledTS < LED_UPDATE_PERIOD) return;
-  if (statusLocked) return;
-  statusLocked = true;
+  if (!coreLockTry(&statusLock)) return;
   
   // Check for status change and update LED colours accordingly
   if (status.updated) {
@@ -62,7 +61,7 @@ void manageStatus(void)
     }
     leds.show();
   }
-  statusLocked = false;
+  coreLockRelease(&statusLock);
 }
 
 // Check if any initialised boards are offline
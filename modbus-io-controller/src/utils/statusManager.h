@@ -1,8 +1,8 @@
 /* Description: Holds the global status struct and LED manager functions
  * Call manageStatus() in the main loop frequently to keep the LEDs updated
  * Use the status struct to update the status of the system from other functions,
- * ensure that the status struct is only accessed after checking the statusLocked flag.
- * Set statusLocked to true before updating the status struct and set it to false after updating.
+ * ensure that the status struct is only accessed while holding statusLock (see coreLock.h).
+ * Take it with coreLockTry() or coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US) and release it after updating.
  * Set status.updated to true after updating the status struct if LED colours need to change.
  */
 
@@ -76,4 +76,6 @@ extern Adafruit_NeoPixel leds;
 
 // Status variables
 extern StatusVariables status;
-extern bool statusLocked;
\ No newline at end of file
+extern coreLock_t statusLock;
+
+#define STATUS_LOCK_TIMEOUT_US 1000
\ No newline at end of file
@@ -12,14 +12,13 @@ void init_terminalManager(void) {
 
 void manageTerminal(void)
 {
-  if (serialLocked || !terminalReady) return;
-  serialLocked = true;
+  if (!terminalReady || !coreLockTry(&serialLock)) return;
   if (Serial.available())
   {
     char serialString[10];  // Buffer for incoming serial data
     memset(serialString, 0, sizeof(serialString));
     int bytesRead = Serial.readBytesUntil('\n', serialString, sizeof(serialString) - 1); // Leave room for null terminator
-    serialLocked = false;
+    coreLockRelease(&serialLock);
     if (bytesRead > 0 ) {
       serialString[bytesRead] = '\0'; // Add null terminator
       log(LOG_INFO, true,"Received:  %s\n", serialString);
@@ -56,15 +55,16 @@ void manageTerminal(void)
       // Status ---------------------------------------------->
       else if (strcmp(serialString, "status") == 0) {
         log(LOG_INFO, false, "Getting status...\n");
-        if (statusLocked) {
+        if (!coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
           log(LOG_INFO, false, "Status is locked\n");
         } else {
-          statusLocked = true;
-          log(LOG_INFO, false, "24V supply %0.1fV status: %s\n", status.Vpsu, status.psuOK ? "OK" : "OUT OF RANGE");
-          log(LOG_INFO, false, "RTC status: %s\n", status.rtcOK ? "OK" : "ERROR");
-          log(LOG_INFO, false, "Modbus status: %s\n", status.modbusConnected ? "CONNECTED" : "DOWN");
-          log(LOG_INFO, false, "Webserver status: %s\n", status.webserverUp ? "OK" : "DOWN");
-          statusLocked = false;
+          // Copy out so the lock isn't held while printing
+          StatusVariables current = status;
+          coreLockRelease(&statusLock);
+          log(LOG_INFO, false, "24V supply %0.1fV status: %s\n", current.Vpsu, current.psuOK ? "OK" : "OUT OF RANGE");
+          log(LOG_INFO, false, "RTC status: %s\n", current.rtcOK ? "OK" : "ERROR");
+          log(LOG_INFO, false, "Modbus status: %s\n", current.modbusConnected ? "CONNECTED" : "DOWN");
+          log(LOG_INFO, false, "Webserver status: %s\n", current.webserverUp ? "OK" : "DOWN");
         }
       }
 
@@ -102,9 +102,11 @@ void manageTerminal(void)
       }
     }
     // Clear the serial buffer each loop.
-    serialLocked = true;
-    while(Serial.available()) Serial.read();
-    serialLocked = false;
+    if (coreLockAcquire(&serialLock, SERIAL_LOCK_TIMEOUT_US)) {
+      while(Serial.available()) Serial.read();
+      coreLockRelease(&serialLock);
+    }
+  } else {
+    coreLockRelease(&serialLock);
   }
-  serialLocked = false;
 }
@@ -3,8 +3,8 @@
 MCP79410 rtc(Wire1);
 
 // Global DateTime protection
-volatile bool dateTimeLocked = false;
-volatile bool dateTimeWriteLocked = false;
+coreLock_t dateTimeLock = CORE_LOCK_INIT("dateTime");
+coreLock_t rtcLock = CORE_LOCK_INIT("rtc");
 
 DateTime globalDateTime;
 
@@ -17,11 +17,10 @@ void init_timeManager(void) {
   if (!rtc.begin())
   {
     log(LOG_ERROR, false, "RTC initialization failed!\n");
-    if (!statusLocked) {
-      statusLocked = true;
+    if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
       status.rtcOK = false;
       status.updated = true;
-      statusLocked = false;
+      coreLockRelease(&statusLock);
     }
     return;
   }
@@ -35,41 +34,36 @@ void init_timeManager(void) {
                 
   log(LOG_INFO, false, "RTC update task started\n");
   lastTimeUpdate = millis();
-  if (!statusLocked) {
-    statusLocked = true;
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
     status.rtcOK = true;
     status.updated = true;
-    statusLocked = false;
+    coreLockRelease(&statusLock);
   }
 }
 
 void manageTime(void)
 {
   if (millis() - lastTimeUpdate < TIME_UPDATE_INTERVAL) return;
-  if (dateTimeLocked) return;
-  dateTimeLocked = true;
+  // Skip this update if the RTC is being set, the I2C read happens outside dateTimeLock
+  if (!coreLockTry(&rtcLock)) return;
   DateTime currentTime;
-  if (rtc.getDateTime(&currentTime)) {
+  bool rtcOK = rtc.getDateTime(&currentTime);
+  coreLockRelease(&rtcLock);
+  if (rtcOK) {
     /*log(LOG_INFO, false, "Current date and time is: %04d-%02d-%02d %02d:%02d:%02d, epoch time: %u\n",
                   currentTime.year, currentTime.month, currentTime.day,
                   currentTime.hour, currentTime.minute, currentTime.second, currentTime.epochTime);*/
-    memcpy(&globalDateTime, &currentTime, sizeof(DateTime));
-    dateTimeLocked = false;
+    if (coreLockAcquire(&dateTimeLock, TIME_LOCK_TIMEOUT_US)) {
+      memcpy(&globalDateTime, &currentTime, sizeof(DateTime));
+      coreLockRelease(&dateTimeLock);
+    }
   } else {
-    dateTimeLocked = false;
     log(LOG_ERROR, true, "Failed to read time from RTC\n");
-    if (!statusLocked) {
-      statusLocked = true;
-      status.rtcOK = false;
-      status.updated = true;
-      statusLocked = false;
-    }
   }
-  if (!statusLocked) {
-    statusLocked = true;
-    status.rtcOK = true;
+  if (coreLockAcquire(&statusLock, STATUS_LOCK_TIMEOUT_US)) {
+    status.rtcOK = rtcOK;
     status.updated = true;
-    statusLocked = false;
+    coreLockRelease(&statusLock);
   }
   lastTimeUpdate += TIME_UPDATE_INTERVAL;  
 }
@@ -87,27 +81,13 @@ DateTime epochToDateTime(time_t epochTime) {
 }
 
 bool getGlobalDateTime(DateTime &dt, uint32_t timeout) {
-  uint32_t startTime = millis();
-  bool wasLocked = false;
-  
-  while (dateTimeLocked || dateTimeWriteLocked) {
-    if (!wasLocked) {
-      wasLocked = true;
-      // Only log once per lock cycle to avoid spam
-    }
-    if (millis() - startTime > timeout) {
-      if (wasLocked) {
-        log(LOG_WARNING, false, "getGlobalDateTime timeout after %dms - locks: dateTime=%d, write=%d\n", 
-            timeout, dateTimeLocked, dateTimeWriteLocked);
-      }
-      return false;
-    }
-    delay(1); // Small delay to prevent busy waiting
+  if (!coreLockAcquire(&dateTimeLock, timeout * 1000)) {
+    log(LOG_WARNING, false, "getGlobalDateTime timeout after %dms - locks: dateTime=%d, rtc=%d\n",
+        timeout, coreLockHeld(&dateTimeLock), coreLockHeld(&rtcLock));
+    return false;
   }
-  
-  dateTimeLocked = true;
   memcpy(&dt, &globalDateTime, sizeof(DateTime));
-  dateTimeLocked = false;
+  coreLockRelease(&dateTimeLock);
   return true;
 }
 
@@ -127,11 +107,10 @@ uint32_t rtcSeconds(void) {
 
 // Function to safely update the DateTime
 bool updateGlobalDateTime(const DateTime &dt) {
-  if (dateTimeWriteLocked) {
+  if (!coreLockTry(&rtcLock)) {
     log(LOG_ERROR, true, "Failed to update time: DateTime write lock is active - can't handle multiple simultaneous updates\n");
     return false;
   }
-  dateTimeWriteLocked = true;
   const int maxRetries = 3; // Maximum number of retries
   const int retryDelayMs = 100; // Delay between retries (milliseconds)
   bool success = false;
@@ -152,7 +131,11 @@ bool updateGlobalDateTime(const DateTime &dt) {
             currentTime.minute == dt.minute &&
             currentTime.second == dt.second) {
               log(LOG_INFO, false, "RTC verification successful after %d retries.\n", retry);
-              memcpy(&globalDateTime, &dt, sizeof(DateTime)); // Update global time after successful write
+              // Update global time after successful write
+              if (coreLockAcquire(&dateTimeLock, TIME_LOCK_TIMEOUT_US)) {
+                memcpy(&globalDateTime, &dt, sizeof(DateTime));
+                coreLockRelease(&dateTimeLock);
+              }
               success = true;
               break; // Exit retry loop on success
         } else {
@@ -169,14 +152,13 @@ bool updateGlobalDateTime(const DateTime &dt) {
         delay(retryDelayMs);
       }
   }
+  coreLockRelease(&rtcLock);
   if(success) {
       log(LOG_INFO, true, "Time successfully set to: %04d-%02d-%02d %02d:%02d:%02d\n",
                     dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second);
-      dateTimeWriteLocked = false;
       return true;
   } else {
       log(LOG_ERROR, true, "Failed to set RTC time after maximum retries.\n");
-      dateTimeWriteLocked = false;
       return false;
   }
 }
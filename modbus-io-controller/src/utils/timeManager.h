@@ -12,10 +12,11 @@ uint32_t rtcSeconds(void);
 
 extern MCP79410 rtc;
 
-// Global DateTime protection
-extern volatile bool dateTimeLocked;
-extern volatile bool dateTimeWriteLocked;
+// Global DateTime protection, dateTimeLock guards the globalDateTime copy and rtcLock the RTC itself
+extern coreLock_t dateTimeLock;
+extern coreLock_t rtcLock;
 extern DateTime globalDateTime;
 
 // Update timing
 #define TIME_UPDATE_INTERVAL 500
+#define TIME_LOCK_TIMEOUT_US 1000
@@ -0,0 +1,89 @@
+#include <unity.h>
+#include <ModbusCRC.h>
+#include <stdlib.h>
+
+// Modbus CRC-16: the three implementations and the incremental API against known vectors
+
+// Read 10 holding registers from slave 1, sent on the wire as ... C5 CD
+static const uint8_t readHolding[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+static const uint8_t checkString[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_known_vectors(void) {
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, modbusCRCBitwise(MODBUS_CRC_INIT, readHolding, sizeof(readHolding)));
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, modbusCRCNibble(MODBUS_CRC_INIT, readHolding, sizeof(readHolding)));
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, modbusCRCTable(MODBUS_CRC_INIT, readHolding, sizeof(readHolding)));
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, modbusCRC(readHolding, sizeof(readHolding)));
+
+    // CRC-16/MODBUS check value
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, modbusCRCBitwise(MODBUS_CRC_INIT, checkString, sizeof(checkString)));
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, modbusCRCNibble(MODBUS_CRC_INIT, checkString, sizeof(checkString)));
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, modbusCRCTable(MODBUS_CRC_INIT, checkString, sizeof(checkString)));
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, modbusCRC(checkString, sizeof(checkString)));
+}
+
+static void test_empty_buffer(void) {
+    TEST_ASSERT_EQUAL_HEX16(MODBUS_CRC_INIT, modbusCRCBitwise(MODBUS_CRC_INIT, nullptr, 0));
+    TEST_ASSERT_EQUAL_HEX16(MODBUS_CRC_INIT, modbusCRCNibble(MODBUS_CRC_INIT, nullptr, 0));
+    TEST_ASSERT_EQUAL_HEX16(MODBUS_CRC_INIT, modbusCRCTable(MODBUS_CRC_INIT, nullptr, 0));
+}
+
+static void test_implementations_agree(void) {
+    uint8_t data[256];
+    srand(1);
+    for (size_t length = 1; length <= sizeof(data); length += 17) {
+        for (size_t i = 0; i < length; i++) data[i] = rand() & 0xFF;
+        uint16_t crc = modbusCRCBitwise(MODBUS_CRC_INIT, data, length);
+        TEST_ASSERT_EQUAL_HEX16(crc, modbusCRCNibble(MODBUS_CRC_INIT, data, length));
+        TEST_ASSERT_EQUAL_HEX16(crc, modbusCRCTable(MODBUS_CRC_INIT, data, length));
+    }
+}
+
+static void test_incremental_bytes(void) {
+    uint16_t crc = MODBUS_CRC_INIT;
+    for (size_t i = 0; i < sizeof(readHolding); i++) crc = modbusCRCUpdate(crc, readHolding[i]);
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, crc);
+}
+
+// The explicit implementations continue from a running CRC, so a frame can be folded in parts
+static void test_incremental_blocks(void) {
+    for (size_t split = 0; split <= sizeof(checkString); split++) {
+        uint16_t crc = modbusCRCUpdate((uint16_t)MODBUS_CRC_INIT, checkString, split);
+        crc = modbusCRCUpdate(crc, &checkString[split], sizeof(checkString) - split);
+        TEST_ASSERT_EQUAL_HEX16(0x4B37, crc);
+
+        crc = modbusCRCBitwise(MODBUS_CRC_INIT, checkString, split);
+        TEST_ASSERT_EQUAL_HEX16(0x4B37, modbusCRCNibble(crc, &checkString[split], sizeof(checkString) - split));
+    }
+}
+
+// A frame followed by its own CRC (low byte first) leaves a residue of 0
+static void test_frame_residue(void) {
+    uint8_t frame[sizeof(readHolding) + 2];
+    memcpy(frame, readHolding, sizeof(readHolding));
+    frame[6] = 0xC5;
+    frame[7] = 0xCD;
+
+    uint16_t crc = MODBUS_CRC_INIT;
+    for (size_t i = 0; i < sizeof(frame); i++) crc = modbusCRCUpdate(crc, frame[i]);
+    TEST_ASSERT_EQUAL_HEX16(0, crc);
+    TEST_ASSERT_EQUAL_HEX16(0, modbusCRC(frame, sizeof(frame)));
+
+    frame[3] ^= 0x01;
+    TEST_ASSERT_TRUE(modbusCRC(frame, sizeof(frame)) != 0);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_known_vectors);
+    RUN_TEST(test_empty_buffer);
+    RUN_TEST(test_implementations_agree);
+    RUN_TEST(test_incremental_bytes);
+    RUN_TEST(test_incremental_blocks);
+    RUN_TEST(test_frame_residue);
+    return UNITY_END();
+}
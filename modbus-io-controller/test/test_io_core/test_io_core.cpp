@@ -0,0 +1,244 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "native_host.h"
+#include "io_core/io_core.h"
+#include "io_core/board_config.h"
+
+#include <atomic>
+#include <thread>
+
+// Poll scheduler queue and catch-up rule, published thermocouple snapshots and Modbus TCP unit ID
+// routing
+
+void setUp(void) {
+    memset(boardConfigs, 0, sizeof(boardConfigs));
+    boardCount = 0;
+    modbusConfig[0].pollQueueSize = 0;
+    for (uint8_t i = 0; i < 16; i++) thermocoupleIO_index.tcIO[i].publishedSeq = 0;
+    thermocoupleIO_index.tcIO[0].published = thermocoupleSnapshot_t();
+}
+
+void tearDown(void) {}
+
+// Poll queue --------------------------------------------------------------->
+static void test_poll_queue_pops_in_deadline_order(void) {
+    modbusConfig_t *busCfg = &modbusConfig[0];
+    srand(2);
+    for (uint8_t slot = 0; slot < 64; slot++) poll_queue_push(busCfg, slot, 1000 + (rand() % 50) * 100);
+    TEST_ASSERT_EQUAL_UINT8(64, busCfg->pollQueueSize);
+
+    uint64_t last = 0;
+    bool popped[64] = {};
+    for (uint8_t i = 0; i < 64; i++) {
+        pollEntry_t entry = poll_queue_pop(busCfg);
+        TEST_ASSERT_TRUE(entry.due >= last);
+        TEST_ASSERT_FALSE(popped[entry.slot]);
+        popped[entry.slot] = true;
+        last = entry.due;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, busCfg->pollQueueSize);
+}
+
+static void test_poll_queue_interleaved(void) {
+    modbusConfig_t *busCfg = &modbusConfig[0];
+    poll_queue_push(busCfg, 1, 300);
+    poll_queue_push(busCfg, 2, 100);
+    poll_queue_push(busCfg, 3, 200);
+    TEST_ASSERT_EQUAL_UINT8(2, poll_queue_pop(busCfg).slot);
+
+    // A requeued device goes behind the ones already due before it
+    poll_queue_push(busCfg, 2, 250);
+    TEST_ASSERT_EQUAL_UINT8(3, poll_queue_pop(busCfg).slot);
+    TEST_ASSERT_EQUAL_UINT8(2, poll_queue_pop(busCfg).slot);
+    pollEntry_t entry = poll_queue_pop(busCfg);
+    TEST_ASSERT_EQUAL_UINT8(1, entry.slot);
+    TEST_ASSERT_EQUAL_UINT64(300, entry.due);
+}
+
+static void test_poll_queue_full(void) {
+    modbusConfig_t *busCfg = &modbusConfig[0];
+    for (uint8_t slot = 0; slot < 64; slot++) poll_queue_push(busCfg, slot, 1000 + slot);
+    poll_queue_push(busCfg, 64, 0);
+    TEST_ASSERT_EQUAL_UINT8(64, busCfg->pollQueueSize);
+    TEST_ASSERT_EQUAL_UINT8(0, poll_queue_pop(busCfg).slot);
+}
+
+// Catch-up rule ------------------------------------------------------------>
+static void test_poll_on_time(void) {
+    uint32_t missed = 99;
+    TEST_ASSERT_EQUAL_UINT64(11000, poll_next_due(1000, 1000, 10000, &missed));
+    TEST_ASSERT_EQUAL_UINT32(0, missed);
+
+    // Late by less than a period, the phase is kept
+    TEST_ASSERT_EQUAL_UINT64(11000, poll_next_due(1000, 10999, 10000, &missed));
+    TEST_ASSERT_EQUAL_UINT32(0, missed);
+}
+
+static void test_poll_missed_periods_are_skipped(void) {
+    uint32_t missed = 0;
+    TEST_ASSERT_EQUAL_UINT64(31000, poll_next_due(1000, 26000, 10000, &missed));
+    TEST_ASSERT_EQUAL_UINT32(2, missed);
+
+    // Exactly one period late, the next deadline is one period ahead of now
+    TEST_ASSERT_EQUAL_UINT64(21000, poll_next_due(1000, 11000, 10000, &missed));
+    TEST_ASSERT_EQUAL_UINT32(1, missed);
+}
+
+// Published snapshots ------------------------------------------------------>
+static void test_snapshot_not_published(void) {
+    thermocoupleSnapshot_t snapshot;
+    uint32_t bits;
+    TEST_ASSERT_FALSE(thermocouple_read_snapshot(0, &snapshot));
+    TEST_ASSERT_FALSE(thermocouple_read_image(0, 0, sizeof(bits), &bits));
+    TEST_ASSERT_FALSE(thermocouple_read_snapshot(16, &snapshot));
+}
+
+static void test_snapshot_and_image(void) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[0];
+    memset(&tc->reg, 0, sizeof(tc->reg));
+    tc->reg.alertEnable[1] = true;
+    tc->reg.alarmState[0] = true;
+    tc->reg.temperature[0] = 25.5f;     // 0x41CC0000
+    tc->reg.alertSP[0] = 123.5f;        // 0x42F70000
+    tc->reg.slaveID = 7;
+    nativeSetMicros(5000000);
+    thermocouple_publish(0);
+
+    thermocoupleSnapshot_t snapshot;
+    TEST_ASSERT_TRUE(thermocouple_read_snapshot(0, &snapshot));
+    TEST_ASSERT_EQUAL_UINT64(5000000, snapshot.timestamp);
+    TEST_ASSERT_EQUAL_MEMORY(&tc->reg, &snapshot.reg, sizeof(tc->reg));
+
+    uint32_t bits;
+    TEST_ASSERT_TRUE(thermocouple_read_image(0, offsetof(thermocoupleImage_t, coils), sizeof(bits), &bits));
+    TEST_ASSERT_EQUAL_HEX32(0x00000002, bits);
+    TEST_ASSERT_TRUE(thermocouple_read_image(0, offsetof(thermocoupleImage_t, discreteInputs), sizeof(bits), &bits));
+    TEST_ASSERT_EQUAL_HEX32(0x00000100, bits);
+
+    uint8_t registers[4];
+    const uint8_t temperature[] = {0x41, 0xCC, 0x00, 0x00};
+    TEST_ASSERT_TRUE(thermocouple_read_image(0, offsetof(thermocoupleImage_t, inputRegisters), 4, registers));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(temperature, registers, 4);
+    const uint8_t setpoint[] = {0x42, 0xF7, 0x00, 0x00};
+    TEST_ASSERT_TRUE(thermocouple_read_image(0, offsetof(thermocoupleImage_t, holdingRegisters) + TCIO_HOLDING_REG_ALERT_SP * 2, 4, registers));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(setpoint, registers, 4);
+
+    // Past the end of the image
+    TEST_ASSERT_FALSE(thermocouple_read_image(0, sizeof(thermocoupleImage_t) - 2, 4, registers));
+}
+
+// A reader on another thread never sees a copy mixing two publications
+static void test_snapshot_is_consistent(void) {
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[0];
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= 200000; i++) {
+            for (uint8_t ch = 0; ch < 8; ch++) {
+                tc->reg.temperature[ch] = (float)i;
+                tc->reg.coldJunction[ch] = (float)i;
+            }
+            thermocouple_publish(0);
+        }
+        done = true;
+    });
+
+    uint32_t torn = 0;
+    uint32_t reads = 0;
+    while (!done) {
+        thermocoupleSnapshot_t snapshot;
+        if (!thermocouple_read_snapshot(0, &snapshot)) continue;
+        for (uint8_t ch = 1; ch < 8; ch++) {
+            if (snapshot.reg.temperature[ch] != snapshot.reg.temperature[0] ||
+                snapshot.reg.coldJunction[ch] != snapshot.reg.temperature[0]) torn++;
+        }
+        uint8_t image[TCIO_INPUT_REG_COUNT * 2];
+        thermocouple_read_image(0, offsetof(thermocoupleImage_t, inputRegisters), sizeof(image), image);
+        for (uint8_t ch = 1; ch < 16; ch++) {
+            if (memcmp(&image[ch * 4], image, 4) != 0) torn++;
+        }
+        reads++;
+    }
+    writer.join();
+    TEST_ASSERT_TRUE(reads > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+}
+
+// Modbus TCP unit ID routes ------------------------------------------------>
+static void addBoard(uint8_t index, uint8_t port, uint8_t slaveID, uint8_t tcpUnitId) {
+    BoardConfig *board = &boardConfigs[boardCount++];
+    snprintf(board->boardName, sizeof(board->boardName), "Board %d", index);
+    board->type = THERMOCOUPLE_IO;
+    board->boardIndex = index;
+    board->modbusPort = port;
+    board->slaveID = slaveID;
+    board->tcpUnitId = tcpUnitId;
+    board->initialised = true;
+}
+
+static void test_routes_duplicate_slave_id(void) {
+    addBoard(0, 0, 1, 0);
+    addBoard(1, 1, 1, 0);
+    addBoard(2, 1, 2, 0);
+    build_tcp_unit_routes();
+
+    // The first board with slave ID 1 gets unit ID 1, the one on the other port is left unrouted
+    tcpUnitRoute_t route;
+    TEST_ASSERT_TRUE(tcp_unit_route(1, &route));
+    TEST_ASSERT_EQUAL_UINT8(0, route.board);
+    TEST_ASSERT_EQUAL_UINT8(0, route.port);
+    TEST_ASSERT_EQUAL_UINT8(1, route.slaveID);
+    TEST_ASSERT_TRUE(tcp_unit_route(2, &route));
+    TEST_ASSERT_EQUAL_UINT8(2, route.board);
+    TEST_ASSERT_EQUAL_UINT8(1, route.port);
+    TEST_ASSERT_FALSE(tcp_unit_route(3, &route));
+}
+
+static void test_routes_configured_unit_id(void) {
+    addBoard(0, 0, 1, 0);
+    addBoard(1, 1, 1, 10);
+    build_tcp_unit_routes();
+
+    tcpUnitRoute_t route;
+    TEST_ASSERT_TRUE(tcp_unit_route(1, &route));
+    TEST_ASSERT_EQUAL_UINT8(0, route.board);
+    TEST_ASSERT_TRUE(tcp_unit_route(10, &route));
+    TEST_ASSERT_EQUAL_UINT8(1, route.board);
+    TEST_ASSERT_EQUAL_UINT8(1, route.port);
+    TEST_ASSERT_EQUAL_UINT8(1, route.slaveID);
+}
+
+// Configured unit IDs are claimed before slave IDs, whatever the board order
+static void test_routes_configured_first(void) {
+    addBoard(0, 0, 1, 0);
+    addBoard(1, 1, 5, 1);
+    addBoard(2, 1, 6, 0);
+    boardConfigs[2].initialised = false;
+    build_tcp_unit_routes();
+
+    tcpUnitRoute_t route;
+    TEST_ASSERT_TRUE(tcp_unit_route(1, &route));
+    TEST_ASSERT_EQUAL_UINT8(1, route.board);
+    TEST_ASSERT_EQUAL_UINT8(5, route.slaveID);
+    TEST_ASSERT_FALSE(tcp_unit_route(5, &route));
+    TEST_ASSERT_FALSE(tcp_unit_route(6, &route));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    nativeMuteConsole(true);
+    nativeUseVirtualClock(true);
+    UNITY_BEGIN();
+    RUN_TEST(test_poll_queue_pops_in_deadline_order);
+    RUN_TEST(test_poll_queue_interleaved);
+    RUN_TEST(test_poll_queue_full);
+    RUN_TEST(test_poll_on_time);
+    RUN_TEST(test_poll_missed_periods_are_skipped);
+    RUN_TEST(test_snapshot_not_published);
+    RUN_TEST(test_snapshot_and_image);
+    RUN_TEST(test_snapshot_is_consistent);
+    RUN_TEST(test_routes_duplicate_slave_id);
+    RUN_TEST(test_routes_configured_unit_id);
+    RUN_TEST(test_routes_configured_first);
+    return UNITY_END();
+}
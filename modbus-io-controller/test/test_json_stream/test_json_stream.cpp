@@ -0,0 +1,158 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "native_host.h"
+#include "utils/jsonStream.h"
+
+#include <string>
+
+// Streaming JSON writer, served through a loopback web server so the chunked body is checked as a
+// browser receives it
+
+#define TEST_WEB_PORT 2090      // Before the native port offset
+
+static WebServer web(TEST_WEB_PORT);
+static void (*writeBody)(JsonStream &json);
+static size_t bodySize;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Fetch /json with writeBody() as its handler, returns the body with the chunk framing removed
+static std::string fetch(void (*body)(JsonStream &json)) {
+    writeBody = body;
+    WiFiClient client;
+    if (!client.connect("127.0.0.1", TEST_WEB_PORT + nativePortOffset())) return "<no connection>";
+    const char request[] = "GET /json HTTP/1.1\r\nHost: test\r\n\r\n";
+    client.write((const uint8_t *)request, sizeof(request) - 1);
+
+    std::string response;
+    uint32_t start = millis();
+    while (client.connected() && millis() - start < 2000) {
+        web.handleClient();
+        uint8_t rx[1024];
+        int count = client.read(rx, sizeof(rx));
+        if (count > 0) response.append((const char *)rx, count);
+    }
+    client.stop();
+
+    size_t position = response.find("\r\n\r\n");
+    if (position == std::string::npos) return "<no body>";
+    position += 4;
+    std::string decoded;
+    while (position < response.size()) {
+        size_t lineEnd = response.find("\r\n", position);
+        if (lineEnd == std::string::npos) break;
+        size_t size = strtoul(response.substr(position, lineEnd - position).c_str(), nullptr, 16);
+        if (size == 0) break;
+        decoded.append(response, lineEnd + 2, size);
+        position = lineEnd + 2 + size + 2;
+    }
+    return decoded;
+}
+
+static void escapedBody(JsonStream &json) {
+    json.beginObject();
+    json.add("quote", "say \"hi\"");
+    json.add("path", "C:\\logs\\");
+    json.add("control", "a\nb\tc\r\b\f\x01\x1f");
+    json.add("utf8", "25 \xC2\xB0" "C");
+    json.add("file", "/logs/", "a\"b.csv");
+    json.add("key \"1\"", true);
+    json.endObject();
+}
+
+static void test_escaping(void) {
+    TEST_ASSERT_EQUAL_STRING("{\"quote\":\"say \\\"hi\\\"\",\"path\":\"C:\\\\logs\\\\\","
+                             "\"control\":\"a\\nb\\tc\\r\\b\\f\\u0001\\u001f\",\"utf8\":\"25 \xC2\xB0" "C\","
+                             "\"file\":\"/logs/a\\\"b.csv\",\"key \\\"1\\\"\":true}",
+                             fetch(escapedBody).c_str());
+}
+
+static void commaBody(JsonStream &json) {
+    json.beginObject();
+    json.add("a", 1);
+    json.beginArray("list");
+    json.add(nullptr, 1);
+    json.add(nullptr, -2L);
+    json.add(nullptr, (const char *)nullptr);
+    json.beginObject();
+    json.endObject();
+    json.beginArray();
+    json.endArray();
+    json.endArray();
+    json.beginObject("empty");
+    json.endObject();
+    json.key("raw");
+    json.print("[1,2]");
+    json.add("nan", NAN);
+    json.add("b", false);
+    json.endObject();
+}
+
+static void test_commas(void) {
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"list\":[1,-2,null,{},[]],\"empty\":{},\"raw\":[1,2],\"nan\":null,\"b\":false}",
+                             fetch(commaBody).c_str());
+}
+
+// Containers past JSON_STREAM_MAX_DEPTH are written as null and their content is dropped, the
+// levels below carry on with their commas
+static void depthBody(JsonStream &json) {
+    json.beginObject();
+    json.add("before", 1);
+    json.beginArray("deep");
+    for (uint8_t i = 1; i < JSON_STREAM_MAX_DEPTH + 2; i++) json.beginArray();
+    json.add(nullptr, 1);
+    json.beginObject();
+    json.add("dropped", "x");
+    json.endObject();
+    for (uint8_t i = 1; i < JSON_STREAM_MAX_DEPTH + 2; i++) json.endArray();
+    json.add(nullptr, 2);
+    json.endArray();
+    json.add("after", 3);
+    json.endObject();
+}
+
+static void test_depth_overflow(void) {
+    std::string expected = "{\"before\":1,\"deep\":";
+    for (uint8_t i = 1; i < JSON_STREAM_MAX_DEPTH; i++) expected += "[";
+    expected += "null";
+    for (uint8_t i = 2; i < JSON_STREAM_MAX_DEPTH; i++) expected += "]";
+    expected += ",2],\"after\":3}";
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), fetch(depthBody).c_str());
+}
+
+// Several buffers' worth, sent as more than one chunk
+static void largeBody(JsonStream &json) {
+    json.beginArray();
+    for (int i = 0; i < 1000; i++) json.add(nullptr, i);
+    json.endArray();
+}
+
+static void test_chunks(void) {
+    std::string expected = "[";
+    for (int i = 0; i < 1000; i++) expected += (i ? "," : "") + std::to_string(i);
+    expected += "]";
+    std::string body = fetch(largeBody);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), body.c_str());
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), bodySize);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    nativeMuteConsole(true);
+    web.on("/json", []() {
+        JsonStream json(web);
+        json.begin();
+        writeBody(json);
+        bodySize = json.end();
+    });
+    web.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_escaping);
+    RUN_TEST(test_commas);
+    RUN_TEST(test_depth_overflow);
+    RUN_TEST(test_chunks);
+    return UNITY_END();
+}
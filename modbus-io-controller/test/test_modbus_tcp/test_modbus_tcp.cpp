@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "native_host.h"
+#include "io_core/io_core.h"
+#include "io_core/board_config.h"
+#include "network/modbus_tcp.h"
+
+// Modbus TCP: ADU framing from the receive buffer and FC01-04 reads answered from the published
+// register image
+
+static ModbusClientConnection client;
+
+void setUp(void) {
+    client.rxHead = 0;
+    client.rxCount = 0;
+}
+
+void tearDown(void) {}
+
+// Append bytes to the client's receive buffer as receiveClientData() does
+static void receive(const uint8_t *data, uint16_t length) {
+    const uint16_t mask = MODBUS_TCP_RX_BUFFER_SIZE - 1;
+    for (uint16_t i = 0; i < length; i++) {
+        client.rxBuffer[(client.rxHead + client.rxCount) & mask] = data[i];
+        client.rxCount++;
+    }
+}
+
+// Read 10 holding registers from unit 1, transaction ID tid
+static void readRequest(uint8_t *adu, uint8_t tid) {
+    const uint8_t request[] = {0x00, tid, 0x00, 0x00, 0x00, 0x06, 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+    memcpy(adu, request, sizeof(request));
+}
+
+// Framing ------------------------------------------------------------------>
+static void test_split_adu(void) {
+    uint8_t request[12];
+    uint8_t adu[MODBUS_TCP_MAX_ADU_SIZE];
+    readRequest(request, 1);
+
+    // Not even the MBAP header
+    receive(request, 5);
+    TEST_ASSERT_EQUAL_INT(0, ModbusTCPServer::takeRequest(client, adu));
+    // Header but not the whole PDU
+    receive(&request[5], 4);
+    TEST_ASSERT_EQUAL_INT(0, ModbusTCPServer::takeRequest(client, adu));
+    TEST_ASSERT_EQUAL_UINT16(9, client.rxCount);
+
+    receive(&request[9], 3);
+    TEST_ASSERT_EQUAL_INT(12, ModbusTCPServer::takeRequest(client, adu));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(request, adu, 12);
+    TEST_ASSERT_EQUAL_UINT16(0, client.rxCount);
+}
+
+static void test_pipelined_adus(void) {
+    uint8_t requests[36];
+    uint8_t adu[MODBUS_TCP_MAX_ADU_SIZE];
+    for (uint8_t i = 0; i < 3; i++) readRequest(&requests[i * 12], i + 1);
+    receive(requests, 30);
+
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT(12, ModbusTCPServer::takeRequest(client, adu));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(&requests[i * 12], adu, 12);
+    }
+    TEST_ASSERT_EQUAL_INT(0, ModbusTCPServer::takeRequest(client, adu));
+    receive(&requests[30], 6);
+    TEST_ASSERT_EQUAL_INT(12, ModbusTCPServer::takeRequest(client, adu));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&requests[24], adu, 12);
+    TEST_ASSERT_EQUAL_INT(0, ModbusTCPServer::takeRequest(client, adu));
+}
+
+// An ADU running past the end of the ring buffer is copied out in order
+static void test_adu_wraps_buffer(void) {
+    uint8_t request[12];
+    uint8_t adu[MODBUS_TCP_MAX_ADU_SIZE];
+    readRequest(request, 7);
+    client.rxHead = MODBUS_TCP_RX_BUFFER_SIZE - 5;
+    receive(request, sizeof(request));
+
+    TEST_ASSERT_EQUAL_INT(12, ModbusTCPServer::takeRequest(client, adu));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(request, adu, 12);
+    TEST_ASSERT_EQUAL_UINT16(0, client.rxCount);
+}
+
+static void test_bad_length(void) {
+    uint8_t adu[MODBUS_TCP_MAX_ADU_SIZE];
+
+    // Length 1 is the unit ID without a function code
+    const uint8_t tooShort[] = {0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x01};
+    receive(tooShort, sizeof(tooShort));
+    TEST_ASSERT_EQUAL_INT(-1, ModbusTCPServer::takeRequest(client, adu));
+
+    // Longer than a PDU can be, rejected from the header alone
+    setUp();
+    const uint8_t tooLong[] = {0x00, 0x01, 0x00, 0x00, 0x00, 0xFF, 0x01};
+    receive(tooLong, sizeof(tooLong));
+    TEST_ASSERT_EQUAL_INT(-1, ModbusTCPServer::takeRequest(client, adu));
+
+    // The largest valid ADU
+    setUp();
+    uint8_t largest[MODBUS_TCP_MAX_ADU_SIZE] = {0x00, 0x01, 0x00, 0x00, 0x00, MODBUS_TCP_MAX_PDU_SIZE + 1, 0x01};
+    receive(largest, sizeof(largest));
+    TEST_ASSERT_EQUAL_INT(MODBUS_TCP_MAX_ADU_SIZE, ModbusTCPServer::takeRequest(client, adu));
+}
+
+// FC01-04 ------------------------------------------------------------------>
+// Board 0 on port 1 with slave ID 3, routed on unit ID 3
+static void publishBoard(void) {
+    memset(boardConfigs, 0, sizeof(boardConfigs));
+    BoardConfig *board = &boardConfigs[0];
+    strcpy(board->boardName, "TC Board");
+    board->type = THERMOCOUPLE_IO;
+    board->boardIndex = 0;
+    board->modbusPort = 1;
+    board->slaveID = 3;
+    board->initialised = true;
+    boardCount = 1;
+    build_tcp_unit_routes();
+
+    thermocoupleIO_t *tc = &thermocoupleIO_index.tcIO[0];
+    memset(&tc->reg, 0, sizeof(tc->reg));
+    tc->reg.alertEnable[0] = true;
+    tc->reg.alertEnable[3] = true;
+    tc->reg.outputEnable[1] = true;     // Coil 9
+    tc->reg.alarmState[2] = true;       // Discrete input 10
+    tc->reg.shortCircuit[7] = true;     // Discrete input 31
+    tc->reg.status = 0x0102;
+    memcpy(tc->reg.boardName, "TC Board", 9);
+    tc->reg.slaveID = 3;
+    tc->reg.alertSP[1] = 123.5f;        // 0x42F70000
+    tc->reg.temperature[0] = 25.5f;     // 0x41CC0000
+    tc->reg.temperature[1] = -1.0f;     // 0xBF800000
+    tc->configInitialised = true;
+    thermocouple_publish(0);
+}
+
+static void test_read_coils(void) {
+    publishBoard();
+    uint8_t response[256];
+    uint16_t length = 0;
+
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x01, 0, 10, response, length));
+    const uint8_t coils[] = {0x01, 0x02, 0x09, 0x02};
+    TEST_ASSERT_EQUAL_UINT16(sizeof(coils), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(coils, response, sizeof(coils));
+
+    // Offset start, the bits are shifted down to bit 0
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x01, 3, 7, response, length));
+    const uint8_t shifted[] = {0x01, 0x01, 0x41};
+    TEST_ASSERT_EQUAL_UINT16(sizeof(shifted), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(shifted, response, sizeof(shifted));
+
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x01, 30, 3, response, length));
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x01, 0, 0, response, length));
+}
+
+static void test_read_discrete_inputs(void) {
+    publishBoard();
+    uint8_t response[256];
+    uint16_t length = 0;
+
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x02, 0, 32, response, length));
+    const uint8_t inputs[] = {0x02, 0x04, 0x00, 0x04, 0x00, 0x80};
+    TEST_ASSERT_EQUAL_UINT16(sizeof(inputs), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(inputs, response, sizeof(inputs));
+}
+
+static void test_read_holding_registers(void) {
+    publishBoard();
+    uint8_t response[256];
+    uint16_t length = 0;
+
+    // Status, board type and the start of the name in character order
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x03, 0, 4, response, length));
+    const uint8_t header[] = {0x03, 0x08, 0x01, 0x02, 0x00, 0x00, 'T', 'C', ' ', 'B'};
+    TEST_ASSERT_EQUAL_UINT16(sizeof(header), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(header, response, sizeof(header));
+
+    // Slave ID and the second setpoint, high word first
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x03, TCIO_HOLDING_REG_ALERT_SP + 2, 2, response, length));
+    const uint8_t setpoint[] = {0x03, 0x04, 0x42, 0xF7, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(setpoint, response, sizeof(setpoint));
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x03, EXP_HOLDING_REG_SLAVE_ID, 1, response, length));
+    const uint8_t slaveID[] = {0x03, 0x02, 0x00, 0x03};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(slaveID, response, sizeof(slaveID));
+
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x03, 0, TCIO_HOLDING_REG_COUNT, response, length));
+    TEST_ASSERT_EQUAL_UINT16(2 + TCIO_HOLDING_REG_COUNT * 2, length);
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x03, 1, TCIO_HOLDING_REG_COUNT, response, length));
+}
+
+static void test_read_input_registers(void) {
+    publishBoard();
+    uint8_t response[256];
+    uint16_t length = 0;
+
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x04, 0, 4, response, length));
+    const uint8_t temperatures[] = {0x04, 0x08, 0x41, 0xCC, 0x00, 0x00, 0xBF, 0x80, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_UINT16(sizeof(temperatures), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(temperatures, response, sizeof(temperatures));
+
+    // Low word of the second temperature
+    TEST_ASSERT_TRUE(modbusServer.handleReadRequest(3, 0x04, 3, 1, response, length));
+    const uint8_t lowWord[] = {0x04, 0x02, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(lowWord, response, sizeof(lowWord));
+
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x04, TCIO_INPUT_REG_COUNT - 1, 2, response, length));
+}
+
+static void test_read_unrouted(void) {
+    publishBoard();
+    uint8_t response[256];
+    uint16_t length = 0;
+
+    // Unit ID without a board, and a function code that isn't a read
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(4, 0x03, 0, 1, response, length));
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x05, 0, 1, response, length));
+
+    // Routed but not configured yet
+    thermocoupleIO_index.tcIO[0].configInitialised = false;
+    TEST_ASSERT_FALSE(modbusServer.handleReadRequest(3, 0x03, 0, 1, response, length));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    nativeMuteConsole(true);
+    UNITY_BEGIN();
+    RUN_TEST(test_split_adu);
+    RUN_TEST(test_pipelined_adus);
+    RUN_TEST(test_adu_wraps_buffer);
+    RUN_TEST(test_bad_length);
+    RUN_TEST(test_read_coils);
+    RUN_TEST(test_read_discrete_inputs);
+    RUN_TEST(test_read_holding_registers);
+    RUN_TEST(test_read_input_registers);
+    RUN_TEST(test_read_unrouted);
+    return UNITY_END();
+}
@@ -277,6 +277,9 @@ document.addEventListener('DOMContentLoaded', () => {
     
     // Load board configurations on page load
     loadBoardConfigurations();    
+    
+    // Board status views follow the live event stream, polling takes over while it is down
+    startLiveEvents();
     loadInitialSettings();  // Load initial NTP and timezone settings
     loadNetworkSettings();  // Load initial network settings
     updateLiveClock();
@@ -1295,10 +1298,10 @@ async function saveBoardConfiguration() {
     let validationErrorMessage = '';
 
     // Validate poll time
-    const pollTime = parseInt(document.getElementById('pollTime').value);
-    if (isNaN(pollTime) || pollTime < 1 || pollTime > 3600) {
+    const pollTime = parseFloat(document.getElementById('pollTime').value);
+    if (isNaN(pollTime) || pollTime < 0.02 || pollTime > 3600) {
         typeSpecificValidationPassed = false;
-        validationErrorMessage = 'Poll time must be between 1 second and 1 hour';
+        validationErrorMessage = 'Poll time must be between 0.02 seconds and 1 hour';
     }
 
     // Validate record interval
@@ -1345,7 +1348,7 @@ async function saveBoardConfiguration() {
             name: boardName,
             type: getBoardTypeValue(boardType), // Convert string type to enum value
             modbus_port: parseInt(modbusPort),
-            poll_time: parseInt(document.getElementById('pollTime').value) * 1000,
+            poll_time: Math.round(parseFloat(document.getElementById('pollTime').value) * 1000),
             record_interval: parseInt(document.getElementById('recordInterval').value) * 1000
         };
         
@@ -1528,6 +1531,7 @@ function renderSingleBoard(board, index, container) {
 }
 
 function updateBoardsListStatus() {
+    if (liveEventsOpen()) return;
     if (document.getElementById('board-config').classList.contains('active')) {
         loadBoardsListStatus();
     }
@@ -1551,32 +1555,36 @@ async function loadBoardsListStatus() {
         const boards = await response.json();
         console.log('Board connection status data:', boards);
         
-        // Update connection and initialisation status
-        const connectStatus = boards.map(board => board.connected);
-        const initStatus = boards.map(board => board.initialised);
-        
-        // Update connection and initialisation status for each board
-        for (let i = 0; i < boardConfigurations.length; i++) {
-            const initStatusElement = document.getElementById(`init-status-${i}`);
-            if (initStatusElement) {
-                const isInitialised = initStatus[i];
-                initStatusElement.textContent = `Status: ${isInitialised ? 'Initialised' : 'Not Initialised'}`;
-                initStatusElement.className = `board-init-status ${isInitialised ? 'init-status-ok' : 'init-status-pending'}`;
-            }
-
-            const connectStatusElement = document.getElementById(`connect-status-${i}`);
-            if (connectStatusElement) {
-                const isConnected = connectStatus[i];
-                connectStatusElement.textContent = `Connection: ${isConnected ? 'Online' : 'Offline'}`;
-                connectStatusElement.className = `board-connect-status ${isConnected ? 'connect-status-ok' : 'connect-status-error'}`;
-            }
-        }
+        showBoardsListStatus(boards);
     } catch (error) {
         console.error('Error loading board connection status:', error);
         showToast('error', 'Error', 'Failed to load board connection status information');
     }
 }
 
+// Update connection and initialisation status in the boards list, boards are indexed by board id
+function showBoardsListStatus(boards) {
+    const connectStatus = boards.map(board => board && board.connected);
+    const initStatus = boards.map(board => board && board.initialised);
+    
+    // Update connection and initialisation status for each board
+    for (let i = 0; i < boardConfigurations.length; i++) {
+        const initStatusElement = document.getElementById(`init-status-${i}`);
+        if (initStatusElement) {
+            const isInitialised = initStatus[i];
+            initStatusElement.textContent = `Status: ${isInitialised ? 'Initialised' : 'Not Initialised'}`;
+            initStatusElement.className = `board-init-status ${isInitialised ? 'init-status-ok' : 'init-status-pending'}`;
+        }
+
+        const connectStatusElement = document.getElementById(`connect-status-${i}`);
+        if (connectStatusElement) {
+            const isConnected = connectStatus[i];
+            connectStatusElement.textContent = `Connection: ${isConnected ? 'Online' : 'Offline'}`;
+            connectStatusElement.className = `board-connect-status ${isConnected ? 'connect-status-ok' : 'connect-status-error'}`;
+        }
+    }
+}
+
 // Edit board configuration
 function editBoard(index) {
     showBoardConfigForm(index);
@@ -2415,6 +2423,7 @@ async function initialiseBoard(index) {
 // Board Status Page Functionality
 let boardStatusChart = null;
 let selectedBoardId = null;
+let boardStatusData = null;  // Last /api/status/board response for the selected board
 let statusRefreshInterval = null;
 let connectStatusRefreshInterval = null;
 
@@ -2561,98 +2570,105 @@ async function loadBoardStatus(boardId) {
         const board = await response.json();
         console.log('Board status data:', board); // Debug the full API response
         
-        // Update board information with better null/undefined checking
-        document.getElementById('boardInfoName').textContent = board.name || 'Not specified';
-        document.getElementById('boardInfoType').textContent = board.type || 'Unknown type';        
+        boardStatusData = board;
+        showBoardStatus(boardId, board);
+    } catch (error) {
+        console.error('Error loading board status:', error);
+        showToast('error', 'Error', 'Failed to load board status');
+    }
+}
+
+// Show a board status, either as loaded or with the live values merged in
+function showBoardStatus(boardId, board) {
+    // Update board information with better null/undefined checking
+    document.getElementById('boardInfoName').textContent = board.name || 'Not specified';
+    document.getElementById('boardInfoType').textContent = board.type || 'Unknown type';        
+    
+    // Update connection status with color coding
+    const connectionStatusElement = document.getElementById('boardInfoConnectionStatus');
+    connectionStatusElement.textContent = board.connected ? 'Connected' : 'Disconnected';
+    connectionStatusElement.className = board.connected ? 'status-connected' : 'status-disconnected';
+    
+    document.getElementById('boardInfoSlaveId').textContent = board.slave_id || 'N/A';
+    document.getElementById('boardInfoModbusPort').textContent = board.modbus_port !== undefined ? `Port ${board.modbus_port + 1}` : 'N/A';
+    document.getElementById('boardInfoPollTime').textContent = board.poll_time ? `${board.poll_time} ms` : 'N/A';
+    
+    // Grey out board info if disconnected
+    const boardInfoContainer = document.getElementById('boardInfo');
+    if (boardInfoContainer) {
+        boardInfoContainer.className = board.connected ? 'board-info-connected' : 'board-info-disconnected';
+    }
+
+    // Update connection and initialisation status
+    connectStatusGlobal[boardId] = board.connected;
+    initStatusGlobal[boardId] = board.initialised;
+    
+    // Handle board type specific content
+    if (board.type === 'Thermocouple IO') {
+        document.getElementById('thermocoupleContent').style.display = 'block';
+        document.getElementById('thermocoupleOverview').style.display = 'block';
         
-        // Update connection status with color coding
-        const connectionStatusElement = document.getElementById('boardInfoConnectionStatus');
-        connectionStatusElement.textContent = board.connected ? 'Connected' : 'Disconnected';
-        connectionStatusElement.className = board.connected ? 'status-connected' : 'status-disconnected';
+        // Check if thermocouple data exists
+        if (!board.thermocouple) {
+            console.error('Thermocouple data missing from API response');
+            showToast('error', 'Error', 'Failed to load thermocouple data');
+            return;
+        }
         
-        document.getElementById('boardInfoSlaveId').textContent = board.slave_id || 'N/A';
-        document.getElementById('boardInfoModbusPort').textContent = board.modbus_port !== undefined ? `Port ${board.modbus_port + 1}` : 'N/A';
-        document.getElementById('boardInfoPollTime').textContent = board.poll_time ? `${board.poll_time} ms` : 'N/A';
+        // Update error indicators (check if errors object exists)
+        if (board.thermocouple.errors) {
+            updateErrorIndicator('modbusError', board.thermocouple.errors.modbus);
+            updateErrorIndicator('i2cError', board.thermocouple.errors.i2c);
+            updateErrorIndicator('psuError', board.thermocouple.errors.psu);
+        } else {
+            console.warn('Error indicators missing in API response');
+        }
         
-        // Grey out board info if disconnected
-        const boardInfoContainer = document.getElementById('boardInfo');
-        if (boardInfoContainer) {
-            boardInfoContainer.className = board.connected ? 'board-info-connected' : 'board-info-disconnected';
+        // Update PSU voltage
+        const psuVoltageElement = document.getElementById('psuVoltage');
+        if (psuVoltageElement) {
+            const voltageText = (board.thermocouple.psu_voltage !== undefined) 
+                ? `${board.thermocouple.psu_voltage.toFixed(2)}V` 
+                : 'N/A';
+            psuVoltageElement.textContent = !board.connected ? `${voltageText} (STALE)` : voltageText;
         }
-
-        // Update connection and initialisation status
-        connectStatusGlobal[boardId] = board.connected;
-        initStatusGlobal[boardId] = board.initialised;
         
-        // Handle board type specific content
-        if (board.type === 'Thermocouple IO') {
-            document.getElementById('thermocoupleContent').style.display = 'block';
-            document.getElementById('thermocoupleOverview').style.display = 'block';
-            
-            // Check if thermocouple data exists
-            if (!board.thermocouple) {
-                console.error('Thermocouple data missing from API response');
-                showToast('error', 'Error', 'Failed to load thermocouple data');
-                return;
-            }
-            
-            // Update error indicators (check if errors object exists)
-            if (board.thermocouple.errors) {
-                updateErrorIndicator('modbusError', board.thermocouple.errors.modbus);
-                updateErrorIndicator('i2cError', board.thermocouple.errors.i2c);
-                updateErrorIndicator('psuError', board.thermocouple.errors.psu);
+        // Apply offline styling to thermocouple overview panel
+        const thermocoupleOverview = document.getElementById('thermocoupleOverview');
+        if (thermocoupleOverview) {
+            if (!board.connected) {
+                thermocoupleOverview.classList.add('board-offline');
+                thermocoupleOverview.title = 'Board is offline - data may be stale';
             } else {
-                console.warn('Error indicators missing in API response');
-            }
-            
-            // Update PSU voltage
-            const psuVoltageElement = document.getElementById('psuVoltage');
-            if (psuVoltageElement) {
-                const voltageText = (board.thermocouple.psu_voltage !== undefined) 
-                    ? `${board.thermocouple.psu_voltage.toFixed(2)}V` 
-                    : 'N/A';
-                psuVoltageElement.textContent = !board.connected ? `${voltageText} (STALE)` : voltageText;
+                thermocoupleOverview.classList.remove('board-offline');
+                thermocoupleOverview.title = '';
             }
+        }
+        
+        // Check if channels exist before updating
+        if (board.thermocouple.channels && Array.isArray(board.thermocouple.channels)) {
+            updateThermocoupleChannels(board.thermocouple.channels, board.connected);
             
-            // Apply offline styling to thermocouple overview panel
-            const thermocoupleOverview = document.getElementById('thermocoupleOverview');
-            if (thermocoupleOverview) {
-                if (!board.connected) {
-                    thermocoupleOverview.classList.add('board-offline');
-                    thermocoupleOverview.title = 'Board is offline - data may be stale';
-                } else {
-                    thermocoupleOverview.classList.remove('board-offline');
-                    thermocoupleOverview.title = '';
-                }
-            }
+            // Update temperature history with current data (pass connection status)
+            updateClientTemperatureHistory(board.thermocouple.channels, board.connected);
             
-            // Check if channels exist before updating
-            if (board.thermocouple.channels && Array.isArray(board.thermocouple.channels)) {
-                updateThermocoupleChannels(board.thermocouple.channels, board.connected);
-                
-                // Update temperature history with current data (pass connection status)
-                updateClientTemperatureHistory(board.thermocouple.channels, board.connected);
-                
-                // Update chart with accumulated temperature data
-                updateTemperatureChart(clientTemperatureHistory);
-            } else {
-                console.error('Thermocouple channel data missing or invalid');
-                document.getElementById('channelCards').innerHTML = 
-                    '<p class="no-boards-message">No thermocouple channel data available</p>';
-            }
+            // Update chart with accumulated temperature data
+            updateTemperatureChart(clientTemperatureHistory);
         } else {
-            // Hide thermocouple content for other board types
-            document.getElementById('thermocoupleContent').style.display = 'none';
-            document.getElementById('thermocoupleOverview').style.display = 'none';
+            console.error('Thermocouple channel data missing or invalid');
+            document.getElementById('channelCards').innerHTML = 
+                '<p class="no-boards-message">No thermocouple channel data available</p>';
         }
-    } catch (error) {
-        console.error('Error loading board status:', error);
-        showToast('error', 'Error', 'Failed to load board status');
+    } else {
+        // Hide thermocouple content for other board types
+        document.getElementById('thermocoupleContent').style.display = 'none';
+        document.getElementById('thermocoupleOverview').style.display = 'none';
     }
 }
 
 // Refresh the current board status
 function refreshBoardStatus() {
+    if (liveEventsOpen()) return;
     if (selectedBoardId && document.getElementById('board-status').classList.contains('active')) {
         loadBoardStatus(selectedBoardId);
     }
@@ -3281,6 +3297,8 @@ document.addEventListener('DOMContentLoaded', function() {
 let dashboardItems = [];
 let dashboardEditMode = false;
 let dashboardRefreshInterval = null;
+let liveEventSource = null;
+let liveBoards = {};
 let dashboardChart = null;
 let dashboardChartVisible = false;
 let dashboardTemperatureHistory = {
@@ -3358,6 +3376,9 @@ async function loadDashboardItems() {
             dashboardRefreshInterval = setInterval(refreshDashboardData, dashboardUpdateInterval);
         }
         
+        // Subscribe to live value changes, polling takes over while the stream is down
+        startLiveEvents();
+        
     } catch (error) {
         console.error('Error loading dashboard items:', error);
         showToast('error', 'Error', 'Failed to load dashboard items');
@@ -3464,42 +3485,131 @@ async function refreshDashboardData() {
     if (dashboardTab && !dashboardTab.classList.contains('active')) return;
     
     try {
-        // Get unique board IDs
-        const boardIds = [...new Set(dashboardItems.map(item => item.board_index))];
-        
-        // Get status for each board
-        for (const boardId of boardIds) {
-            const response = await fetch(`/api/status/board?id=${boardId}`);
+        // The event stream keeps the values current, otherwise one request returns every board
+        if (!liveEventsOpen()) {
+            const response = await fetch('/api/live');
             
             if (!response.ok) {
                 throw new Error(`HTTP error! status: ${response.status}`);
             }
             
-            const board = await response.json();
-            
-            // Check if this is a thermocouple board
-            if (board.type === 'Thermocouple IO') {
-                // Check if thermocouple data exists
-                if (!board.thermocouple || !board.thermocouple.channels) {
-                    console.error('Thermocouple data missing from API response');
-                    continue;
-                }
-                
-                // Update dashboard with channel data and connection status
-                updateDashboardThermocoupleItems(boardId, board.thermocouple.channels, board.connected);
-                
-                // Update dashboard chart temperature history if chart is visible
-                if (dashboardChartVisible) {
-                    updateDashboardTemperatureHistory();
-                }
-            }
-            // Add more board types as needed
+            const live = await response.json();
+            storeLiveBoards(live.boards);
+            showLiveBoards();
+        }
+        
+        // Update dashboard chart temperature history if chart is visible
+        if (dashboardChartVisible) {
+            updateDashboardTemperatureHistory();
         }
     } catch (error) {
         console.error('Error refreshing dashboard data:', error);
     }
 }
 
+// Live events: /api/events sends every board on connect, then only the fields that changed
+function startLiveEvents() {
+    if (liveEventSource || typeof EventSource === 'undefined') return;
+    
+    liveEventSource = new EventSource('/api/events');
+    liveEventSource.addEventListener('live', event => {
+        try {
+            const live = JSON.parse(event.data);
+            storeLiveBoards(live.boards);
+            
+            const dashboardTab = document.getElementById('dashboard');
+            if (dashboardTab && dashboardTab.classList.contains('active')) {
+                showLiveBoards();
+            }
+            showLiveBoardsList();
+            showLiveBoardStatus();
+        } catch (error) {
+            console.error('Error handling live event:', error);
+        }
+    });
+}
+
+function liveEventsOpen() {
+    return liveEventSource !== null && liveEventSource.readyState === EventSource.OPEN;
+}
+
+// Merge live board values (complete or changed fields only) into the latest known values
+function storeLiveBoards(boards) {
+    for (const board of boards) {
+        liveBoards[board.id] = Object.assign(liveBoards[board.id] || {}, board);
+    }
+}
+
+function showLiveBoards() {
+    // Get unique board IDs
+    const boardIds = [...new Set(dashboardItems.map(item => item.board_index))];
+    
+    for (const boardId of boardIds) {
+        const board = liveBoards[boardId];
+        
+        // Only thermocouple boards carry temperatures
+        if (!board || !board.temperature) continue;
+        
+        // Update dashboard with channel data and connection status
+        updateDashboardThermocoupleItems(boardId, liveThermocoupleChannels(board), board.connected);
+    }
+}
+
+// Boards list connection and initialisation status, the list is indexed by board id
+function showLiveBoardsList() {
+    const boardConfigTab = document.getElementById('board-config');
+    if (!boardConfigTab || !boardConfigTab.classList.contains('active')) return;
+    
+    showBoardsListStatus(boardConfigurations.map((config, id) => liveBoards[id]));
+}
+
+// Merge the live values into the selected board's last loaded status, the config fields
+// (setpoints, channel settings) keep the values loaded with it
+function showLiveBoardStatus() {
+    const boardStatusTab = document.getElementById('board-status');
+    if (!boardStatusTab || !boardStatusTab.classList.contains('active')) return;
+    
+    const live = liveBoards[selectedBoardId];
+    if (!live || !boardStatusData || boardStatusData.id != selectedBoardId) return;
+    
+    boardStatusData.connected = live.connected;
+    boardStatusData.initialised = live.initialised;
+    
+    const thermocouple = boardStatusData.thermocouple;
+    if (thermocouple && live.temperature) {
+        thermocouple.data_age_ms = live.data_age_ms;
+        thermocouple.psu_voltage = live.psu_voltage;
+        thermocouple.errors = {
+            modbus: (live.errors & 1) !== 0,
+            i2c: (live.errors & 2) !== 0,
+            psu: (live.errors & 4) !== 0
+        };
+        liveThermocoupleChannels(live).forEach((values, ch) => {
+            const channel = thermocouple.channels && thermocouple.channels.find(c => c && c.number === ch);
+            if (!channel) return;
+            channel.temperature = values.temperature;
+            channel.cold_junction = values.cold_junction;
+            Object.assign(channel.status || (channel.status = {}), values.status);
+        });
+    }
+    
+    showBoardStatus(selectedBoardId, boardStatusData);
+}
+
+// Expand a board from /api/live (flags are channel bit masks) into per-channel objects
+function liveThermocoupleChannels(board) {
+    return board.temperature.map((temperature, ch) => ({
+        temperature: temperature === null ? undefined : temperature,
+        cold_junction: board.cold_junction[ch] === null ? undefined : board.cold_junction[ch],
+        status: {
+            output_state: (board.output >> ch & 1) === 1,
+            alarm_state: (board.alarm >> ch & 1) === 1,
+            open_circuit: (board.open_circuit >> ch & 1) === 1,
+            short_circuit: (board.short_circuit >> ch & 1) === 1
+        }
+    }));
+}
+
 // Update thermocouple items on the dashboard
 function updateDashboardThermocoupleItems(boardId, channels, isConnected = true) {
     const items = dashboardItems.filter(item => item.board_index == boardId);
@@ -88,7 +88,7 @@ void setupModbus() {
   bus.configureCoils(coil, 40);
   bus.configureDiscreteInputs(inputDiscrete, 32);
   bus.configureHoldingRegisters(holdingReg, 42);
-  bus.configureInputRegisters(inputReg, 48);
+  bus.configureInputRegisters(inputReg, 100);
   if (modbusInitialised) {
     bus.begin(modbusHolding.slaveID, 500000);
     commLedColour = LED_OK;
@@ -157,6 +157,17 @@ void readAll() {
   // Copy data to modbus registers (read only)
   memcpy(inputDiscrete, &modbusFlag, sizeof(modbusFlag)); // Copy the modbusFlag struct to the inputDiscrete array
   memcpy(inputReg, &modbusInput, sizeof(modbusInput)); // Copy the modbusInput struct to the inputReg array
+
+  // Update snapshot block so the controller can poll everything with a single FC04 read
+  modbusSnapshot.status = holdingReg[0];
+  modbusSnapshot.boardType = modbusHolding.boardType;
+  modbusSnapshot.flags[0] = 0;
+  modbusSnapshot.flags[1] = 0;
+  for (int i = 0; i < 32; i++) {
+    if (inputDiscrete[i]) modbusSnapshot.flags[i >> 4] |= (1u << (i & 15));
+  }
+  modbusSnapshot.input = modbusInput;
+  memcpy(&inputReg[SNAPSHOT_INPUT_REG_PTR], &modbusSnapshot, sizeof(modbusSnapshot));
 }
 
 void setupLEDs() {
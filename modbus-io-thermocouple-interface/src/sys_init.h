@@ -121,11 +121,19 @@ struct modbus_input_t {     // FC04
     float deltaJunction[8]; // 32-47
 } modbusInput;
 
+struct modbus_snapshot_t {  // FC04 snapshot block, everything the controller polls in one read
+    uint16_t status;        // 48     Copy of holding register 0
+    uint16_t boardType;     // 49     Copy of holding register 1
+    uint16_t flags[2];      // 50-51  Discrete inputs 0-31 packed LSB first
+    modbus_input_t input;   // 52-99  Copy of input registers 0-47
+} modbusSnapshot;
+
 // Modbus register arrays
 bool coil[40];
 #define LATCH_RESET_PTR 32
 bool inputDiscrete[32];
-uint16_t inputReg[48];
+uint16_t inputReg[100];
+#define SNAPSHOT_INPUT_REG_PTR 48
 uint16_t holdingReg[42];
 
 int enablePin[8] = {
@@ -276,7 +276,7 @@ bool ModbusRTUSlave::_readRequest() {
     }
   } while (micros() - startTime <= _charTimeout && numBytes < MODBUS_RTU_SLAVE_BUF_SIZE);
   while (micros() - startTime < _frameTimeout);
-  if (!_serial->available() && (_buf[0] == _id || _buf[0] == 0) && _crc(numBytes - 2) == _bytesToWord(_buf[numBytes - 1], _buf[numBytes - 2])) {
+  if (!_serial->available() && numBytes >= 4 && (_buf[0] == _id || _buf[0] == 0) && modbusCRC(_buf, numBytes - 2) == _bytesToWord(_buf[numBytes - 1], _buf[numBytes - 2])) {
     Serial.printf("ModbusRTUSlave: Received %d bytes: ", numBytes);
     for (uint8_t i = 0; i < numBytes; i++) {
       Serial.printf("%02X ", _buf[i]);
@@ -289,7 +289,7 @@ bool ModbusRTUSlave::_readRequest() {
 
 void ModbusRTUSlave::_writeResponse(uint8_t len) {
   if (_buf[0] != 0) {
-    uint16_t crc = _crc(len);
+    uint16_t crc = modbusCRC(_buf, len);
     _buf[len] = lowByte(crc);
     _buf[len + 1] = highByte(crc);
     if (_dePin != NO_DE_PIN) digitalWrite(_dePin, HIGH);
@@ -326,19 +326,6 @@ void ModbusRTUSlave::_calculateTimeouts(uint32_t baud, uint8_t config) {
   }
 }
 
-uint16_t ModbusRTUSlave::_crc(uint8_t len) {
-  uint16_t value = 0xFFFF;
-  for (uint8_t i = 0; i < len; i++) {
-    value ^= (uint16_t)_buf[i];
-    for (uint8_t j = 0; j < 8; j++) {
-      bool lsb = value & 1;
-      value >>= 1;
-      if (lsb) value ^= 0xA001;
-    }
-  }
-  return value;
-}
-
 uint16_t ModbusRTUSlave::_div8RndUp(uint16_t value) {
   return (value + 7) >> 3;
 }
@@ -15,6 +15,7 @@
 #define MODBUS_FC16_WRITE_MULTIPLE_REGISTERS  0x10
 
 #include "Arduino.h"
+#include "ModbusCRC.h"
 #ifdef __AVR__
 #include <SoftwareSerial.h>
 #endif
@@ -74,7 +75,6 @@ class ModbusRTUSlave {
     void _exceptionResponse(uint8_t code);
 
     void _calculateTimeouts(uint32_t baud, uint8_t config);
-    uint16_t _crc(uint8_t len);
     uint16_t _div8RndUp(uint16_t value);
     uint16_t _bytesToWord(uint8_t high, uint8_t low);
 };